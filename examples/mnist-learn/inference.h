@@ -180,14 +180,9 @@ std::vector<knp::core::messaging::SpikeMessage> infer_network(
             return step != dataset.get_steps_amount_for_inference();
         });
 
-    // Retrieve final spike results from output channel.
-    auto spikes = out_channel.update();
-
-    // Sort spikes by send time for consistent ordering.
-    std::sort(
-        spikes.begin(), spikes.end(),
-        [](const auto& sm1, const auto& sm2) { return sm1.header_.send_time_ < sm2.header_.send_time_; });
-    return spikes;
+    // Retrieve final spike results from output channel, the messages are sorted by send time.
+    out_channel.update();
+    return out_channel.read_some_from_buffer(0, model_executor.get_backend()->get_step());
 }
 
 
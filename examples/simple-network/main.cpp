@@ -138,7 +138,8 @@ int main(int argc, const char *const argv[])
     // Creates the results vector that contains the indices of the spike steps.
     std::vector<knp::core::Step> results;
     // Updates the output channel.
-    const auto &spikes = out_channel.update();
+    out_channel.update();
+    const auto spikes = out_channel.read_some_from_buffer(0, model_executor.get_backend()->get_step());
     // Allocates a memory area for spikes.
     results.reserve(spikes.size());
 
@@ -71,8 +71,14 @@ MessageQueue::const_iterator calculate_projection_impl(
             SPDLOG_TRACE("Projection synapse count for the spike = {}", synapses.size());
             for (auto synapse_index : synapses)
             {
-                auto &synapse = projection[synapse_index];
-                training::stdp::init_synapse(std::get<core::synapse_data>(synapse), step_n);
+                // Synapses are read through the constant projection, so that shared synapses are not copied.
+                // Training state of locked projections is not used, so their synapses stay shared.
+                if constexpr (!std::is_same_v<DeltaLikeSynapse, DeltaSynapse>)
+                {
+                    if (!projection.is_locked())
+                        training::stdp::init_synapse(std::get<core::synapse_data>(projection[synapse_index]), step_n);
+                }
+                const auto &synapse = std::as_const(projection)[synapse_index];
                 const auto &synapse_params = std::get<core::synapse_data>(synapse);
 
                 // The message is sent on step N - 1, received on step N.
@@ -124,7 +130,7 @@ void calculate_projection_multithreaded_impl(
     std::vector<std::pair<uint64_t, knp::core::messaging::SynapticImpact>> container;
     for (size_t synapse_index = part_start; synapse_index < part_end; ++synapse_index)
     {
-        auto &synapse = projection[synapse_index];
+        const auto &synapse = std::as_const(projection)[synapse_index];
         // update_step(synapse.params_, step_n);
         auto iter = message_in_data.find(std::get<core::source_neuron_id>(synapse));
         if (iter == message_in_data.end())
@@ -137,7 +143,8 @@ void calculate_projection_multithreaded_impl(
         uint64_t key = std::get<core::synapse_data>(synapse).delay_ + step_n - 1;
         if constexpr (std::is_same_v<DeltaLikeSynapse, STDPDeltaSynapse>)
         {
-            std::get<core::synapse_data>(synapse).rule_.last_spike_step_ = step_n;
+            if (!projection.is_locked())
+                std::get<core::synapse_data>(projection[synapse_index]).rule_.last_spike_step_ = step_n;
         }
 
         knp::core::messaging::SynapticImpact impact{
@@ -24,6 +24,7 @@
 #include <knp/core/messaging/messaging.h>
 #include <knp/core/population.h>
 
+#include <optional>
 #include <vector>
 
 #include "populations.h"
@@ -89,17 +90,18 @@ std::vector<std::reference_wrapper<knp::core::Projection<SynapseType>>> find_pro
  * @tparam Neuron type of neurons stored in the population.
  *
  * @param pop population to update.
- * @param endpoint message endpoint used for loading and sending messages.
+ * @param endpoint message endpoint used for loading messages.
  * @param step_n current execution step number.
  *
- * @return spike message containing the indexes of neurons that emitted a spike during this step.
+ * @return spike message containing the indexes of neurons that emitted a spike during this step or `std::nullopt`
+ * if no neuron spiked.
  *
  * @details The function unloads all synaptic impact messages addressed to the population from 
  * the message endpoint. Then the function calculates pre-impact state 
  * (@ref populations::calculate_pre_impact_population_state), dispatches synaptic impact messages
  * (@ref populations::impact_population), and calculates post-impact state 
- * (@ref populations::calculate_post_impact_population_state). If any spikes were generated, 
- * the functions sends a spike message back through the message endpoint.
+ * (@ref populations::calculate_post_impact_population_state). The function doesn't send the spike message, so that
+ * the caller can send messages of all populations at once.
  */
 template <class Neuron>
 std::optional<core::messaging::SpikeMessage> calculate_any_population(
@@ -112,10 +114,7 @@ std::optional<core::messaging::SpikeMessage> calculate_any_population(
     populations::impact_population(pop, messages);
     populations::calculate_post_impact_population_state(pop, message_out, 0, pop.size());
 
-    if (!message_out.neuron_indexes_.empty())
-    {
-        endpoint.send_message(message_out);
-    }
+    if (message_out.neuron_indexes_.empty()) return std::nullopt;
 
     return message_out;
 }
@@ -127,10 +126,11 @@ std::optional<core::messaging::SpikeMessage> calculate_any_population(
  * @tparam BlifatLikeNeuron type of a neuron that possesses BLIFAT‑like parameters.
  *
  * @param pop population to update.
- * @param endpoint message endpoint used for loading and sending messages.
+ * @param endpoint message endpoint used for loading messages.
  * @param step_n current execution step number.
  *
- * @return spike message containing the indexes of neurons that emitted a spike during this step.
+ * @return spike message containing the indexes of neurons that emitted a spike during this step or `std::nullopt`
+ * if no neuron spiked.
  *
  * @details This function is a thin wrapper around @ref calculate_any_population. It forwards the provided population,
  *  message endpoint, and step number to the generic implementation, thereby reusing the full simulation pipeline.
@@ -150,10 +150,11 @@ std::optional<core::messaging::SpikeMessage> calculate_blifat_population(
  * @tparam LifNeuron LIF neuron type.
  *
  * @param pop population to update.
- * @param endpoint message endpoint used for loading and sending messages.
+ * @param endpoint message endpoint used for loading messages.
  * @param step_n current execution step number.
  *
- * @return spike message containing the indexes of neurons that emitted a spike during this step.
+ * @return spike message containing the indexes of neurons that emitted a spike during this step or `std::nullopt`
+ * if no neuron spiked.
  *
  * @details This function simply forwards the call to @ref calculate_any_population, reusing the 
  * generic simulation pipeline.
@@ -176,10 +177,11 @@ std::optional<knp::core::messaging::SpikeMessage> calculate_lif_population(
  *
  * @param pop population to update.
  * @param container projection container supplied by the backend.
- * @param endpoint message endpoint used for loading and sending messages.
+ * @param endpoint message endpoint used for loading messages.
  * @param step_n current execution step number.
  *
- * @return spike message containing the indexes of neurons that emitted a spike during this step.
+ * @return spike message containing the indexes of neurons that emitted a spike during this step or `std::nullopt`
+ * if no neuron spiked.
  *
  * @details The function unloads all synaptic impact messages addressed to the population from 
  * the message endpoint. Then the function calculates pre-impact state 
@@ -188,8 +190,8 @@ std::optional<knp::core::messaging::SpikeMessage> calculate_lif_population(
  * (@ref populations::calculate_post_impact_population_state). 
  * The function then retrieves projections of the @ref synapse_traits::SynapticResourceSTDPDeltaSynapse type that 
  * target the population, optionally excluding locked ones. 
- * Finally, the function trains the population with the generated spike message and sends the spike 
- * message back through the message endpoint if any neurons spiked.
+ * Finally, the function trains the population with the generated spike message. The function doesn't send the spike
+ * message, so that the caller can send messages of all populations at once.
 
  */
 template <class BlifatLikeNeuron, class BaseSynapseType, class ProjectionContainer>
@@ -208,10 +210,7 @@ std::optional<core::messaging::SpikeMessage> calculate_resource_stdp_population(
         knp::synapse_traits::SynapticResourceSTDPDeltaSynapse, ProjectionContainer>(container, pop.get_uid(), true);
     cpu::populations::train_population(pop, working_projections, message_out, step_n);
 
-    if (!message_out.neuron_indexes_.empty())
-    {
-        endpoint.send_message(message_out);
-    }
+    if (message_out.neuron_indexes_.empty()) return std::nullopt;
 
     return message_out;
 }
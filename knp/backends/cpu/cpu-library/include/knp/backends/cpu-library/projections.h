@@ -27,6 +27,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include <optional>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -45,18 +47,19 @@ namespace knp::backends::cpu::projections
  * @tparam Synapse type of a synapse that possesses Delta‑like parameters.
  *
  * @param projection projection to calculate.
- * @param endpoint message endpoint used for loading and sending messages.
+ * @param endpoint message endpoint used for loading messages.
  * @param future_messages queue that stores messages to be sent in future steps.
  * @param step_n current simulation step number.
  *
+ * @return impact message that should be sent at the current step or `std::nullopt` if there is no such message.
+ *
  * @details First, the function unloads all spike messages addressed to the projection from
  * the message endpoint. Then the function processes the unloaded spike messages together with 
- * any pending @p future_messages and returns an iterator to the first impact message that should be
- *  sent immediately. If such a message exists, the function sends it via the message endpoint
- *  and removes it from @p future_messages.
+ * any pending @p future_messages. If there is an impact message that should be sent immediately, the function
+ * removes it from @p future_messages and returns it, so that the caller can send messages of all projections at once.
  */
 template <typename Synapse>
-void calculate_projection(
+std::optional<core::messaging::SynapticImpactMessage> calculate_projection(
     knp::core::Projection<Synapse> &projection, knp::core::MessageEndpoint &endpoint, MessageQueue &future_messages,
     size_t step_n)
 {
@@ -74,13 +77,13 @@ void calculate_projection(
 #endif
 
     auto out_iter = impl::calculate_projection_dispatch(projection, messages, future_messages, step_n);
-    if (out_iter != future_messages.end())
-    {
-        SPDLOG_TRACE("Projection is sending an impact message.");
-        // Send a message and remove it from the queue.
-        endpoint.send_message(out_iter->second);
-        future_messages.erase(out_iter);
-    }
+    if (out_iter == future_messages.end()) return std::nullopt;
+
+    SPDLOG_TRACE("Projection is sending an impact message.");
+    // Take the message out of the queue.
+    auto message = std::move(out_iter->second);
+    future_messages.erase(out_iter);
+    return message;
 }
 
 
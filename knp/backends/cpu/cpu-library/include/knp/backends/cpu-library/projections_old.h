@@ -24,6 +24,8 @@
 #include <knp/core/messaging/messaging.h>
 #include <knp/core/projection.h>
 
+#include <optional>
+
 #include "projections.h"
 
 
@@ -39,20 +41,22 @@ namespace knp::backends::cpu
  * @tparam DeltaLikeSynapseType type of a synapse that possesses Delta‑like parameters.
  *
  * @param proj projection to calculate.
- * @param endpoint message endpoint used for loading and sending messages.
+ * @param endpoint message endpoint used for loading messages.
  * @param future_messages queue that stores messages to be processed in future steps.
  * @param step_n current simulation step number.
  *
+ * @return impact message that should be sent at the current step or `std::nullopt` if there is no such message.
+ *
  * @details This function is a thin wrapper that forwards all arguments to 
  * @ref projections::calculate_projection, which performs the actual computation for the delta
  * synapse projection.
  */
 template <class DeltaLikeSynapseType>
-void calculate_delta_synapse_projection(
+std::optional<core::messaging::SynapticImpactMessage> calculate_delta_synapse_projection(
     knp::core::Projection<DeltaLikeSynapseType> &proj, knp::core::MessageEndpoint &endpoint,
     projections::MessageQueue &future_messages, size_t step_n)
 {
-    projections::calculate_projection(proj, endpoint, future_messages, step_n);
+    return projections::calculate_projection(proj, endpoint, future_messages, step_n);
 }
 
 }  // namespace knp::backends::cpu
@@ -210,26 +210,17 @@ void MultiThreadedCPUBackend::calculate_populations()
     auto spike_messages = calculate_populations_post_impact();
 
     // Sending non-empty messages.
-    for (const auto &message : spike_messages)
+    std::vector<core::messaging::MessageVariant> messages_to_send;
+    messages_to_send.reserve(spike_messages.size());
+    for (auto &message : spike_messages)
     {
         if (message.neuron_indexes_.empty())
         {
             continue;
         }
-        get_message_endpoint().send_message(message);
-    }
-}
-
-template <class ProjectionWrapper>
-void send_message(ProjectionWrapper &projection, core::MessageEndpoint &endpoint, uint64_t step)
-{
-    auto &msg_queue = projection.messages_;
-    auto msg_iter = msg_queue.find(step);
-    if (msg_iter != msg_queue.end())
-    {
-        endpoint.send_message(std::move(msg_iter->second));
-        msg_queue.erase(msg_iter);
+        messages_to_send.emplace_back(std::move(message));
     }
+    get_message_endpoint().send_messages(std::move(messages_to_send));
 }
 
 inline std::unordered_map<uint64_t, size_t> convert_spikes(const core::messaging::SpikeMessage &message)
@@ -265,6 +256,20 @@ void MultiThreadedCPUBackend::calculate_projections()
 
         // Looping over synapses.
         converted_message_buffer.emplace_back(convert_spikes(msg_buf[0]));
+        // Projection parts modifying synapses are calculated in parallel, so shared synapses are copied beforehand.
+        // Synapses of locked projections are not modified and stay shared.
+        std::visit(
+            [](auto &proj)
+            {
+                using T = std::decay_t<decltype(proj)>;
+                if constexpr (std::is_same_v<
+                                  typename T::ProjectionSynapseType,
+                                  knp::synapse_traits::SynapticResourceSTDPDeltaSynapse>)
+                {
+                    if (!proj.is_locked()) proj.unshare_synapses();
+                }
+            },
+            projection.arg_);
         const auto proj_size = std::visit([](const auto &proj) { return proj.size(); }, projection.arg_);
         for (size_t synapse_index = 0; synapse_index < proj_size; synapse_index += projection_part_size_)
         {
@@ -282,16 +287,19 @@ void MultiThreadedCPUBackend::calculate_projections()
     }
     calc_pool_->join();
     // Sending messages. It might be possible to parallelize this as well if we use more than one endpoint.
+    std::vector<core::messaging::MessageVariant> messages_to_send;
+    messages_to_send.reserve(projections_.size());
     for (auto &projection : projections_)
     {
         auto &msg_queue = projection.messages_;
         auto msg_iter = msg_queue.find(get_step());
         if (msg_iter != msg_queue.end())
         {
-            get_message_endpoint().send_message(std::move(msg_iter->second));
+            messages_to_send.emplace_back(std::move(msg_iter->second));
             msg_queue.erase(msg_iter);
         }
     }
+    get_message_endpoint().send_messages(std::move(messages_to_send));
 }
 
 
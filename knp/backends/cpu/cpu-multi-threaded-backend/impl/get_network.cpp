@@ -93,4 +93,22 @@ core::Backend::DataRanges MultiThreadedCPUBackend::get_network_data() const
     auto proj_range = std::make_pair(std::move(proj_begin), std::move(proj_end));
     return DataRanges{std::move(proj_range), std::move(pop_range)};
 }
+
+
+void MultiThreadedCPUBackend::visit_projections(const ProjectionVisitor &visitor) const
+{
+    for (const auto &wrapper : projections_)
+    {
+        std::visit([&visitor](const auto &proj) { visitor(ProjectionConstPointer{&proj}); }, wrapper.arg_);
+    }
+}
+
+
+void MultiThreadedCPUBackend::visit_populations(const PopulationVisitor &visitor) const
+{
+    for (const auto &population : populations_)
+    {
+        std::visit([&visitor](const auto &pop) { visitor(PopulationConstPointer{&pop}); }, population);
+    }
+}
 }  // namespace knp::backends::multi_threaded_cpu
@@ -155,6 +155,20 @@ public:
      */
     [[nodiscard]] DataRanges get_network_data() const override;
 
+    /**
+     * @brief Pass every projection loaded to the backend to a visitor function without copying.
+     *
+     * @param visitor function that receives a pointer to a projection.
+     */
+    void visit_projections(const ProjectionVisitor &visitor) const override;
+
+    /**
+     * @brief Pass every population loaded to the backend to a visitor function without copying.
+     *
+     * @param visitor function that receives a pointer to a population.
+     */
+    void visit_populations(const PopulationVisitor &visitor) const override;
+
 
     /**
      * @brief Types of constant population iterators.
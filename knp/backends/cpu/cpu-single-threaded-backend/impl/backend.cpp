@@ -92,10 +92,12 @@ void SingleThreadedCPUBackend::_step()
     get_message_bus().route_messages();
     get_message_endpoint().receive_all_messages();
     // Calculate populations. This is the same as inference.
+    // Messages of all populations are sent at once.
+    std::vector<core::messaging::MessageVariant> messages_to_send;
     for (auto &population : populations_)
     {
         std::visit(
-            [this](auto &arg)
+            [this, &messages_to_send](auto &arg)
             {
                 using T = std::decay_t<decltype(arg)>;
                 if constexpr (
@@ -106,18 +108,21 @@ void SingleThreadedCPUBackend::_step()
                         "Population is not supported by the single-threaded CPU backend.");
                 }
                 auto message_opt = calculate_population(arg);
+                if (message_opt) messages_to_send.emplace_back(std::move(*message_opt));
             },
             population);
     }
+    get_message_endpoint().send_messages(std::move(messages_to_send));
 
     // Continue inference.
     get_message_bus().route_messages();
     get_message_endpoint().receive_all_messages();
     // Calculate projections.
+    messages_to_send.clear();
     for (auto &projection : projections_)
     {
         std::visit(
-            [this, &projection](auto &arg)
+            [this, &projection, &messages_to_send](auto &arg)
             {
                 using T = std::decay_t<decltype(arg)>;
                 if constexpr (
@@ -127,10 +132,12 @@ void SingleThreadedCPUBackend::_step()
                         knp::meta::always_false_v<T>,
                         "Projection is not supported by the single-threaded CPU backend.");
                 }
-                calculate_projection(arg, projection.messages_);
+                auto message_opt = calculate_projection(arg, projection.messages_);
+                if (message_opt) messages_to_send.emplace_back(std::move(*message_opt));
             },
             projection.arg_);
     }
+    get_message_endpoint().send_messages(std::move(messages_to_send));
 
     get_message_bus().route_messages();
     get_message_endpoint().receive_all_messages();
@@ -260,31 +267,31 @@ std::optional<core::messaging::SpikeMessage> SingleThreadedCPUBackend::calculate
 }
 
 
-void SingleThreadedCPUBackend::calculate_projection(
+std::optional<core::messaging::SynapticImpactMessage> SingleThreadedCPUBackend::calculate_projection(
     knp::core::Projection<knp::synapse_traits::DeltaSynapse> &projection, SynapticMessageQueue &message_queue)
 {
     SPDLOG_TRACE("Calculate delta synapse projection {}.", std::string(projection.get_uid()));
-    knp::backends::cpu::calculate_delta_synapse_projection(
+    return knp::backends::cpu::calculate_delta_synapse_projection(
         projection, get_message_endpoint(), message_queue, get_step());
 }
 
 
-void SingleThreadedCPUBackend::calculate_projection(
+std::optional<core::messaging::SynapticImpactMessage> SingleThreadedCPUBackend::calculate_projection(
     knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse> &projection,
     SynapticMessageQueue &message_queue)
 {
     SPDLOG_TRACE("Calculate AdditiveSTDPDelta synapse projection {}.", std::string(projection.get_uid()));
-    knp::backends::cpu::calculate_delta_synapse_projection(
+    return knp::backends::cpu::calculate_delta_synapse_projection(
         projection, get_message_endpoint(), message_queue, get_step());
 }
 
 
-void SingleThreadedCPUBackend::calculate_projection(
+std::optional<core::messaging::SynapticImpactMessage> SingleThreadedCPUBackend::calculate_projection(
     knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> &projection,
     SynapticMessageQueue &message_queue)
 {
     SPDLOG_TRACE("Calculate STDPSynapticResource synapse projection {}.", std::string(projection.get_uid()));
-    knp::backends::cpu::calculate_delta_synapse_projection(
+    return knp::backends::cpu::calculate_delta_synapse_projection(
         projection, get_message_endpoint(), message_queue, get_step());
 }
 
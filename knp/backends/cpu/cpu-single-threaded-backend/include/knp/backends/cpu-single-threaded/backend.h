@@ -30,6 +30,7 @@
 #include <knp/synapse-traits/all_traits.h>
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -338,6 +339,20 @@ public:
      */
     [[nodiscard]] DataRanges get_network_data() const override;
 
+    /**
+     * @brief Pass every projection loaded to the backend to a visitor function without copying.
+     *
+     * @param visitor function that receives a pointer to a projection.
+     */
+    void visit_projections(const ProjectionVisitor &visitor) const override;
+
+    /**
+     * @brief Pass every population loaded to the backend to a visitor function without copying.
+     *
+     * @param visitor function that receives a pointer to a population.
+     */
+    void visit_populations(const PopulationVisitor &visitor) const override;
+
 protected:
     /**
      * @brief Map used for message construction. It maps a message to its future output step.
@@ -418,9 +433,11 @@ protected:
      * @param projection projection to calculate.
      * @param message_queue message queue to send to projection for calculation.
      *
+     * @return impact message to send at the current step; empty if the projection doesn't send a message.
+     *
      * @note The projection is modified during the calculation.
      */
-    void calculate_projection(
+    std::optional<core::messaging::SynapticImpactMessage> calculate_projection(
         knp::core::Projection<knp::synapse_traits::DeltaSynapse> &projection, SynapticMessageQueue &message_queue);
     /**
      * @brief Calculate a projection of `AdditiveSTDPDeltaSynapse` synapses.
@@ -428,9 +445,11 @@ protected:
      * @param projection projection to calculate.
      * @param message_queue message queue to send to projection for calculation.
      *
+     * @return impact message to send at the current step; empty if the projection doesn't send a message.
+     *
      * @note The projection is modified during the calculation.
      */
-    void calculate_projection(
+    std::optional<core::messaging::SynapticImpactMessage> calculate_projection(
         knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse> &projection,
         SynapticMessageQueue &message_queue);
     /**
@@ -439,9 +458,11 @@ protected:
      * @param projection projection to calculate.
      * @param message_queue message queue to send to projection for calculation.
      *
+     * @return impact message to send at the current step; empty if the projection doesn't send a message.
+     *
      * @note The projection is modified during the calculation.
      */
-    void calculate_projection(
+    std::optional<core::messaging::SynapticImpactMessage> calculate_projection(
         knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> &projection,
         SynapticMessageQueue &message_queue);
 
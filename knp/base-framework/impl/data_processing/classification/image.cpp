@@ -21,36 +21,144 @@
 
 #include <knp/framework/data_processing/classification/image.h>
 
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
 
 namespace knp::framework::data_processing::classification::images
 {
 
+namespace
+{
+
+// Read up to `max_images_amount` labels and the same number of raw images.
+std::vector<Dataset::Label> read_labels_and_images(
+    std::istream &images_stream, std::istream &labels_stream, size_t max_images_amount, size_t image_size,
+    std::vector<uint8_t> &images)
+{
+    std::vector<Dataset::Label> labels;
+    std::string str;
+    while (labels.size() < max_images_amount && std::getline(labels_stream, str))
+        labels.push_back(static_cast<Dataset::Label>(std::stoi(str)));
+
+    images.resize(labels.size() * image_size);
+    images_stream.read(reinterpret_cast<char *>(images.data()), static_cast<std::streamsize>(images.size()));
+
+    // Labels without a complete image are dropped.
+    const size_t images_amount = image_size ? static_cast<size_t>(images_stream.gcount()) / image_size : 0;
+    if (images_amount < labels.size())
+    {
+        labels.resize(images_amount);
+        images.resize(images_amount * image_size);
+    }
+
+    return labels;
+}
+
+
+Dataset::Frame encode_image(
+    std::vector<uint8_t> const &image, std::vector<float> &states, size_t active_steps, float state_increment_factor)
+{
+    Dataset::Frame frame;
+    frame.step_ends_.reserve(active_steps);
+
+    // Inactive steps have no spikes and are not stored.
+    for (size_t i = 0; i < active_steps; ++i)
+    {
+        for (size_t l = 0; l < states.size(); ++l)
+        {
+            states[l] += state_increment_factor * static_cast<float>(image[l]);
+            if (states[l] >= 1.F)
+            {
+                frame.indexes_.push_back(static_cast<knp::core::messaging::SpikeIndex>(l));
+                --states[l];
+            }
+        }
+        frame.step_ends_.push_back(static_cast<uint32_t>(frame.indexes_.size()));
+    }
+
+    frame.indexes_.shrink_to_fit();
+    return frame;
+}
+
+}  // namespace
+
+
 void Dataset::process_labels_and_images(
     std::istream &images_stream, std::istream &labels_stream, size_t max_images_amount, size_t classes_amount,
     size_t image_size, size_t steps_per_image,
     std::function<Frame(std::vector<uint8_t> const &)> const &image_to_spikes)
+{
+    // A single thread calls the converter in the order of images, so the converter may keep state.
+    process_labels_and_images(
+        images_stream, labels_stream, max_images_amount, classes_amount, image_size, steps_per_image, image_to_spikes,
+        1);
+}
+
+
+void Dataset::process_labels_and_images(
+    std::istream &images_stream, std::istream &labels_stream, size_t max_images_amount, size_t classes_amount,
+    size_t image_size, size_t steps_per_image,
+    std::function<Frame(std::vector<uint8_t> const &)> const &image_to_spikes, size_t threads_count)
 {
     image_size_ = image_size;
     steps_per_frame_ = steps_per_image;
     classes_amount_ = classes_amount;
 
-    std::vector<uint8_t> image_reading_buffer(image_size, 0);
+    std::vector<uint8_t> images;
+    const auto labels = read_labels_and_images(images_stream, labels_stream, max_images_amount, image_size, images);
 
-    dataset_.reserve(max_images_amount);
+    // Push to training data set because we dont know dataset size yet for a split
+    const size_t first_frame = dataset_.size();
+    dataset_.resize(first_frame + labels.size());
+    for (size_t i = 0; i < labels.size(); ++i) dataset_[first_frame + i].first = labels[i];
 
-    while (images_stream.good() && labels_stream.good())
+    auto convert_images = [&](size_t begin, size_t end)
     {
-        images_stream.read(reinterpret_cast<char *>(image_reading_buffer.data()), image_size);
-        auto spikes_frame = image_to_spikes(image_reading_buffer);
+        std::vector<uint8_t> image(image_size);
+        for (size_t i = begin; i < end; ++i)
+        {
+            std::copy_n(images.begin() + static_cast<std::ptrdiff_t>(i * image_size), image_size, image.begin());
+            dataset_[first_frame + i].second = image_to_spikes(image);
+        }
+    };
 
-        std::string str;
-        if (!std::getline(labels_stream, str).good()) break;
-        int label = std::stoi(str);
+    if (!threads_count) threads_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    threads_count = std::min(threads_count, labels.size());
+    if (threads_count <= 1)
+    {
+        convert_images(0, labels.size());
+        return;
+    }
 
-        // Push to training data set because we dont know dataset size yet for a split
-        dataset_.push_back({label, std::move(spikes_frame)});
+    std::vector<std::exception_ptr> errors(threads_count);
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count);
+    for (size_t t = 0; t < threads_count; ++t)
+    {
+        const size_t begin = labels.size() * t / threads_count;
+        const size_t end = labels.size() * (t + 1) / threads_count;
+        threads.emplace_back(
+            [&convert_images, &errors, t, begin, end]
+            {
+                try
+                {
+                    convert_images(begin, end);
+                }
+                catch (...)
+                {
+                    errors[t] = std::current_exception();
+                }
+            });
+    }
 
-        if (dataset_.size() == max_images_amount) break;
+    for (auto &thread : threads) thread.join();
+    for (const auto &error : errors)
+    {
+        if (error) std::rethrow_exception(error);
     }
 }
 
@@ -74,22 +182,10 @@ std::function<knp::core::messaging::SpikeData(knp::core::Step)> Dataset::make_tr
 {
     return [this](knp::core::Step step)
     {
-        knp::core::messaging::SpikeData message;
-
         const size_t frame_index = step / steps_per_frame_;
         const size_t looped_frame_index = frame_index % frames_amount_for_training_;
 
-        auto const &data = dataset_[looped_frame_index].second.spikes_;
-
-        const size_t local_step = step % steps_per_frame_;
-        const size_t frame_start = local_step * image_size_;
-
-        for (size_t i = frame_start; i < frame_start + image_size_; ++i)
-        {
-            if (data[i]) message.push_back(i - frame_start);
-        }
-
-        return message;
+        return dataset_[looped_frame_index].second.get_spikes(step % steps_per_frame_);
     };
 }
 
@@ -98,22 +194,10 @@ std::function<knp::core::messaging::SpikeData(knp::core::Step)> Dataset::make_in
 {
     return [this](knp::core::Step step)
     {
-        knp::core::messaging::SpikeData message;
-
         const size_t frame_index = step / steps_per_frame_;
         const size_t looped_frame_index = frame_index % frames_amount_for_inference_;
 
-        auto const &data = dataset_[frames_amount_for_training_ + looped_frame_index].second.spikes_;
-
-        const size_t local_step = step % steps_per_frame_;
-        const size_t frame_start = local_step * image_size_;
-
-        for (size_t i = frame_start; i < frame_start + image_size_; ++i)
-        {
-            if (data[i]) message.push_back(i - frame_start);
-        }
-
-        return message;
+        return dataset_[frames_amount_for_training_ + looped_frame_index].second.get_spikes(step % steps_per_frame_);
     };
 }
 
@@ -126,27 +210,19 @@ std::function<Dataset::Frame(std::vector<uint8_t> const &)> Dataset::make_increm
     return [this, active_steps, state_increment_factor, states](std::vector<uint8_t> const &image) mutable -> Frame
     {
         if (!states.size()) states.resize(image_size_, 0.F);
+        return encode_image(image, states, active_steps, state_increment_factor);
+    };
+}
 
-        std::vector<bool> ret;
-        ret.reserve(steps_per_frame_ * image_size_);
-
-        for (size_t i = 0; i < active_steps; ++i)
-        {
-            ret.insert(ret.end(), image_size_, false);
-            for (size_t l = 0; l < image_size_; ++l)
-            {
-                states[l] += state_increment_factor * static_cast<float>(image[l]);
-                if (states[l] >= 1.F)
-                {
-                    ret[ret.size() - image_size_ + l] = true;
-                    --states[l];
-                }
-            }
-        }
-
-        ret.insert(ret.end(), (steps_per_frame_ - active_steps) * image_size_, false);
 
-        return {std::move(ret)};
+std::function<Dataset::Frame(std::vector<uint8_t> const &)>
+Dataset::make_independent_incrementing_image_to_spikes_converter(
+    size_t active_steps, float state_increment_factor, float initial_state) const
+{
+    return [this, active_steps, state_increment_factor, initial_state](std::vector<uint8_t> const &image) -> Frame
+    {
+        std::vector<float> states(image_size_, initial_state);
+        return encode_image(image, states, active_steps, state_increment_factor);
     };
 }
 
@@ -21,6 +21,9 @@
 
 #include <knp/framework/message_handlers.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_set>
 #include <utility>
 
@@ -31,20 +34,43 @@
 namespace knp::framework::modifier
 {
 
+namespace
+{
+// Standard distributions and `std::shuffle` differ between standard libraries, so random indexes are reduced to
+// ranges explicitly and the results don't depend on the library.
+class RandomSequence
+{
+public:
+    RandomSequence(const random::CounterBasedRandom &random, core::Step step) : random_(random), step_(step) {}
+
+    // Get a random index in the `[0, bound)` range.
+    size_t next_index(size_t bound) { return static_cast<size_t>(random_.uniform_int(counter_++, step_, bound)); }
+
+private:
+    const random::CounterBasedRandom &random_;
+    core::Step step_;
+    uint64_t counter_ = 0;
+};
+
+
+// Fisher-Yates shuffle.
+template <class Iterator>
+void shuffle(Iterator begin, Iterator end, RandomSequence &random_sequence)
+{
+    for (auto size = static_cast<size_t>(end - begin); size > 1; --size)
+        std::iter_swap(begin + (size - 1), begin + random_sequence.next_index(size));
+}
+
+
+// Partial Fisher-Yates shuffle: the first `n` elements become a random selection.
 knp::core::messaging::SpikeData select_random_n(
-    knp::core::messaging::SpikeData &input, size_t n, std::mt19937 &random_engine)
+    knp::core::messaging::SpikeData &input, size_t n, RandomSequence &random_sequence)
 {
     if (input.size() <= n) return input;
-    std::uniform_int_distribution<size_t> distribution;
-    knp::core::messaging::SpikeData result;
-    for (size_t i = 0; i < n; ++i)
-    {
-        const size_t index = distribution(random_engine) % (input.size() - i);
-        result.push_back(input[index]);
-        std::swap(input[index], input[input.size() - 1 - i]);
-    }
-    return result;
+    for (size_t i = 0; i < n; ++i) std::swap(input[i], input[i + random_sequence.next_index(input.size() - i)]);
+    return knp::core::messaging::SpikeData(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(n));
 }
+}  // namespace
 
 
 knp::core::messaging::SpikeData KWtaRandomHandler::operator()(std::vector<knp::core::messaging::SpikeMessage> &messages)
@@ -60,7 +86,8 @@ knp::core::messaging::SpikeData KWtaRandomHandler::operator()(std::vector<knp::c
         return msg.neuron_indexes_;
     }
 
-    knp::core::messaging::SpikeData out_spikes = select_random_n(msg.neuron_indexes_, num_winners_, random_engine_);
+    RandomSequence random_sequence(random_, msg.header_.send_time_);
+    knp::core::messaging::SpikeData out_spikes = select_random_n(msg.neuron_indexes_, num_winners_, random_sequence);
 
     return out_spikes;
 }
@@ -110,7 +137,8 @@ knp::core::messaging::SpikeData GroupWtaRandomHandler::operator()(
     assert(static_cast<size_t>(group_interval.first - spikes_per_group.begin() + 1) <= num_winners_);
     
     // The approach could be more efficient, but I don't think it's necessary.
-    std::shuffle(group_interval.first, group_interval.second, random_engine_);
+    RandomSequence random_sequence(random_, messages[0].header_.send_time_);
+    shuffle(group_interval.first, group_interval.second, random_sequence);
     knp::core::messaging::SpikeData result;
     for (size_t i = 0; i < num_winners_; ++i)
     {
@@ -141,9 +169,10 @@ knp::core::messaging::SpikeData KWtaPerGroup::operator()(
 
     knp::core::messaging::SpikeData result;
     result.reserve(group_borders_.size() * winners_per_group_);
+    RandomSequence random_sequence(random_, messages[0].header_.send_time_);
     for (auto &spike_group : spikes_per_group)
     {
-        knp::core::messaging::SpikeData result_buf = select_random_n(spike_group, winners_per_group_, random_engine_);
+        knp::core::messaging::SpikeData result_buf = select_random_n(spike_group, winners_per_group_, random_sequence);
         result.insert(result.end(), result_buf.begin(), result_buf.end());
     }
     return result;
@@ -48,6 +48,20 @@ void Model::add_output_channel(const core::UID &channel_uid, const core::UID &po
 }
 
 
+void Model::set_output_channel_retention(const core::UID &channel_uid, size_t retention_steps)
+{
+    out_retention_steps_[channel_uid] = retention_steps;
+}
+
+
+size_t Model::get_output_channel_retention(const core::UID &channel_uid) const
+{
+    const auto retention = out_retention_steps_.find(channel_uid);
+    return retention != out_retention_steps_.end() ? retention->second
+                                                   : io::output::OutputChannel::unlimited_retention;
+}
+
+
 const std::unordered_multimap<core::UID, core::UID, core::uid_hash> &Model::get_input_channels() const
 {
     return in_channels_;
@@ -124,6 +124,12 @@ void ModelExecutor::start(core::Backend::RunPredicate run_predicate)
 
             return true;
         });
+
+    // Wait for asynchronous observers.
+    for (auto &observer : observers_)
+    {
+        std::visit([](auto &entity) { entity.stop(); }, observer);
+    }
     SPDLOG_INFO("Model execution stopped.");
 }
 
@@ -102,7 +102,7 @@ void ModelLoader::gen_output_channel(
 {
     auto endpoint = backend_->get_message_bus().create_endpoint();
     endpoint.subscribe<knp::core::messaging::SpikeMessage>(channel_uid, p_uids);
-    out_channels_.emplace_back(channel_uid, std::move(endpoint));
+    out_channels_.emplace_back(channel_uid, std::move(endpoint), model.get_output_channel_retention(channel_uid));
 
     auto &network = model.get_network();
 
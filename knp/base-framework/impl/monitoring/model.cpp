@@ -25,10 +25,25 @@
 #include <knp/framework/monitoring/model.h>
 #include <knp/synapse-traits/stdp_synaptic_resource_rule.h>
 
+#include <spdlog/spdlog.h>
+
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
 #include <map>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <type_traits>
+
+#include "../sonata/highfive.h"
+#include "../storage/native/data_storage_common.h"
 
 namespace knp::framework::monitoring::model
 {
@@ -47,64 +62,389 @@ struct WeightByReceiverSender
 };
 
 
-auto process_projection_weights(const knp::core::AllProjectionsVariant &proj_variant)
+/**
+ * @brief Weights of projection synapses sorted by receiver and then by sender.
+ * 
+ * @details The order of synapses is calculated once and reused while the projection keeps the same synapses, so that
+ * weights are not sorted every logging period.
+ */
+class SortedWeightsCollector
 {
-    const auto &proj = std::get<ResourceDeltaProjection>(proj_variant);
-    std::vector<WeightByReceiverSender> weights_by_receiver_sender;
-    for (const auto &synapse_data : proj)
+public:
+    const std::vector<WeightByReceiverSender> &collect(const ResourceDeltaProjection &proj)
+    {
+        const auto &synapses = proj.get_synapses();
+        if (order_.size() == synapses.size() && update_weights(synapses)) return weights_;
+
+        // Synapses were added, removed or reordered, so the order is calculated again.
+        order_.resize(synapses.size());
+        std::iota(order_.begin(), order_.end(), 0);
+        std::sort(
+            order_.begin(), order_.end(),
+            [&synapses](size_t index1, size_t index2)
+            {
+                return std::make_tuple(get_receiver(synapses[index1]), get_sender(synapses[index1])) <
+                       std::make_tuple(get_receiver(synapses[index2]), get_sender(synapses[index2]));
+            });
+        weights_.resize(synapses.size());
+        for (size_t i = 0; i < order_.size(); ++i)
+        {
+            weights_[i].receiver_ = get_receiver(synapses[order_[i]]);
+            weights_[i].sender_ = get_sender(synapses[order_[i]]);
+        }
+        update_weights(synapses);
+        return weights_;
+    }
+
+private:
+    template <class Synapse>
+    static size_t get_receiver(const Synapse &synapse)
     {
-        float weight = std::get<knp::core::SynapseElementAccess::synapse_data>(synapse_data).rule_.synaptic_resource_;
-        knp::core::Step update_step =
-            std::get<knp::core::SynapseElementAccess::synapse_data>(synapse_data).rule_.last_spike_step_;
-        size_t sender = std::get<knp::core::SynapseElementAccess::source_neuron_id>(synapse_data);
-        size_t receiver = std::get<knp::core::SynapseElementAccess::target_neuron_id>(synapse_data);
-        weights_by_receiver_sender.push_back({receiver, sender, weight, update_step});
+        return std::get<knp::core::SynapseElementAccess::target_neuron_id>(synapse);
     }
-    std::sort(
-        weights_by_receiver_sender.begin(), weights_by_receiver_sender.end(),
-        [](const WeightByReceiverSender &v1, const WeightByReceiverSender &v2)
+
+    template <class Synapse>
+    static size_t get_sender(const Synapse &synapse)
+    {
+        return std::get<knp::core::SynapseElementAccess::source_neuron_id>(synapse);
+    }
+
+    // Return `false` if a synapse doesn't match the cached order.
+    bool update_weights(const ResourceDeltaProjection::SynapsesContainer &synapses)
+    {
+        for (size_t i = 0; i < order_.size(); ++i)
         {
-            if (v1.receiver_ != v2.receiver_) return v1.receiver_ < v2.receiver_;
-            return v1.sender_ < v2.sender_;
-        });
-    return weights_by_receiver_sender;
+            const auto &synapse = synapses[order_[i]];
+            auto &weight = weights_[i];
+            if (get_receiver(synapse) != weight.receiver_ || get_sender(synapse) != weight.sender_) return false;
+
+            const auto &rule = std::get<knp::core::SynapseElementAccess::synapse_data>(synapse).rule_;
+            weight.weight_ = rule.synaptic_resource_;
+            weight.update_step_ = rule.last_spike_step_;
+        }
+        return true;
+    }
+
+    // Indexes of synapses in the projection in the sorted order.
+    std::vector<size_t> order_;
+    std::vector<WeightByReceiverSender> weights_;
+};
+
+
+void write_projection_weights(std::ostream &weights_log, const std::vector<WeightByReceiverSender> &weights)
+{
+    size_t neuron = std::numeric_limits<size_t>::max();
+    for (const auto &syn_data : weights)
+    {
+        size_t new_neuron = syn_data.receiver_;
+        if (neuron != new_neuron)
+        {
+            neuron = new_neuron;
+            weights_log << std::endl << "Neuron " << neuron << std::endl;
+        }
+        weights_log << syn_data.weight_ << "|" << syn_data.update_step_ << " ";
+    }
+    weights_log << std::endl;
 }
 
+
 SpikeProcessor make_projection_weights_observer_function(
     std::ostream &weights_log, size_t period, knp::framework::ModelExecutor &model_executor, const knp::core::UID &uid)
 {
-    auto observer_func =
-        [&weights_log, period, &model_executor, uid](const std::vector<knp::core::messaging::SpikeMessage> &)
+    auto observer_func = [&weights_log, period, &model_executor, uid,
+                          collector = std::make_shared<SortedWeightsCollector>()](
+                             const std::vector<knp::core::messaging::SpikeMessage> &)
     {
         size_t step = model_executor.get_backend()->get_step();
         if (!weights_log.good() || step % period != 0) return;
         // Output weights for every step that is a full square
         weights_log << "Step: " << step << std::endl;
-        const auto ranges = model_executor.get_backend()->get_network_data();
-        for (auto &iter = *(ranges.projection_range.first); iter != *(ranges.projection_range.second); ++iter)
-        {
-            const knp::core::UID curr_proj_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, *iter);
-            if (curr_proj_uid != uid) continue;
-            auto weights_by_receiver_sender = process_projection_weights(*iter);
-            size_t neuron = std::numeric_limits<size_t>::max();
-            for (const auto &syn_data : weights_by_receiver_sender)
+        // Projections are visited by reference, so the weights are not copied every logging period.
+        model_executor.get_backend()->for_each_projection(
+            [&weights_log, &uid, &collector](const auto &proj)
             {
-                size_t new_neuron = syn_data.receiver_;
-                if (neuron != new_neuron)
+                using ProjectionType = std::decay_t<decltype(proj)>;
+                if (proj.get_uid() != uid) return;
+                if constexpr (std::is_same_v<ProjectionType, ResourceDeltaProjection>)
                 {
-                    neuron = new_neuron;
-                    weights_log << std::endl << "Neuron " << neuron << std::endl;
+                    write_projection_weights(weights_log, collector->collect(proj));
                 }
-                weights_log << syn_data.weight_ << "|" << syn_data.update_step_ << " ";
-            }
-            weights_log << std::endl;
-            return;
-        }
+                else
+                {
+                    throw std::runtime_error("Weights logger supports only synaptic resource STDP projections.");
+                }
+            });
     };
     return observer_func;
 }
 
 
+class WeightsWriter
+{
+public:
+    virtual ~WeightsWriter() = default;
+    virtual void write(knp::core::Step step, const std::vector<WeightByReceiverSender> &weights) = 0;
+    // Write buffered records to the file.
+    virtual void flush() = 0;
+};
+
+
+class RawWeightsWriter : public WeightsWriter
+{
+public:
+    struct Header
+    {
+        uint32_t magic_;
+        uint32_t version_;
+        uint64_t synapses_count_;
+    };
+
+    static_assert(sizeof(Header) == 16, "Weights file header must not have padding.");
+
+    static constexpr uint32_t version = 1;
+
+public:
+    explicit RawWeightsWriter(const std::filesystem::path &path_to_save)
+        : out_file_(path_to_save, std::ios::out | std::ios::binary | std::ios::trunc)
+    {
+        if (!out_file_)
+            throw std::runtime_error("Unable to open file \"" + path_to_save.string() + "\" for writing.");
+    }
+
+    void write(knp::core::Step step, const std::vector<WeightByReceiverSender> &weights) override
+    {
+        buffer_.clear();
+        if (!synapses_count_)
+        {
+            // Header and synapse table are written with the first record.
+            synapses_count_ = weights.size();
+            const Header header{
+                static_cast<uint32_t>(knp::framework::io::storage::native::MAGIC_NUMBER), version, weights.size()};
+            append(&header, 1);
+            for (const auto &synapse : weights) append_value(static_cast<uint32_t>(synapse.receiver_));
+            for (const auto &synapse : weights) append_value(static_cast<uint32_t>(synapse.sender_));
+        }
+        else if (*synapses_count_ != weights.size())
+        {
+            throw std::runtime_error(
+                "Number of synapses changed from " + std::to_string(*synapses_count_) + " to " +
+                std::to_string(weights.size()) + ".");
+        }
+
+        append_value(static_cast<uint64_t>(step));
+        for (const auto &synapse : weights) append_value(static_cast<uint64_t>(synapse.update_step_));
+        for (const auto &synapse : weights) append_value(synapse.weight_);
+        buffer_.resize((buffer_.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t), 0);
+
+        out_file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        if (++unflushed_records_count_ == records_per_flush) flush();
+        if (!out_file_) throw std::runtime_error("Unable to write weights to file.");
+    }
+
+    void flush() override
+    {
+        out_file_.flush();
+        unflushed_records_count_ = 0;
+        if (!out_file_) throw std::runtime_error("Unable to write weights to file.");
+    }
+
+private:
+    template <class ValueType>
+    void append(const ValueType *values, size_t count)
+    {
+        const size_t size = buffer_.size();
+        buffer_.resize(size + count * sizeof(ValueType));
+        std::memcpy(buffer_.data() + size, values, count * sizeof(ValueType));
+    }
+
+    template <class ValueType>
+    void append_value(ValueType value)
+    {
+        append(&value, 1);
+    }
+
+    // Records are flushed periodically, so that a long simulation doesn't flush the file every logging period.
+    static constexpr size_t records_per_flush = 64;
+
+    std::ofstream out_file_;
+    // Record is formed in memory and written at once.
+    std::vector<char> buffer_;
+    std::optional<size_t> synapses_count_;
+    size_t unflushed_records_count_ = 0;
+};
+
+
+class H5WeightsWriter : public WeightsWriter
+{
+public:
+    H5WeightsWriter(const std::filesystem::path &path_to_save, unsigned compression_level)
+        : data_file_(path_to_save.string(), HighFive::File::Create | HighFive::File::Overwrite),
+          compression_level_(compression_level)
+    {
+        data_file_.createAttribute("magic", knp::framework::io::storage::native::MAGIC_NUMBER);
+        data_file_.createAttribute("version", std::array<int, 2>{0, 1});
+        data_file_.createGroup("weights");
+    }
+
+    ~H5WeightsWriter() override
+    {
+        try
+        {
+            flush();
+        }
+        catch (const std::exception &e)
+        {
+            SPDLOG_ERROR("Unable to write weights to file: {}.", e.what());
+        }
+    }
+
+    void write(knp::core::Step step, const std::vector<WeightByReceiverSender> &weights) override
+    {
+        const size_t synapses_count = weights.size();
+        if (!steps_)
+            create_datasets(weights);
+        else if (synapses_count_ != synapses_count)
+        {
+            throw std::runtime_error(
+                "Number of synapses changed from " + std::to_string(synapses_count_) + " to " +
+                std::to_string(synapses_count) + ".");
+        }
+
+        // Records are buffered and written by whole chunks.
+        pending_steps_.push_back(static_cast<int64_t>(step));
+        for (const auto &synapse : weights)
+        {
+            pending_values_.push_back(synapse.weight_);
+            pending_update_steps_.push_back(static_cast<int64_t>(synapse.update_step_));
+        }
+        if (pending_steps_.size() == records_per_chunk_) flush();
+    }
+
+    void flush() override
+    {
+        if (pending_steps_.empty()) return;
+
+        const size_t pending_count = pending_steps_.size();
+        steps_->resize({records_count_ + pending_count});
+        steps_->select({records_count_}, {pending_count}).write_raw(pending_steps_.data());
+        if (synapses_count_)
+        {
+            values_->resize({records_count_ + pending_count, synapses_count_});
+            values_->select({records_count_, 0}, {pending_count, synapses_count_}).write_raw(pending_values_.data());
+            update_steps_->resize({records_count_ + pending_count, synapses_count_});
+            update_steps_->select({records_count_, 0}, {pending_count, synapses_count_})
+                .write_raw(pending_update_steps_.data());
+        }
+
+        records_count_ += pending_count;
+        pending_steps_.clear();
+        pending_values_.clear();
+        pending_update_steps_.clear();
+        data_file_.flush();
+    }
+
+private:
+    void create_datasets(const std::vector<WeightByReceiverSender> &weights)
+    {
+        synapses_count_ = weights.size();
+        auto group = data_file_.getGroup("weights");
+
+        std::vector<int64_t> target_ids, source_ids;
+        target_ids.reserve(synapses_count_);
+        source_ids.reserve(synapses_count_);
+        for (const auto &synapse : weights)
+        {
+            target_ids.push_back(static_cast<int64_t>(synapse.receiver_));
+            source_ids.push_back(static_cast<int64_t>(synapse.sender_));
+        }
+        group.createDataSet("target_ids", target_ids);
+        group.createDataSet("source_ids", source_ids);
+
+        HighFive::DataSetCreateProps steps_props;
+        steps_props.add(HighFive::Chunking(std::vector<hsize_t>{steps_chunk_size}));
+        steps_ = group.createDataSet<int64_t>(
+            "steps",
+            HighFive::DataSpace(std::vector<size_t>{0}, std::vector<size_t>{HighFive::DataSpace::UNLIMITED}),
+            steps_props);
+
+        // A chunk contains as many records as fit into the chunk size limit, but at least one record.
+        records_per_chunk_ = synapses_count_
+                                 ? std::clamp<size_t>(
+                                       max_chunk_bytes / (synapses_count_ * sizeof(int64_t)), 1, max_records_per_chunk)
+                                 : max_records_per_chunk;
+        pending_steps_.reserve(records_per_chunk_);
+        pending_values_.reserve(records_per_chunk_ * synapses_count_);
+        pending_update_steps_.reserve(records_per_chunk_ * synapses_count_);
+
+        if (!synapses_count_) return;
+
+        const HighFive::DataSpace space(
+            std::vector<size_t>{0, synapses_count_},
+            std::vector<size_t>{HighFive::DataSpace::UNLIMITED, synapses_count_});
+        HighFive::DataSetCreateProps props;
+        props.add(HighFive::Chunking(std::vector<hsize_t>{records_per_chunk_, synapses_count_}));
+        if (compression_level_) props.add(HighFive::Deflate(compression_level_));
+        values_ = group.createDataSet<float>("values", space, props);
+        update_steps_ = group.createDataSet<int64_t>("last_update_steps", space, props);
+    }
+
+    static constexpr size_t steps_chunk_size = 1024;
+    static constexpr size_t max_records_per_chunk = 256;
+    static constexpr size_t max_chunk_bytes = 1 << 20;
+
+    HighFive::File data_file_;
+    unsigned compression_level_;
+    size_t synapses_count_ = 0;
+    size_t records_count_ = 0;
+    size_t records_per_chunk_ = 1;
+    std::optional<HighFive::DataSet> steps_;
+    std::optional<HighFive::DataSet> values_;
+    std::optional<HighFive::DataSet> update_steps_;
+    // Records that are not written to the file yet.
+    std::vector<int64_t> pending_steps_;
+    std::vector<float> pending_values_;
+    std::vector<int64_t> pending_update_steps_;
+};
+
+
+struct WeightsRecord
+{
+    knp::core::Step step_ = 0;
+    std::vector<WeightByReceiverSender> weights_;
+};
+
+
+SpikeProcessor make_projection_weights_writer_function(
+    std::shared_ptr<WeightsWriter> writer, std::shared_ptr<AsyncProcessor<WeightsRecord>> async_writer, size_t period,
+    knp::framework::ModelExecutor &model_executor, const knp::core::UID &uid)
+{
+    return [writer, async_writer, period, &model_executor, uid, collector = std::make_shared<SortedWeightsCollector>()](
+               const std::vector<knp::core::messaging::SpikeMessage> &)
+    {
+        const knp::core::Step step = model_executor.get_backend()->get_step();
+        if (step % period != 0) return;
+        model_executor.get_backend()->for_each_projection(
+            [&writer, &async_writer, &uid, &collector, step](const auto &proj)
+            {
+                using ProjectionType = std::decay_t<decltype(proj)>;
+                if (proj.get_uid() != uid) return;
+                if constexpr (std::is_same_v<ProjectionType, ResourceDeltaProjection>)
+                {
+                    // Weights are read on the simulation thread, and only their copy is passed to the writer thread.
+                    if (async_writer)
+                        async_writer->push(WeightsRecord{step, collector->collect(proj)});
+                    else
+                        writer->write(step, collector->collect(proj));
+                }
+                else
+                {
+                    throw std::runtime_error("Weights writer supports only synaptic resource STDP projections.");
+                }
+            });
+    };
+}
+
+
 void write_aggregated_spikes_logger_header(
     std::ostream &log_stream, const std::map<knp::core::UID, std::string> &senders_names)
 {
@@ -129,21 +469,28 @@ void save_aggregated_spikes_log(std::ostream &log_stream, const std::map<std::st
 }
 
 
+using AggregatedSpikes = std::pair<size_t, std::map<std::string, size_t>>;
+
+
 SpikeProcessor make_aggregated_spikes_observer_function(
     knp::framework::ModelExecutor &model_executor, std::ostream &log_stream, size_t period,
-    const std::map<knp::core::UID, std::string> &sender_names, std::map<std::string, size_t> &accumulator)
+    const std::map<knp::core::UID, std::string> &sender_names, std::map<std::string, size_t> &accumulator,
+    std::shared_ptr<AsyncProcessor<AggregatedSpikes>> async_logger)
 {
     // Initialize accumulator
     accumulator.clear();
     for (const auto &val : sender_names) accumulator.insert({val.second, 0});
-    auto observer_func = [&log_stream, &accumulator, &model_executor, sender_names,
-                          period](const std::vector<knp::core::messaging::SpikeMessage> &messages)
+    auto observer_func = [&log_stream, &accumulator, &model_executor, sender_names, period,
+                          async_logger](const std::vector<knp::core::messaging::SpikeMessage> &messages)
     {
         size_t step = model_executor.get_backend()->get_step();
         if (step % period == 0)
         {
             // Write container to log
-            save_aggregated_spikes_log(log_stream, accumulator, step);
+            if (async_logger)
+                async_logger->push(AggregatedSpikes{step, accumulator});
+            else
+                save_aggregated_spikes_log(log_stream, accumulator, step);
             // Reset container
             accumulator.clear();
             for (const auto &val : sender_names) accumulator.insert({val.second, 0});
@@ -185,17 +532,30 @@ SpikeProcessor make_spikes_observer_function(
 void add_aggregated_spikes_logger(
     const knp::framework::Model &model, const std::map<knp::core::UID, std::string> &senders_names,
     knp::framework::ModelExecutor &model_executor, std::map<std::string, size_t> &spike_accumulator,
-    std::ostream &log_stream, size_t logging_period)
+    std::ostream &log_stream, size_t logging_period, size_t queue_size)
 {
     std::vector<knp::core::UID> all_senders_uids(senders_names.size());
     std::transform(
         senders_names.begin(), senders_names.end(), all_senders_uids.begin(),
         [](std::pair<knp::core::UID, std::string> const &sender) -> knp::core::UID { return sender.first; });
     write_aggregated_spikes_logger_header(log_stream, senders_names);
+
+    // Spikes are counted on the simulation thread, and only the output is done in a background thread.
+    std::shared_ptr<AsyncProcessor<AggregatedSpikes>> async_logger;
+    std::function<void()> stop_handler;
+    if (queue_size)
+    {
+        async_logger = std::make_shared<AsyncProcessor<AggregatedSpikes>>(
+            [&log_stream](const AggregatedSpikes &spikes)
+            { save_aggregated_spikes_log(log_stream, spikes.second, spikes.first); },
+            queue_size);
+        stop_handler = [async_logger] { async_logger->stop(); };
+    }
+
     model_executor.add_observer<knp::core::messaging::SpikeMessage>(
         make_aggregated_spikes_observer_function(
-            model_executor, log_stream, logging_period, senders_names, spike_accumulator),
-        all_senders_uids);
+            model_executor, log_stream, logging_period, senders_names, spike_accumulator, async_logger),
+        all_senders_uids, 0, std::move(stop_handler));
 }
 
 
@@ -208,16 +568,77 @@ void add_projection_weights_logger(
 }
 
 
+void add_projection_weights_writer(
+    const std::filesystem::path &path_to_save, knp::framework::ModelExecutor &model_executor,
+    const knp::core::UID &uid, size_t logging_period, WeightsFileFormat format, unsigned compression_level,
+    size_t queue_size)
+{
+    std::shared_ptr<WeightsWriter> writer;
+    if (WeightsFileFormat::hdf5 == format)
+    {
+        writer = std::make_shared<H5WeightsWriter>(path_to_save, compression_level);
+    }
+    else
+    {
+        if (compression_level) throw std::invalid_argument("Raw weights format does not support compression.");
+        writer = std::make_shared<RawWeightsWriter>(path_to_save);
+    }
+
+    std::shared_ptr<AsyncProcessor<WeightsRecord>> async_writer;
+    if (queue_size)
+    {
+        async_writer = std::make_shared<AsyncProcessor<WeightsRecord>>(
+            [writer](const WeightsRecord &record) { writer->write(record.step_, record.weights_); }, queue_size);
+    }
+
+    // Buffered records are written when model execution stops.
+    model_executor.add_observer<knp::core::messaging::SpikeMessage>(
+        make_projection_weights_writer_function(writer, async_writer, logging_period, model_executor, uid), {}, 0,
+        [writer, async_writer]
+        {
+            if (async_writer) async_writer->stop();
+            writer->flush();
+        });
+}
+
+
+void add_spikes_writer(
+    knp::framework::ModelExecutor &model_executor, const std::vector<knp::core::UID> &senders,
+    std::shared_ptr<knp::framework::io::storage::native::SpikeMessageWriter> writer, size_t queue_size)
+{
+    model_executor.add_observer<knp::core::messaging::SpikeMessage>(
+        [writer = std::move(writer)](const std::vector<knp::core::messaging::SpikeMessage> &messages)
+        { writer->write(messages.begin(), messages.end()); },
+        senders, queue_size);
+}
+
+
 void add_spikes_logger(
     knp::framework::ModelExecutor &model_executor, const std::map<knp::core::UID, std::string> &senders_names,
-    std::ostream &log_stream)
+    std::ostream &log_stream, size_t queue_size)
 {
     std::vector<knp::core::UID> all_senders_uids(senders_names.size());
     std::transform(
         senders_names.begin(), senders_names.end(), all_senders_uids.begin(),
         [](std::pair<knp::core::UID, std::string> const &sender) -> knp::core::UID { return sender.first; });
     model_executor.add_observer<knp::core::messaging::SpikeMessage>(
-        make_spikes_observer_function(log_stream, senders_names), all_senders_uids);
+        make_spikes_observer_function(log_stream, senders_names), all_senders_uids, queue_size);
+}
+
+
+void add_spikes_recorder(
+    knp::framework::ModelExecutor &model_executor, const std::vector<knp::core::UID> &senders,
+    std::vector<SpikeRecord> &records, size_t queue_size)
+{
+    model_executor.add_observer<knp::core::messaging::SpikeMessage>(
+        [&records](const std::vector<knp::core::messaging::SpikeMessage> &messages)
+        {
+            for (const auto &msg : messages)
+            {
+                records.push_back({msg.header_, knp::core::messaging::CompactSpikeData(msg.neuron_indexes_)});
+            }
+        },
+        senders, queue_size);
 }
 
 
@@ -21,33 +21,92 @@
 
 #include <knp/framework/io/output_channel.h>
 
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
 namespace knp::framework::io::output
 {
-auto comp_lower(const core::messaging::SpikeMessage &message, core::Step step)
+
+namespace
+{
+
+template <class Slots>
+auto lower_slot(Slots &slots, core::Step step)
 {
-    return message.header_.send_time_ < step;
+    return std::lower_bound(
+        slots.begin(), slots.end(), step, [](const auto &slot, core::Step value) { return slot.step_ < value; });
 }
 
 
-auto comp_upper(core::Step step, const core::messaging::SpikeMessage &message)
+template <class Slots>
+auto upper_slot(Slots &slots, core::Step step)
 {
-    return step < message.header_.send_time_;
+    return std::upper_bound(
+        slots.begin(), slots.end(), step, [](core::Step value, const auto &slot) { return value < slot.step_; });
 }
 
+}  // namespace
+
 
-std::vector<core::messaging::SpikeMessage> OutputChannel::update()
+size_t OutputChannel::update()
 {
     endpoint_.receive_all_messages();
     auto messages = endpoint_.unload_messages<core::messaging::SpikeMessage>(base_.uid_);
 
-    message_buffer_.reserve(message_buffer_.size() + messages.size());
-    for (auto &&message : messages)
+    for (auto &message : messages) add_message(std::move(message));
+
+    return messages.size();
+}
+
+
+void OutputChannel::add_message(core::messaging::SpikeMessage &&message)
+{
+    const core::Step step = message.header_.send_time_;
+    if (step < first_step_)
+    {
+        SPDLOG_TRACE("Output channel dropped a message of step {}, which is out of the buffer.", step);
+        return;
+    }
+
+    if (step >= end_step_)
     {
-        // cppcheck-suppress useStlAlgorithm
-        message_buffer_.push_back(std::move(message));
+        end_step_ = step + 1;
+        apply_retention();
     }
 
-    return message_buffer_;
+    // Messages usually arrive in the order of steps, so the slot is the last one.
+    if (slots_.empty() || slots_.back().step_ < step)
+    {
+        slots_.push_back(StepSlot{step, {}});
+        slots_.back().messages_.push_back(std::move(message));
+        return;
+    }
+
+    auto slot = lower_slot(slots_, step);
+    if (slot->step_ != step) slot = slots_.insert(slot, StepSlot{step, {}});
+    slot->messages_.push_back(std::move(message));
+}
+
+
+void OutputChannel::set_retention_steps(size_t retention_steps)
+{
+    retention_steps_ = retention_steps;
+    apply_retention();
+}
+
+
+void OutputChannel::apply_retention()
+{
+    // Older steps leave the retention window.
+    if (retention_steps_ == unlimited_retention || end_step_ - first_step_ <= retention_steps_) return;
+
+    first_step_ = end_step_ - retention_steps_;
+    while (!slots_.empty() && slots_.front().step_ < first_step_) slots_.pop_front();
 }
 
 
@@ -55,14 +114,43 @@ std::vector<core::messaging::SpikeMessage> OutputChannel::read_some_from_buffer(
     core::Step starting_step, core::Step final_step)
 {
     std::vector<core::messaging::SpikeMessage> result;
+    if (starting_step > final_step) return result;
+
+    const auto first = lower_slot(slots_, starting_step);
+    const auto last = upper_slot(slots_, final_step);
+    for (auto slot = first; slot != last; ++slot)
+        std::move(slot->messages_.begin(), slot->messages_.end(), std::back_inserter(result));
+    slots_.erase(first, last);
+
+    // Read steps at the beginning of the buffer are released.
+    if (end_step_ > 0)
+    {
+        core::Step released_end = std::min(final_step, end_step_ - 1) + 1;
+        if (!slots_.empty()) released_end = std::min(released_end, slots_.front().step_);
+        first_step_ = std::max(first_step_, released_end);
+    }
+
+    return result;
+}
+
 
-    result.reserve(starting_step + final_step + 1);
-    // Here we assume that buffer is sorted.
-    auto begin_iter = std::lower_bound(message_buffer_.begin(), message_buffer_.end(), starting_step, comp_lower);
-    auto end_iter = std::upper_bound(message_buffer_.begin(), message_buffer_.end(), final_step, comp_upper);
+const std::vector<core::messaging::SpikeMessage> &OutputChannel::get_step_messages(core::Step step) const
+{
+    static const std::vector<core::messaging::SpikeMessage> empty_messages;
+    const auto slot = lower_slot(slots_, step);
+    return slot != slots_.end() && slot->step_ == step ? slot->messages_ : empty_messages;
+}
+
+
+std::vector<std::reference_wrapper<const core::messaging::SpikeMessage>> OutputChannel::get_messages(
+    core::Step starting_step, core::Step final_step) const
+{
+    std::vector<std::reference_wrapper<const core::messaging::SpikeMessage>> result;
+    if (starting_step > final_step) return result;
 
-    std::move(begin_iter, end_iter, std::back_inserter(result));
-    message_buffer_.erase(begin_iter, end_iter);
+    const auto last = upper_slot(slots_, final_step);
+    for (auto slot = lower_slot(slots_, starting_step); slot != last; ++slot)
+        result.insert(result.end(), slot->messages_.begin(), slot->messages_.end());
     return result;
 }
 
@@ -0,0 +1,154 @@
+/**
+ * @file prefetching_generator.cpp
+ * @brief Generator wrapper that prefetches input spikes in a background thread.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knp/framework/io/in_converters/prefetching_generator.h>
+
+#include <knp/framework/spsc_queue.h>
+
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+
+namespace knp::framework::io::input
+{
+
+struct PrefetchingGenerator::Impl
+{
+    struct Slot
+    {
+        core::Step step_ = 0;
+        core::messaging::SpikeData spikes_;
+    };
+
+    Impl(DataGenerator generator, size_t prefetch_steps) : generator_(std::move(generator)), slots_(prefetch_steps) {}
+
+    ~Impl() { stop(); }
+
+    core::messaging::SpikeData get(core::Step step)
+    {
+        // Steps before the next step were already read, steps far ahead are faster to generate again.
+        if (!thread_.joinable() || step < next_step_ || step - next_step_ >= slots_.capacity())
+        {
+            stop();
+            auto spikes = generator_(step);
+            start(step + 1);
+            return spikes;
+        }
+
+        next_step_ = step + 1;
+        bool is_stalled = false;
+        while (true)
+        {
+            Slot slot;
+            if (!slots_.try_pop(slot))
+            {
+                if (!is_stalled)
+                {
+                    stalls_count_.fetch_add(1, std::memory_order_relaxed);
+                    is_stalled = true;
+                }
+                if (!slots_.pop(slot, [this] { return is_failed_.load(std::memory_order_acquire); }))
+                {
+                    const auto error = error_;
+                    stop();
+                    std::rethrow_exception(error);
+                }
+            }
+
+            // Spikes of skipped steps are dropped.
+            if (slot.step_ == step) return std::move(slot.spikes_);
+        }
+    }
+
+    void run(core::Step step)
+    {
+        while (!is_stopped_.load(std::memory_order_relaxed))
+        {
+            Slot slot;
+            try
+            {
+                slot.spikes_ = generator_(step);
+            }
+            catch (...)
+            {
+                error_ = std::current_exception();
+                is_failed_.store(true, std::memory_order_release);
+                slots_.notify();
+                return;
+            }
+            slot.step_ = step++;
+            if (!slots_.push(std::move(slot), [this] { return is_stopped_.load(std::memory_order_relaxed); })) return;
+        }
+    }
+
+    void start(core::Step first_step)
+    {
+        next_step_ = first_step;
+        thread_ = std::thread([this, first_step] { run(first_step); });
+    }
+
+    void stop()
+    {
+        if (!thread_.joinable()) return;
+
+        is_stopped_.store(true, std::memory_order_relaxed);
+        slots_.notify();
+        thread_.join();
+
+        is_stopped_.store(false, std::memory_order_relaxed);
+        is_failed_.store(false, std::memory_order_relaxed);
+        error_ = nullptr;
+        slots_.clear();
+    }
+
+    DataGenerator generator_;
+    SpscQueue<Slot> slots_;
+    std::atomic<bool> is_stopped_ = false;
+    std::atomic<bool> is_failed_ = false;
+    std::exception_ptr error_;
+    std::atomic<size_t> stalls_count_ = 0;
+    core::Step next_step_ = 0;
+    std::thread thread_;
+};
+
+
+PrefetchingGenerator::PrefetchingGenerator(DataGenerator generator, size_t prefetch_steps)
+{
+    if (!prefetch_steps) throw std::invalid_argument("Number of prefetched steps must be positive.");
+    impl_ = std::make_shared<Impl>(std::move(generator), prefetch_steps);
+}
+
+
+core::messaging::SpikeData PrefetchingGenerator::operator()(core::Step step) const
+{
+    return impl_->get(step);
+}
+
+
+size_t PrefetchingGenerator::get_stalls_count() const
+{
+    return impl_->stalls_count_.load(std::memory_order_relaxed);
+}
+
+}  // namespace knp::framework::io::input
@@ -30,19 +30,18 @@ namespace knp::framework::projection
 
 std::vector<knp::core::UID> add_wta_handlers(
     knp::framework::ModelExecutor& executor, size_t winners_amount, std::vector<size_t> const& borders,
-    std::vector<std::pair<std::vector<knp::core::UID>, std::vector<knp::core::UID>>> const& wta_data)
+    std::vector<std::pair<std::vector<knp::core::UID>, std::vector<knp::core::UID>>> const& wta_data, int seed)
 {
     std::vector<knp::core::UID> result;
 
-    // Generating seed for WTA randomness
-    std::mt19937 rand_gen(std::random_device{}());
-    std::uniform_int_distribution<int> distr(-std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
-
-    for (const auto& senders_receivers : wta_data)
+    for (size_t handler_index = 0; handler_index < wta_data.size(); ++handler_index)
     {
+        const auto& senders_receivers = wta_data[handler_index];
         knp::core::UID handler_uid;
+        // Handler UIDs are random, so handlers are keyed by their indexes to get reproducible selection.
+        const auto handler_seed = static_cast<int>(static_cast<unsigned>(seed) + handler_index);
         executor.add_spike_message_handler(
-            knp::framework::modifier::KWtaPerGroup{borders, winners_amount, distr(rand_gen)}, senders_receivers.first,
+            knp::framework::modifier::KWtaPerGroup{borders, winners_amount, handler_seed}, senders_receivers.first,
             senders_receivers.second, handler_uid);
         result.push_back(handler_uid);
     }
@@ -19,12 +19,18 @@
  * limitations under the License.
  */
 
-#include <knp/framework/io/storage/native/data_storage_json.h>
+#include <knp/framework/io/storage/native/data_storage_hdf5.h>
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include "../../sonata/highfive.h"
 #include "data_storage_common.h"
@@ -80,13 +86,22 @@ void check_format(const HighFive::File &h5_file, bool is_throw)
 }
 
 
-KNP_DECLSPEC std::vector<core::messaging::SpikeMessage> load_messages_from_h5(
-    const fs::path &path_to_h5, const knp::core::UID &uid, float time_per_step, bool strict_format)
+namespace
 {
-    HighFive::File h5_file(path_to_h5.string());
 
-    check_format(h5_file, strict_format);
+// Number of elements in an HDF5 chunk of an extendable dataset.
+constexpr size_t dataset_chunk_size = 16384;
+
+
+struct SpikeDatasets
+{
+    HighFive::DataSet nodes_;
+    HighFive::DataSet timestamps_;
+};
+
 
+SpikeDatasets find_spike_datasets(const HighFive::File &h5_file, const fs::path &path_to_h5)
+{
     // File should have "spikes" group.
     std::vector<std::string> obj_names = h5_file.listObjectNames();
     if (std::find(obj_names.begin(), obj_names.end(), std::string("spikes")) == obj_names.end())
@@ -113,27 +128,17 @@ KNP_DECLSPEC std::vector<core::messaging::SpikeMessage> load_messages_from_h5(
     if (std::find(obj_names.begin(), obj_names.end(), std::string("timestamps")) == obj_names.end())
         throw std::runtime_error(R"--(Could not find "timestamps" dataset in data file.)--");
 
-    // Loading datasets.
-    const auto node_dataset = data_group.getDataSet(node_name);
-    const auto timestamps_dataset = data_group.getDataSet("timestamps");
+    SpikeDatasets datasets{data_group.getDataSet(node_name), data_group.getDataSet("timestamps")};
 
     // They must have the same size.
-    if (timestamps_dataset.getElementCount() != node_dataset.getElementCount())
+    if (datasets.timestamps_.getElementCount() != datasets.nodes_.getElementCount())
         throw std::runtime_error("Different number of elements in node and timestamp datasets.");
 
-    // Reading data from datasets to vectors.
-    std::vector<float> timestamps(timestamps_dataset.getElementCount());
-    timestamps_dataset.read(timestamps);
-    std::vector<int64_t> nodes(node_dataset.getElementCount());
-    node_dataset.read(nodes);
-
-    return convert_node_time_arrays_to_messages(nodes, timestamps, uid, time_per_step);
+    return datasets;
 }
 
 
-KNP_DECLSPEC void save_messages_to_h5(
-    const std::vector<core::messaging::SpikeMessage> &messages, const std::filesystem::path &path_to_save,
-    float time_per_step)
+HighFive::File create_spike_file(const fs::path &path_to_save)
 {
     HighFive::File data_file(path_to_save.string(), HighFive::File::Create | HighFive::File::Overwrite);
 
@@ -143,38 +148,284 @@ KNP_DECLSPEC void save_messages_to_h5(
     auto spike_group = data_file.createGroup("spikes");
     spike_group.createAttribute("sorting", std::string{"by_timestamps"});
 
-    // Calculating total number of spikes.
-    auto add_size = [](size_t sum, const auto &msg) { return sum + msg.neuron_indexes_.size(); };
-    size_t total_size = std::accumulate(messages.begin(), messages.end(), size_t{0}, add_size);
+    return data_file;
+}
+
+
+template <class ValueType>
+HighFive::DataSet create_extendable_dataset(
+    const HighFive::File &data_file, const std::string &name, unsigned compression_level)
+{
+    const HighFive::DataSpace space(std::vector<size_t>{0}, std::vector<size_t>{HighFive::DataSpace::UNLIMITED});
+    HighFive::DataSetCreateProps props;
+    props.add(HighFive::Chunking(std::vector<hsize_t>{dataset_chunk_size}));
+    if (compression_level) props.add(HighFive::Deflate(compression_level));
+    return data_file.getGroup("spikes").createDataSet<ValueType>(name, space, props);
+}
 
-    // Reserving dataset vectors.
-    std::vector<float> timestamps;
-    std::vector<int64_t> nodes;
-    timestamps.reserve(total_size);
-    nodes.reserve(total_size);
+}  // namespace
 
-    std::vector<core::messaging::SpikeMessage> sorted_messages(messages.size());
 
+KNP_DECLSPEC std::vector<core::messaging::SpikeMessage> load_messages_from_h5(
+    const fs::path &path_to_h5, const knp::core::UID &uid, float time_per_step, bool strict_format)
+{
+    HighFive::File h5_file(path_to_h5.string());
+
+    check_format(h5_file, strict_format);
+
+    // Loading datasets.
+    const auto datasets = find_spike_datasets(h5_file, path_to_h5);
+
+    // Reading data from datasets to vectors.
+    std::vector<float> timestamps(datasets.timestamps_.getElementCount());
+    datasets.timestamps_.read(timestamps);
+    std::vector<int64_t> nodes(datasets.nodes_.getElementCount());
+    datasets.nodes_.read(nodes);
+
+    return convert_node_time_arrays_to_messages(nodes, timestamps, uid, time_per_step);
+}
+
+
+KNP_DECLSPEC void save_messages_to_h5(
+    const std::vector<core::messaging::SpikeMessage> &messages, const std::filesystem::path &path_to_save,
+    float time_per_step)
+{
     // Sorting messages by step.
     // Dataset is sorted by timestamp.
-    partial_sort_copy(
-        messages.begin(), messages.end(), sorted_messages.begin(), sorted_messages.end(),
+    std::vector<core::messaging::SpikeMessage> sorted_messages(messages);
+    std::stable_sort(
+        sorted_messages.begin(), sorted_messages.end(),
         [](const core::messaging::SpikeMessage &msg1, const core::messaging::SpikeMessage &msg2)
         { return msg1.header_.send_time_ < msg2.header_.send_time_; });
 
-    // Forming dataset vectors.
-    for (const auto &msg : sorted_messages)
+    // All messages are already in memory, so they are written at once.
+    H5SpikeMessageWriter writer(path_to_save, time_per_step, std::numeric_limits<size_t>::max());
+    writer.write(sorted_messages.begin(), sorted_messages.end());
+    writer.flush();
+}
+
+
+struct H5SpikeMessageWriter::Impl
+{
+    Impl(const fs::path &path_to_save, float time_per_step, size_t flush_steps, unsigned compression_level)
+        : data_file_(create_spike_file(path_to_save)),
+          nodes_(create_extendable_dataset<int64_t>(data_file_, "node_ids", compression_level)),
+          timestamps_(create_extendable_dataset<float>(data_file_, "timestamps", compression_level)),
+          time_per_step_(time_per_step),
+          flush_steps_(std::max<size_t>(flush_steps, 1))
     {
-        const std::vector<float> values(
-            msg.neuron_indexes_.size(), static_cast<float>(msg.header_.send_time_) * time_per_step);
-        timestamps.insert(timestamps.end(), values.begin(), values.end());
-        nodes.insert(nodes.end(), msg.neuron_indexes_.begin(), msg.neuron_indexes_.end());
+        timestamps_.createAttribute("units", std::string{"step"});
     }
 
-    // Creating datasets.
-    spike_group.createDataSet("node_ids", nodes);
-    auto time_set = spike_group.createDataSet("timestamps", timestamps);
-    time_set.createAttribute("units", std::string{"step"});
+    void write(const core::messaging::SpikeMessage &message)
+    {
+        const core::Step step = message.header_.send_time_;
+        if (last_step_ && step < *last_step_)
+        {
+            throw std::invalid_argument(
+                "Message of step " + std::to_string(step) + " is written after step " + std::to_string(*last_step_) +
+                ".");
+        }
+        if (!last_step_ || step != *last_step_) ++buffered_steps_;
+        last_step_ = step;
+
+        timestamps_buffer_.insert(
+            timestamps_buffer_.end(), message.neuron_indexes_.size(), static_cast<float>(step) * time_per_step_);
+        nodes_buffer_.insert(nodes_buffer_.end(), message.neuron_indexes_.begin(), message.neuron_indexes_.end());
+
+        if (buffered_steps_ >= flush_steps_) flush();
+    }
+
+    void flush()
+    {
+        buffered_steps_ = 0;
+        if (nodes_buffer_.empty()) return;
+
+        // Extending datasets and writing the buffer to the added part.
+        const size_t new_size = written_count_ + nodes_buffer_.size();
+        nodes_.resize({new_size});
+        timestamps_.resize({new_size});
+        nodes_.select({written_count_}, {nodes_buffer_.size()}).write(nodes_buffer_);
+        timestamps_.select({written_count_}, {timestamps_buffer_.size()}).write(timestamps_buffer_);
+        written_count_ = new_size;
+
+        nodes_buffer_.clear();
+        timestamps_buffer_.clear();
+        data_file_.flush();
+    }
+
+    HighFive::File data_file_;
+    HighFive::DataSet nodes_;
+    HighFive::DataSet timestamps_;
+    float time_per_step_;
+    size_t flush_steps_;
+
+    std::vector<int64_t> nodes_buffer_;
+    std::vector<float> timestamps_buffer_;
+    size_t buffered_steps_ = 0;
+    size_t written_count_ = 0;
+    std::optional<core::Step> last_step_;
+};
+
+
+H5SpikeMessageWriter::H5SpikeMessageWriter(
+    const fs::path &path_to_save, float time_per_step, size_t flush_steps, unsigned compression_level)
+    : impl_(std::make_unique<Impl>(path_to_save, time_per_step, flush_steps, compression_level))
+{
+}
+
+
+H5SpikeMessageWriter::~H5SpikeMessageWriter()
+{
+    try
+    {
+        impl_->flush();
+    }
+    catch (const std::exception &e)
+    {
+        SPDLOG_ERROR("Unable to write spikes to HDF5 file: {}.", e.what());
+    }
+}
+
+
+void H5SpikeMessageWriter::write(const core::messaging::SpikeMessage &message)
+{
+    impl_->write(message);
+}
+
+
+void H5SpikeMessageWriter::flush()
+{
+    impl_->flush();
+}
+
+
+struct H5SpikeMessageReader::Impl
+{
+    Impl(
+        const fs::path &path_to_h5, const knp::core::UID &uid, float time_per_step, bool strict_format,
+        size_t chunk_size)
+        : h5_file_(path_to_h5.string()),
+          datasets_(find_spike_datasets(h5_file_, path_to_h5)),
+          uid_(uid),
+          time_per_step_(time_per_step),
+          chunk_size_(std::max<size_t>(chunk_size, 1)),
+          spikes_count_(datasets_.nodes_.getElementCount())
+    {
+        check_format(h5_file_, strict_format);
+
+        // Messages are formed from consecutive spikes, that is possible only for sorted files.
+        const auto spike_group = h5_file_.getGroup("spikes");
+        if (!spike_group.hasAttribute("sorting"))
+        {
+            if (strict_format) throw std::runtime_error(R"--(No "sorting" attribute in "spikes" group.)--");
+            SPDLOG_WARN("Unable to confirm that spikes are sorted by timestamps.");
+        }
+        else if (spike_group.getAttribute("sorting").read<std::string>() != "by_timestamps")
+            throw std::runtime_error("Spikes are not sorted by timestamps, use load_messages_from_h5() instead.");
+    }
+
+    core::Step get_step(float timestamp) const { return static_cast<core::Step>(timestamp / time_per_step_); }
+
+    bool is_loaded(size_t position) const
+    {
+        return position >= chunk_begin_ && position < chunk_begin_ + nodes_chunk_.size();
+    }
+
+    void load_chunk(size_t position)
+    {
+        const size_t count = std::min(chunk_size_, spikes_count_ - position);
+        nodes_chunk_.resize(count);
+        timestamps_chunk_.resize(count);
+        datasets_.nodes_.select({position}, {count}).read(nodes_chunk_);
+        datasets_.timestamps_.select({position}, {count}).read(timestamps_chunk_);
+        chunk_begin_ = position;
+    }
+
+    core::Step read_step(size_t position) const
+    {
+        if (is_loaded(position)) return get_step(timestamps_chunk_[position - chunk_begin_]);
+        std::vector<float> timestamp(1);
+        datasets_.timestamps_.select({position}, {1}).read(timestamp);
+        return get_step(timestamp.front());
+    }
+
+    std::optional<core::messaging::SpikeMessage> read_message()
+    {
+        if (position_ >= spikes_count_) return std::nullopt;
+        if (!is_loaded(position_)) load_chunk(position_);
+
+        const core::Step step = get_step(timestamps_chunk_[position_ - chunk_begin_]);
+        if (last_step_ && step <= *last_step_) throw std::runtime_error("Spikes in file are not sorted by timestamps.");
+        last_step_ = step;
+
+        core::messaging::SpikeMessage message{{uid_, step}, {}};
+        while (position_ < spikes_count_)
+        {
+            if (!is_loaded(position_)) load_chunk(position_);
+            const size_t index = position_ - chunk_begin_;
+            if (get_step(timestamps_chunk_[index]) != step) break;
+            message.neuron_indexes_.push_back(static_cast<core::messaging::SpikeIndex>(nodes_chunk_[index]));
+            ++position_;
+        }
+        return message;
+    }
+
+    void seek_message(core::Step step)
+    {
+        // Binary search of the first spike with the given or a later step.
+        size_t first = 0;
+        size_t count = spikes_count_;
+        while (count > 0)
+        {
+            const size_t half = count / 2;
+            if (read_step(first + half) < step)
+            {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else
+                count = half;
+        }
+        position_ = first;
+        last_step_.reset();
+    }
+
+    HighFive::File h5_file_;
+    SpikeDatasets datasets_;
+    core::UID uid_;
+    float time_per_step_;
+    size_t chunk_size_;
+    size_t spikes_count_;
+
+    size_t position_ = 0;
+    size_t chunk_begin_ = 0;
+    std::vector<int64_t> nodes_chunk_;
+    std::vector<float> timestamps_chunk_;
+    std::optional<core::Step> last_step_;
+};
+
+
+H5SpikeMessageReader::H5SpikeMessageReader(
+    const fs::path &path_to_h5, const knp::core::UID &uid, float time_per_step, bool strict_format,
+    size_t chunk_size)
+    : impl_(std::make_unique<Impl>(path_to_h5, uid, time_per_step, strict_format, chunk_size))
+{
+}
+
+
+H5SpikeMessageReader::~H5SpikeMessageReader() = default;
+
+
+std::optional<core::messaging::SpikeMessage> H5SpikeMessageReader::read_message()
+{
+    return impl_->read_message();
+}
+
+
+void H5SpikeMessageReader::seek_message(core::Step step)
+{
+    impl_->seek_message(step);
 }
 
 }  // namespace knp::framework::io::storage::native
@@ -23,17 +23,23 @@
 
 #include <rapidjson/document.h>
 #include <rapidjson/istreamwrapper.h>
+#include <rapidjson/reader.h>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <filesystem>
 #include <fstream>
+#include <initializer_list>
 #include <istream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
-#include <boost/format.hpp>
-
 #include "data_storage_common.h"
 
 
@@ -82,19 +88,17 @@ constexpr char spike_attributes[] =
 ])--";
 
 
-constexpr char node_structure[] =
+constexpr char node_structure_begin[] =
     R"--("node_ids": {
-  "shape": [%d],
   "type": {
     "class": "Integer (unsigned)",
     "size": 64,
     "endianness": "little-endian"
   },
-  "value": [%s]
-})--";
+  "value": [)--";
 
 
-constexpr char timestamp_structure[] =
+constexpr char timestamp_structure_begin[] =
     R"--("timestamps": {
   "attributes": [
     {
@@ -106,27 +110,15 @@ constexpr char timestamp_structure[] =
       "value": "step"
     }
   ],
-  "shape": [%d],
   "type": {
     "class": "Float",
     "endianness": "little-endian"
   },
-  "value": [%s]
-})--";
+  "value": [)--";
 
 
-constexpr char whole_file_string[] =
-    R"--(
-{
-    %s,
-    "spikes" :
-        {
-            %s,
-            %s,
-            %s
-        }
-    }
-)--";
+// Size of text buffers of streaming readers and writers.
+constexpr size_t stream_buffer_size = 65536;
 
 
 // clang-format off // No const operator[] for simdjson document, so no const parameter.
@@ -274,39 +266,495 @@ KNP_DECLSPEC std::vector<core::messaging::SpikeMessage> load_messages_from_json(
 KNP_DECLSPEC void save_messages_to_json(
     const std::vector<core::messaging::SpikeMessage> &messages, const std::filesystem::path &path_to_save)
 {
-    boost::format format_nodes(node_structure);
-    boost::format format_times(timestamp_structure);
-    boost::format format_file(whole_file_string);
-    std::ostringstream node_stream;
-    std::ostringstream time_stream;
-    std::vector<core::messaging::SpikeMessage> sorted_messages(messages.size());
-
-    partial_sort_copy(
-        messages.begin(), messages.end(), sorted_messages.begin(), sorted_messages.end(),
+    std::vector<core::messaging::SpikeMessage> sorted_messages(messages);
+    std::stable_sort(
+        sorted_messages.begin(), sorted_messages.end(),
         [](const auto &msg1, const auto &msg2) { return msg1.header_.send_time_ < msg2.header_.send_time_; });
 
-    size_t count = 0;
-    for (const auto &msg : sorted_messages)
+    JsonSpikeMessageWriter writer(path_to_save);
+    writer.write(sorted_messages.begin(), sorted_messages.end());
+    writer.close();
+}
+
+
+struct JsonSpikeMessageWriter::Impl
+{
+    // Removes the temporary file when the writer is destroyed, also if the constructor or `close()` throws.
+    struct TemporaryFileGuard
+    {
+        ~TemporaryFileGuard()
+        {
+            std::error_code error;
+            fs::remove(path_, error);
+        }
+
+        fs::path path_;
+    };
+
+    explicit Impl(const fs::path &path_to_save)
+        : timestamps_path_{fs::path(path_to_save).concat(".timestamps")},
+          out_file_(path_to_save, std::ios::out | std::ios::binary | std::ios::trunc),
+          timestamps_file_(timestamps_path_.path_, std::ios::out | std::ios::binary | std::ios::trunc)
+    {
+        if (!out_file_ || !timestamps_file_)
+            throw std::runtime_error("Unable to open file \"" + path_to_save.string() + "\" for writing.");
+
+        out_file_ << "{\n    " << header_string << ",\n    \"spikes\" :\n        {\n            " << spike_attributes
+                  << ",\n            " << node_structure_begin;
+    }
+
+    static void append_value(std::string &text, uint64_t value, bool is_first)
+    {
+        std::array<char, 24> digits;
+        const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+        if (!is_first) text += ", ";
+        text.append(digits.data(), result.ptr);
+    }
+
+    void write(const core::messaging::SpikeMessage &message)
+    {
+        if (is_closed_) throw std::logic_error("Unable to write a message: the writer is closed.");
+
+        const core::Step step = message.header_.send_time_;
+        if (last_step_ && step < *last_step_)
+        {
+            throw std::invalid_argument(
+                "Message of step " + std::to_string(step) + " is written after step " + std::to_string(*last_step_) +
+                ".");
+        }
+        last_step_ = step;
+
+        for (const auto index : message.neuron_indexes_)
+        {
+            append_value(nodes_text_, index, 0 == spikes_count_);
+            append_value(timestamps_text_, step, 0 == spikes_count_);
+            ++spikes_count_;
+        }
+        if (nodes_text_.size() >= stream_buffer_size || timestamps_text_.size() >= stream_buffer_size) write_text();
+    }
+
+    void write_text()
+    {
+        out_file_.write(nodes_text_.data(), static_cast<std::streamsize>(nodes_text_.size()));
+        timestamps_file_.write(timestamps_text_.data(), static_cast<std::streamsize>(timestamps_text_.size()));
+        nodes_text_.clear();
+        timestamps_text_.clear();
+        if (!out_file_ || !timestamps_file_) throw std::runtime_error("Unable to write spikes to JSON file.");
+    }
+
+    void flush()
+    {
+        if (is_closed_) return;
+        write_text();
+        out_file_.flush();
+        timestamps_file_.flush();
+    }
+
+    void close()
+    {
+        if (is_closed_) return;
+        is_closed_ = true;
+        write_text();
+        timestamps_file_.close();
+
+        // Array shapes are written after values, because the number of values is known only at the end.
+        out_file_ << "],\n  \"shape\": [" << spikes_count_ << "]\n},\n            " << timestamp_structure_begin;
+        if (spikes_count_ > 0)
+        {
+            std::ifstream timestamps_file(timestamps_path_.path_, std::ios::in | std::ios::binary);
+            out_file_ << timestamps_file.rdbuf();
+        }
+        out_file_ << "],\n  \"shape\": [" << spikes_count_ << "]\n}\n        }\n}\n";
+        out_file_.close();
+        fs::remove(timestamps_path_.path_);
+
+        if (!out_file_) throw std::runtime_error("Unable to complete JSON file.");
+    }
+
+    // Declared before the file stream, so that the file is closed before removal.
+    TemporaryFileGuard timestamps_path_;
+    std::ofstream out_file_;
+    std::ofstream timestamps_file_;
+    std::string nodes_text_;
+    std::string timestamps_text_;
+    size_t spikes_count_ = 0;
+    std::optional<core::Step> last_step_;
+    bool is_closed_ = false;
+};
+
+
+JsonSpikeMessageWriter::JsonSpikeMessageWriter(const fs::path &path_to_save)
+    : impl_(std::make_unique<Impl>(path_to_save))
+{
+}
+
+
+JsonSpikeMessageWriter::~JsonSpikeMessageWriter()
+{
+    try
+    {
+        impl_->close();
+    }
+    catch (const std::exception &e)
+    {
+        SPDLOG_ERROR("Unable to complete JSON file: {}.", e.what());
+    }
+}
+
+
+void JsonSpikeMessageWriter::write(const core::messaging::SpikeMessage &message)
+{
+    impl_->write(message);
+}
+
+
+void JsonSpikeMessageWriter::flush()
+{
+    impl_->flush();
+}
+
+
+void JsonSpikeMessageWriter::close()
+{
+    impl_->close();
+}
+
+
+namespace
+{
+
+/**
+ * @brief SAX handler that finds spike arrays and checks file attributes without building a document.
+ */
+class SpikeArrayLocator : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, SpikeArrayLocator>
+{
+public:
+    explicit SpikeArrayLocator(const rapidjson::IStreamWrapper &stream) : stream_(stream) {}
+
+    bool Key(const char *str, rapidjson::SizeType length, bool)
+    {
+        key_.assign(str, length);
+        return true;
+    }
+
+    bool String(const char *str, rapidjson::SizeType length, bool)
+    {
+        if ("name" == key_ && (is_in({"attributes", "[]"}) || is_in({"spikes", "attributes", "[]"})))
+            attribute_name_.assign(str, length);
+        else if ("value" == key_ && "sorting" == attribute_name_ && is_in({"spikes", "attributes", "[]"}))
+            sorting_.assign(str, length);
+        key_.clear();
+        return true;
+    }
+
+    bool Int(int value) { return add_integer(value); }
+    bool Uint(unsigned value) { return add_integer(value); }
+    bool Int64(int64_t value) { return add_integer(value); }
+    bool Uint64(uint64_t value) { return add_integer(static_cast<int64_t>(value)); }
+
+    bool Default()
+    {
+        key_.clear();
+        return true;
+    }
+
+    bool StartObject()
+    {
+        if (is_in({"attributes"}) || is_in({"spikes", "attributes"})) attribute_name_.clear();
+        push(false);
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType)
+    {
+        pop();
+        return true;
+    }
+
+    bool StartArray()
+    {
+        if ("value" == key_)
+        {
+            // Stream position is just after the opening bracket.
+            if (is_in({"spikes", "node_ids"}))
+                nodes_offset_ = static_cast<std::streamoff>(stream_.Tell()) - 1;
+            else if (is_in({"spikes", "timestamps"}))
+                timestamps_offset_ = static_cast<std::streamoff>(stream_.Tell()) - 1;
+            else if ("version" == attribute_name_ && is_in({"attributes", "[]"}))
+                is_version_ = true;
+        }
+        push(true);
+        // Spike arrays are the largest part of the file, parsing stops when both are found.
+        return !nodes_offset_ || !timestamps_offset_;
+    }
+
+    bool EndArray(rapidjson::SizeType)
+    {
+        is_version_ = false;
+        pop();
+        return true;
+    }
+
+public:
+    std::optional<std::streamoff> nodes_offset_;
+    std::optional<std::streamoff> timestamps_offset_;
+    std::optional<int64_t> magic_;
+    std::vector<int64_t> version_;
+    std::string sorting_;
+
+private:
+    bool is_in(std::initializer_list<const char *> path) const
+    {
+        // The first frame is the root object.
+        return path_.size() == path.size() + 1 && std::equal(path.begin(), path.end(), path_.begin() + 1);
+    }
+
+    bool add_integer(int64_t value)
+    {
+        if (is_version_)
+            version_.push_back(value);
+        else if ("value" == key_ && "magic" == attribute_name_ && is_in({"attributes", "[]"}))
+            magic_ = value;
+        key_.clear();
+        return true;
+    }
+
+    void push(bool is_array)
+    {
+        path_.push_back(!path_.empty() && is_array_.back() ? "[]" : key_);
+        is_array_.push_back(is_array);
+        key_.clear();
+    }
+
+    void pop()
+    {
+        path_.pop_back();
+        is_array_.pop_back();
+        key_.clear();
+    }
+
+    const rapidjson::IStreamWrapper &stream_;
+    std::vector<std::string> path_;
+    std::vector<bool> is_array_;
+    std::string key_;
+    std::string attribute_name_;
+    bool is_version_ = false;
+};
+
+
+/**
+ * @brief SAX handler that receives one number of an array.
+ */
+struct NumberHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, NumberHandler>
+{
+    bool Int(int value) { return set(value); }
+    bool Uint(unsigned value) { return set(value); }
+    bool Int64(int64_t value) { return set(value); }
+    bool Uint64(uint64_t value) { return set(value); }
+    bool Double(double value) { return set(value); }
+    bool StartArray() { return true; }
+
+    bool EndArray(rapidjson::SizeType)
+    {
+        is_finished_ = true;
+        return true;
+    }
+
+    // Arrays of spikes contain only numbers.
+    bool Default() { return false; }
+
+    template <class ValueType>
+    bool set(ValueType value)
+    {
+        value_ = static_cast<double>(value);
+        has_value_ = true;
+        return true;
+    }
+
+    double value_ = 0;
+    bool has_value_ = false;
+    bool is_finished_ = false;
+};
+
+
+/**
+ * @brief Pull parser of a JSON number array.
+ */
+class NumberArrayParser
+{
+public:
+    NumberArrayParser(const fs::path &path_to_json, std::streamoff offset)
+        : file_(open_at(path_to_json, offset)),
+          buffer_(stream_buffer_size),
+          stream_(file_, buffer_.data(), buffer_.size())
+    {
+        reader_.IterativeParseInit();
+    }
+
+    std::optional<double> next()
+    {
+        handler_.has_value_ = false;
+        while (!handler_.has_value_ && !handler_.is_finished_)
+        {
+            // Each call parses one token.
+            if (!reader_.IterativeParseNext<rapidjson::kParseStopWhenDoneFlag>(stream_, handler_))
+            {
+                throw std::runtime_error(
+                    "Unable to parse spike array at offset " + std::to_string(reader_.GetErrorOffset()) + ".");
+            }
+        }
+        if (!handler_.has_value_) return std::nullopt;
+        return handler_.value_;
+    }
+
+private:
+    static std::ifstream open_at(const fs::path &path_to_json, std::streamoff offset)
+    {
+        std::ifstream file(path_to_json, std::ios::in | std::ios::binary);
+        file.seekg(offset);
+        if (!file) throw std::runtime_error("Unable to read file \"" + path_to_json.string() + "\".");
+        return file;
+    }
+
+    std::ifstream file_;
+    std::vector<char> buffer_;
+    rapidjson::IStreamWrapper stream_;
+    rapidjson::Reader reader_;
+    NumberHandler handler_;
+};
+
+}  // namespace
+
+
+struct JsonSpikeMessageReader::Impl
+{
+    Impl(const fs::path &path_to_json, const knp::core::UID &uid, bool strict_format)
+        : path_to_json_(path_to_json), uid_(uid)
+    {
+        std::ifstream json_file(path_to_json, std::ios::in | std::ios::binary);
+        if (!json_file) throw std::runtime_error("Unable to open file \"" + path_to_json.string() + "\".");
+        std::vector<char> buffer(stream_buffer_size);
+        rapidjson::IStreamWrapper stream(json_file, buffer.data(), buffer.size());
+        SpikeArrayLocator locator(stream);
+        rapidjson::Reader reader;
+        // Locator terminates parsing when spike arrays are found.
+        if (reader.Parse(stream, locator).IsError() && !(locator.nodes_offset_ && locator.timestamps_offset_))
+            throw std::runtime_error("Cannot parse file \"" + path_to_json.string() + "\".");
+
+        if (!locator.magic_ || MAGIC_NUMBER != *locator.magic_)
+        {
+            if (strict_format)
+                throw std::runtime_error("Unable to find magic number: wrong file format or version.");
+            else
+                SPDLOG_WARN("Unable to find magic number: wrong file format or version.");
+        }
+        if (!std::equal(locator.version_.begin(), locator.version_.end(), VERSION.begin(), VERSION.end()))
+            SPDLOG_WARN("Unable to verify file version.");
+
+        if (!locator.nodes_offset_) throw std::runtime_error("No \"node_ids\" array in \"spikes\" group.");
+        if (!locator.timestamps_offset_) throw std::runtime_error("No \"timestamps\" array in \"spikes\" group.");
+        if (locator.sorting_.empty())
+        {
+            if (strict_format) throw std::runtime_error(R"--(No "sorting" attribute in "spikes" group.)--");
+            SPDLOG_WARN("Unable to confirm that spikes are sorted by timestamps.");
+        }
+        else if ("by_time" != locator.sorting_)
+            throw std::runtime_error("Spikes are not sorted by timestamps, use load_messages_from_json() instead.");
+
+        nodes_offset_ = *locator.nodes_offset_;
+        timestamps_offset_ = *locator.timestamps_offset_;
+        rewind();
+    }
+
+    void rewind()
+    {
+        nodes_parser_ = std::make_unique<NumberArrayParser>(path_to_json_, nodes_offset_);
+        timestamps_parser_ = std::make_unique<NumberArrayParser>(path_to_json_, timestamps_offset_);
+        pending_spike_.reset();
+        consumed_step_.reset();
+        last_step_.reset();
+        read_spike();
+    }
+
+    void consume_spike()
+    {
+        consumed_step_ = pending_spike_->first;
+        read_spike();
+    }
+
+    void read_spike()
+    {
+        const auto node = nodes_parser_->next();
+        const auto timestamp = timestamps_parser_->next();
+        if (node.has_value() != timestamp.has_value())
+            throw std::runtime_error("Different number of elements in node and timestamp arrays.");
+
+        if (!node)
+            pending_spike_.reset();
+        else
+        {
+            pending_spike_.emplace(
+                static_cast<core::Step>(*timestamp), static_cast<core::messaging::SpikeIndex>(*node));
+        }
+    }
+
+    std::optional<core::messaging::SpikeMessage> read_message()
     {
-        for (auto index : msg.neuron_indexes_)
+        if (!pending_spike_) return std::nullopt;
+
+        const core::Step step = pending_spike_->first;
+        if (last_step_ && step <= *last_step_) throw std::runtime_error("Spikes in file are not sorted by timestamps.");
+        last_step_ = step;
+
+        core::messaging::SpikeMessage message{{uid_, step}, {}};
+        while (pending_spike_ && pending_spike_->first == step)
         {
-            node_stream << index << ", ";
-            time_stream << msg.header_.send_time_ << ", ";
-            ++count;
+            message.neuron_indexes_.push_back(pending_spike_->second);
+            consume_spike();
         }
+        return message;
     }
-    std::string node_string = node_stream.str();
-    std::string time_string = time_stream.str();
-    if (node_string.size() > 2)
+
+    void seek_message(core::Step step)
     {
-        // Removing last comma.
-        node_string.resize(node_string.size() - 2);
-        time_string.resize(time_string.size() - 2);
+        // Spikes of the step may have been consumed already.
+        if (consumed_step_ && step <= *consumed_step_) rewind();
+        while (pending_spike_ && pending_spike_->first < step) consume_spike();
+        last_step_.reset();
     }
-    std::string nodes_res = (format_nodes % count % node_string).str();
-    std::string times_res = (format_times % count % time_string).str();
-    std::string file_string = (format_file % header_string % spike_attributes % nodes_res % times_res).str();
-    std::ofstream out_file(path_to_save, std::ofstream::out);
-    out_file << file_string;
+
+    fs::path path_to_json_;
+    core::UID uid_;
+    std::streamoff nodes_offset_ = 0;
+    std::streamoff timestamps_offset_ = 0;
+    std::unique_ptr<NumberArrayParser> nodes_parser_;
+    std::unique_ptr<NumberArrayParser> timestamps_parser_;
+    // Step and node index of the next spike.
+    std::optional<std::pair<core::Step, core::messaging::SpikeIndex>> pending_spike_;
+    std::optional<core::Step> consumed_step_;
+    std::optional<core::Step> last_step_;
+};
+
+
+JsonSpikeMessageReader::JsonSpikeMessageReader(
+    const fs::path &path_to_json, const knp::core::UID &uid, bool strict_format)
+    : impl_(std::make_unique<Impl>(path_to_json, uid, strict_format))
+{
 }
+
+
+JsonSpikeMessageReader::~JsonSpikeMessageReader() = default;
+
+
+std::optional<core::messaging::SpikeMessage> JsonSpikeMessageReader::read_message()
+{
+    return impl_->read_message();
+}
+
+
+void JsonSpikeMessageReader::seek_message(core::Step step)
+{
+    impl_->seek_message(step);
+}
+
 }  // namespace knp::framework::io::storage::native
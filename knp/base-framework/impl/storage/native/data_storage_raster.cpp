@@ -0,0 +1,290 @@
+/**
+ * @file data_storage_raster.cpp
+ * @brief Saving and loading binary spike rasters.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knp/framework/io/storage/native/data_storage_raster.h>
+
+#include <spdlog/spdlog.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "data_storage_common.h"
+
+
+namespace knp::framework::io::storage::native
+{
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr uint32_t RASTER_VERSION = 2;
+
+// Number of indexes buffered by the writer.
+constexpr size_t index_buffer_size = 16384;
+
+
+struct RasterHeader
+{
+    uint32_t magic_;
+    uint32_t version_;
+    // Step of the first table entry. Steps before it have no spikes and take no space.
+    uint64_t first_step_;
+    // Number of steps in the offset table.
+    uint64_t steps_count_;
+    uint64_t spikes_count_;
+    // Offset of the step offset table from the file beginning.
+    uint64_t table_offset_;
+};
+
+static_assert(sizeof(RasterHeader) == 40, "Raster header must not have padding.");
+
+
+uint64_t get_table_offset(uint64_t spikes_count)
+{
+    // The table of 64-bit values is aligned to 8 bytes.
+    const uint64_t indexes_end = sizeof(RasterHeader) + spikes_count * sizeof(core::messaging::SpikeIndex);
+    return (indexes_end + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+}
+
+}  // namespace
+
+
+struct SpikeRaster::Impl
+{
+    explicit Impl(const fs::path &path_to_raster)
+        : file_(path_to_raster.string().c_str(), boost::interprocess::read_only),
+          region_(file_, boost::interprocess::read_only)
+    {
+        const auto *data = static_cast<const char *>(region_.get_address());
+        const size_t size = region_.get_size();
+        if (size < sizeof(RasterHeader))
+            throw std::runtime_error("File \"" + path_to_raster.string() + "\" is too small for a spike raster.");
+
+        header_ = *reinterpret_cast<const RasterHeader *>(data);
+        if (MAGIC_NUMBER != header_.magic_)
+        {
+            throw std::runtime_error(
+                "Wrong magic number \"" + std::to_string(header_.magic_) + "\". It should be \"" +
+                std::to_string(MAGIC_NUMBER) + "\".");
+        }
+        if (RASTER_VERSION != header_.version_)
+            throw std::runtime_error("Unsupported spike raster version " + std::to_string(header_.version_) + ".");
+
+        // Sizes are compared by division, so that wrong counts in the header don't overflow.
+        if (header_.spikes_count_ > (size - sizeof(RasterHeader)) / sizeof(core::messaging::SpikeIndex) ||
+            header_.table_offset_ != get_table_offset(header_.spikes_count_) || header_.table_offset_ > size ||
+            header_.steps_count_ >= (size - header_.table_offset_) / sizeof(uint64_t))
+        {
+            throw std::runtime_error("Spike raster file \"" + path_to_raster.string() + "\" is truncated.");
+        }
+        if (header_.steps_count_ > std::numeric_limits<uint64_t>::max() - header_.first_step_)
+            throw std::runtime_error("Wrong steps in spike raster file \"" + path_to_raster.string() + "\".");
+
+        indexes_ = reinterpret_cast<const core::messaging::SpikeIndex *>(data + sizeof(RasterHeader));
+        offsets_ = reinterpret_cast<const uint64_t *>(data + header_.table_offset_);
+        if (offsets_[header_.steps_count_] != header_.spikes_count_)
+            throw std::runtime_error("Wrong offset table in spike raster file \"" + path_to_raster.string() + "\".");
+    }
+
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+    RasterHeader header_{};
+    const core::messaging::SpikeIndex *indexes_ = nullptr;
+    const uint64_t *offsets_ = nullptr;
+};
+
+
+SpikeRaster::SpikeRaster(const fs::path &path_to_raster) : impl_(std::make_unique<Impl>(path_to_raster)) {}
+
+
+SpikeRaster::~SpikeRaster() = default;
+
+
+core::Step SpikeRaster::get_first_step() const
+{
+    return impl_->header_.first_step_;
+}
+
+
+size_t SpikeRaster::get_steps_count() const
+{
+    return impl_->header_.first_step_ + impl_->header_.steps_count_;
+}
+
+
+size_t SpikeRaster::get_spikes_count() const
+{
+    return impl_->header_.spikes_count_;
+}
+
+
+SpikeRaster::IndexRange SpikeRaster::get_indexes(core::Step step) const
+{
+    const auto &header = impl_->header_;
+    if (step < header.first_step_ || step - header.first_step_ >= header.steps_count_)
+        return {impl_->indexes_, impl_->indexes_};
+
+    const uint64_t begin = impl_->offsets_[step - header.first_step_];
+    const uint64_t end = impl_->offsets_[step - header.first_step_ + 1];
+    if (begin > end || end > impl_->header_.spikes_count_)
+        throw std::runtime_error("Wrong offsets of step " + std::to_string(step) + " in spike raster.");
+
+    return {impl_->indexes_ + begin, impl_->indexes_ + end};
+}
+
+
+struct RasterSpikeMessageWriter::Impl
+{
+    explicit Impl(const fs::path &path_to_save)
+        : out_file_(path_to_save, std::ios::out | std::ios::binary | std::ios::trunc)
+    {
+        if (!out_file_) throw std::runtime_error("Unable to open file \"" + path_to_save.string() + "\" for writing.");
+
+        // The header is written again when the number of spikes is known.
+        const RasterHeader header{};
+        out_file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        indexes_buffer_.reserve(index_buffer_size);
+    }
+
+    void write(const core::messaging::SpikeMessage &message)
+    {
+        if (is_closed_) throw std::logic_error("Unable to write a message: the writer is closed.");
+
+        const core::Step step = message.header_.send_time_;
+        // The table starts from the first written step, so a recording that starts late doesn't store earlier steps.
+        if (offsets_.empty()) first_step_ = step;
+        if (step + 1 < first_step_ + offsets_.size())
+        {
+            throw std::invalid_argument(
+                "Message of step " + std::to_string(step) + " is written after step " +
+                std::to_string(first_step_ + offsets_.size() - 1) + ".");
+        }
+
+        // Steps without spikes get empty ranges.
+        while (offsets_.size() <= step - first_step_) offsets_.push_back(spikes_count_);
+
+        for (const auto index : message.neuron_indexes_)
+        {
+            indexes_buffer_.push_back(index);
+            if (indexes_buffer_.size() >= index_buffer_size) write_indexes();
+        }
+        spikes_count_ += message.neuron_indexes_.size();
+    }
+
+    void write_indexes()
+    {
+        out_file_.write(
+            reinterpret_cast<const char *>(indexes_buffer_.data()),
+            static_cast<std::streamsize>(indexes_buffer_.size() * sizeof(core::messaging::SpikeIndex)));
+        indexes_buffer_.clear();
+        if (!out_file_) throw std::runtime_error("Unable to write spikes to raster file.");
+    }
+
+    void flush()
+    {
+        if (is_closed_) return;
+        write_indexes();
+        out_file_.flush();
+    }
+
+    void close()
+    {
+        if (is_closed_) return;
+        is_closed_ = true;
+        write_indexes();
+
+        const RasterHeader header{
+            MAGIC_NUMBER, RASTER_VERSION, first_step_, offsets_.size(), spikes_count_, get_table_offset(spikes_count_)};
+        offsets_.push_back(spikes_count_);
+
+        // Padding before the offset table.
+        const uint64_t indexes_end = sizeof(RasterHeader) + spikes_count_ * sizeof(core::messaging::SpikeIndex);
+        const std::vector<char> padding(header.table_offset_ - indexes_end, 0);
+        out_file_.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        out_file_.write(
+            reinterpret_cast<const char *>(offsets_.data()),
+            static_cast<std::streamsize>(offsets_.size() * sizeof(uint64_t)));
+
+        out_file_.seekp(0);
+        out_file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out_file_.close();
+        offsets_.clear();
+
+        if (!out_file_) throw std::runtime_error("Unable to complete spike raster file.");
+    }
+
+    std::ofstream out_file_;
+    std::vector<core::messaging::SpikeIndex> indexes_buffer_;
+    // Offset of the first index of each step from the first step.
+    std::vector<uint64_t> offsets_;
+    core::Step first_step_ = 0;
+    uint64_t spikes_count_ = 0;
+    bool is_closed_ = false;
+};
+
+
+RasterSpikeMessageWriter::RasterSpikeMessageWriter(const fs::path &path_to_save)
+    : impl_(std::make_unique<Impl>(path_to_save))
+{
+}
+
+
+RasterSpikeMessageWriter::~RasterSpikeMessageWriter()
+{
+    try
+    {
+        impl_->close();
+    }
+    catch (const std::exception &e)
+    {
+        SPDLOG_ERROR("Unable to complete spike raster file: {}.", e.what());
+    }
+}
+
+
+void RasterSpikeMessageWriter::write(const core::messaging::SpikeMessage &message)
+{
+    impl_->write(message);
+}
+
+
+void RasterSpikeMessageWriter::flush()
+{
+    impl_->flush();
+}
+
+
+void RasterSpikeMessageWriter::close()
+{
+    impl_->close();
+}
+
+}  // namespace knp::framework::io::storage::native
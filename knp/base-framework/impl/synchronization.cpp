@@ -20,23 +20,18 @@
  */
 
 #include <knp/framework/network.h>
+#include <knp/framework/synchronization.h>
 
 namespace knp::framework::synchronization
 {
 KNP_DECLSPEC Network get_network_copy(const knp::core::Backend &backend)
 {
-    auto data_ranges = backend.get_network_data();
     knp::framework::Network res_network;
-    for (auto &iter = *data_ranges.population_range.first; iter != *data_ranges.population_range.second; ++iter)
-    {
-        auto population = *iter;
-        res_network.add_population(std::move(population));
-    }
-    for (auto &iter = *data_ranges.projection_range.first; iter != *data_ranges.projection_range.second; ++iter)
-    {
-        auto projection = *iter;
-        res_network.add_projection(std::move(projection));
-    }
+    // Every entity is copied only once: directly from the backend into the network.
+    backend.for_each_population([&res_network](const auto &population)
+                                { res_network.add_population(knp::core::AllPopulationsVariant{population}); });
+    backend.for_each_projection([&res_network](const auto &projection)
+                                { res_network.add_projection(knp::core::AllProjectionsVariant{projection}); });
     return res_network;
 }
 }  // namespace knp::framework::synchronization
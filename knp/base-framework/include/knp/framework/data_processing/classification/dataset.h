@@ -25,6 +25,7 @@
 #include <knp/core/impexp.h>
 #include <knp/core/messaging/messaging.h>
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -100,20 +101,55 @@ public:
      * 
      * @details This structure encapsulates the spike data for a class instance, which is transmitted over a series of
      * steps. For example, an image might be sent over 20 steps, with each step representing a subset of the image data.
-     * The structure stores a vector of boolean values, where each value indicates whether a spike should be sent at a
-     * particular step. The length of this vector is determined by the product of the steps per frame and the size of
-     * the class instance data.
+     * The structure stores indexes of spiked inputs only: indexes of all steps are kept in a single vector in the order
+     * of steps, and a second vector stores the end of each step in the first one. Steps after the last stored step
+     * have no spikes, so a frame does not store inactive steps.
      */
     struct Frame
     {
-        // cppcheck-suppress unusedStructMember
         /**
-         * @brief A vector of boolean values representing the spike pattern for this frame.
+         * @brief Add spikes of the next step to the frame.
+         * 
+         * @param spikes indexes of inputs that spike at the step.
+         */
+        void add_step(const core::messaging::SpikeData &spikes)
+        {
+            indexes_.insert(indexes_.end(), spikes.begin(), spikes.end());
+            step_ends_.push_back(static_cast<uint32_t>(indexes_.size()));
+        }
+
+        /**
+         * @brief Get spikes of a frame step.
+         * 
+         * @param step step index within the frame.
+         * 
+         * @return indexes of inputs that spike at the step.
+         */
+        [[nodiscard]] core::messaging::SpikeData get_spikes(size_t step) const
+        {
+            if (step >= step_ends_.size()) return {};
+            const size_t step_begin = step ? step_ends_[step - 1] : 0;
+            return core::messaging::SpikeData(indexes_.begin() + step_begin, indexes_.begin() + step_ends_[step]);
+        }
+
+        /**
+         * @brief Get number of steps stored in the frame.
          * 
-         * @note The length of this vector is equal to the number of steps per frame multiplied by the size of the class
-         * instance data.
+         * @return number of steps up to the last stored step.
+         */
+        [[nodiscard]] size_t get_steps_count() const { return step_ends_.size(); }
+
+        // cppcheck-suppress unusedStructMember
+        /**
+         * @brief Indexes of spiked inputs of all steps in the order of steps.
+         */
+        std::vector<core::messaging::SpikeIndex> indexes_;
+
+        // cppcheck-suppress unusedStructMember
+        /**
+         * @brief Position in `indexes_` after the last index of each step.
          */
-        std::vector<bool> spikes_;
+        std::vector<uint32_t> step_ends_;
     };
 
 
@@ -25,6 +25,8 @@
 #include <knp/core/impexp.h>
 #include <knp/core/messaging/messaging.h>
 
+#include <functional>
+#include <istream>
 #include <vector>
 
 #include "dataset.h"
@@ -62,6 +64,31 @@ public:
         size_t image_size, size_t steps_per_image,
         std::function<Frame(std::vector<uint8_t> const &)> const &image_to_spikes);
 
+    /**
+     * @brief Process labels and images, converting the images to spike form in parallel.
+     * 
+     * @param images_stream stream containing the raw image data.
+     * @param labels_stream stream containing the corresponding labels.
+     * @param max_images_amount maximum amount of images that should be processed.
+     * @param classes_amount total number of classes in the dataset.
+     * @param image_size size of each image in bytes.
+     * @param steps_per_image number of steps required to transmit an image in spike form to a model.
+     * @param image_to_spikes function that converts raw image data to spike form, returning a `Frame` object.
+     * @param threads_count number of threads that convert images. If `0`, the number of hardware threads is used.
+     * 
+     * @details This method reads all labels and then all raw images in bulk, splits the images into contiguous
+     * ranges and converts each range in a separate thread. Frames are stored in the order of images, so the result
+     * does not depend on the number of threads.
+     * 
+     * @pre @p image_to_spikes must be safe to call from several threads concurrently, and its result must depend only
+     * on the given image. Use `make_independent_incrementing_image_to_spikes_converter()` instead of a stateful
+     * `make_incrementing_image_to_spikes_converter()`.
+     */
+    void process_labels_and_images(
+        std::istream &images_stream, std::istream &labels_stream, size_t max_images_amount, size_t classes_amount,
+        size_t image_size, size_t steps_per_image,
+        std::function<Frame(std::vector<uint8_t> const &)> const &image_to_spikes, size_t threads_count);
+
     /**
      * @brief Create a generator that produces spike data from training labels.
      * 
@@ -106,11 +133,30 @@ public:
      * 
      * @details This converter generates spikes based on the input image data, considering the specified number of
      * active steps and the state increment factor. Spikes are sent for the active steps, and no spikes are sent for the
-     * remaining steps until the total steps per image (@ref steps_per_frame_) are reached.
+     * remaining steps until the total steps per image (@ref steps_per_frame_) are reached. Frames store only indexes
+     * of spiked inputs of active steps.
      */
     [[nodiscard]] std::function<Frame(std::vector<uint8_t> const &)> make_incrementing_image_to_spikes_converter(
         size_t active_steps, float state_increment_factor) const;
 
+    /**
+     * @brief Create an incrementing image to spikes converter that converts each image independently.
+     * 
+     * @param active_steps number of active steps, which must be less than the total steps per image (@ref
+     * steps_per_frame_).
+     * @param state_increment_factor factor by which the state is incremented for each input value.
+     * @param initial_state state of each input at the beginning of every image.
+     * 
+     * @return functor that converts raw image data to spikes.
+     * 
+     * @details The converter works as the converter created by `make_incrementing_image_to_spikes_converter()`, but
+     * input states are reset to @p initial_state for every image instead of being carried over from the previous
+     * image. The functor has no mutable state, so it can be used for parallel processing.
+     */
+    [[nodiscard]] std::function<Frame(std::vector<uint8_t> const &)>
+    make_independent_incrementing_image_to_spikes_converter(
+        size_t active_steps, float state_increment_factor, float initial_state = 0.F) const;
+
     /**
      * @brief Get image size.
      * 
@@ -0,0 +1,97 @@
+/**
+ * @file prefetching_generator.h
+ * @brief Header for generator wrapper that prefetches input spikes in a background thread.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <knp/core/impexp.h>
+#include <knp/core/messaging/spike_message.h>
+
+#include <memory>
+
+#include "../input_converter.h"
+
+
+/**
+ * @brief Input channel namespace.
+ */
+namespace knp::framework::io::input
+{
+/**
+ * @brief The PrefetchingGenerator class is a definition of a wrapper that calls a data generator in a background
+ * thread ahead of the network steps.
+ * 
+ * @details When spikes of step `N` are requested, the background thread has already generated or is generating spikes
+ * of steps `N + 1` to `N + k`, where `k` is the prefetch depth. Generated spikes are passed through a bounded
+ * single-producer single-consumer queue, and a caller blocks only if the requested spikes are not ready yet.
+ * The wrapped generator is called from a single thread for consecutive steps.
+ * 
+ * If the requested step is not the next step, the prefetched spikes are dropped and prefetching restarts from the
+ * requested step. Every time the requested spikes are not ready yet, the stall counter is incremented.
+ * 
+ * @note After a restart, the wrapped generator has already been called for the dropped steps and is called for them
+ * again if they are requested later. A generator that depends on the call order can produce different spikes than
+ * without the wrapper in this case.
+ * 
+ * The wrapper is copyable and can be used as an input channel `DataGenerator`, copies share the background thread
+ * and must be called from one thread.
+ * 
+ * @note Objects used by the wrapped generator must exist while the wrapper exists, because the generator can be called
+ * in advance.
+ */
+class KNP_DECLSPEC PrefetchingGenerator
+{
+public:
+    /**
+     * @brief Create wrapper of a data generator.
+     * 
+     * @param generator data generator.
+     * @param prefetch_steps maximum number of steps generated in advance.
+     * 
+     * @throw std::invalid_argument if @p prefetch_steps is `0`.
+     * 
+     * @details The background thread starts when spikes are requested for the first time.
+     */
+    explicit PrefetchingGenerator(DataGenerator generator, size_t prefetch_steps = 16);
+
+    /**
+     * @brief Get spiked neuron indexes of a step.
+     * 
+     * @param step current network step.
+     * 
+     * @return vector of spiked neuron indexes.
+     * 
+     * @note The method rethrows an exception thrown by the wrapped generator for this step.
+     */
+    core::messaging::SpikeData operator()(core::Step step) const;
+
+public:
+    /**
+     * @brief Get number of calls that waited for the background thread.
+     * 
+     * @return number of stalls.
+     */
+    [[nodiscard]] size_t get_stalls_count() const;
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl> impl_;
+};
+
+}  // namespace knp::framework::io::input
@@ -0,0 +1,114 @@
+/**
+ * @file raster_converter.h
+ * @brief Header for input converter that replays binary spike rasters.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <knp/core/messaging/spike_message.h>
+#include <knp/framework/io/storage/native/data_storage_raster.h>
+
+#include <filesystem>
+#include <memory>
+#include <utility>
+
+
+/**
+ * @brief Input channel namespace.
+ */
+namespace knp::framework::io::input
+{
+/**
+ * @brief The RasterConverter class is a definition of a generator that takes spiked neuron indexes from a binary spike
+ * raster.
+ * 
+ * @details Spikes of a step are copied from the memory-mapped raster file without parsing. The converter is copyable
+ * and can be used as an input channel `DataGenerator`, copies share the mapped raster.
+ */
+class RasterConverter
+{
+public:
+    /**
+     * @brief Create converter that replays a mapped raster.
+     * 
+     * @param raster spike raster.
+     * @param first_step network step at which raster step `0` is replayed.
+     * @param is_looped if `true`, the raster is replayed again after its last step.
+     */
+    explicit RasterConverter(
+        std::shared_ptr<const storage::native::SpikeRaster> raster, core::Step first_step = 0, bool is_looped = false)
+        : raster_(std::move(raster)), first_step_(first_step), is_looped_(is_looped)
+    {
+    }
+
+    /**
+     * @brief Create converter that maps a raster file and replays it.
+     * 
+     * @param path_to_raster path to raster file.
+     * @param first_step network step at which raster step `0` is replayed.
+     * @param is_looped if `true`, the raster is replayed again after its last step.
+     */
+    explicit RasterConverter(
+        const std::filesystem::path &path_to_raster, core::Step first_step = 0, bool is_looped = false)
+        : RasterConverter(std::make_shared<const storage::native::SpikeRaster>(path_to_raster), first_step, is_looped)
+    {
+    }
+
+    /**
+     * @brief Get spiked neuron indexes of a step.
+     * 
+     * @param step current network step.
+     * 
+     * @return vector of spiked neuron indexes, empty before the first step and after the raster end.
+     */
+    core::messaging::SpikeData operator()(core::Step step) const
+    {
+        if (step < first_step_) return {};
+
+        core::Step raster_step = step - first_step_;
+        const size_t steps_count = raster_->get_steps_count();
+        if (is_looped_ && steps_count > 0) raster_step %= steps_count;
+        return raster_->get_spikes(raster_step);
+    }
+
+public:
+    /**
+     * @brief Get replayed raster.
+     * 
+     * @return spike raster.
+     */
+    [[nodiscard]] const storage::native::SpikeRaster &get_raster() const { return *raster_; }
+
+private:
+    /**
+     * @brief Mapped raster shared by converter copies.
+     */
+    std::shared_ptr<const storage::native::SpikeRaster> raster_;
+
+    /**
+     * @brief Network step at which the raster starts.
+     */
+    core::Step first_step_;
+
+    /**
+     * @brief Raster replay mode.
+     */
+    bool is_looped_;
+};
+
+}  // namespace knp::framework::io::input
@@ -24,8 +24,11 @@
 #include <knp/core/impexp.h>
 #include <knp/core/message_endpoint.h>
 #include <knp/core/messaging/messaging.h>
+#include <knp/framework/io/storage/native/spike_message_stream.h>
 
 #include <algorithm>
+#include <deque>
+#include <functional>
 #include <utility>
 #include <vector>
 
@@ -39,18 +42,30 @@ namespace knp::framework::io::output
 {
 /**
  * @brief The OutputChannel class is a definition of an output channel.
+ * 
+ * @details Received messages are grouped by steps and stored in the order of steps. Only steps with messages are
+ * stored, so memory is proportional to the number of buffered messages, and messages of a step are found by binary
+ * search. If a retention window is set, the channel keeps messages of the given number of latest steps only.
  */
 class KNP_DECLSPEC OutputChannel
 {
+public:
+    /**
+     * @brief Retention window value that means all steps are retained until they are read.
+     */
+    static constexpr size_t unlimited_retention = 0;
+
 public:
     /**
      * @brief Base output channel constructor.
      * 
      * @param channel_uid output channel UID.
      * @param endpoint endpoint to use for message exchange.
+     * @param retention_steps number of latest steps whose messages are kept in the channel.
      */
-    OutputChannel(const core::UID &channel_uid, core::MessageEndpoint &&endpoint)
-        : base_{channel_uid}, endpoint_(std::move(endpoint))
+    OutputChannel(
+        const core::UID &channel_uid, core::MessageEndpoint &&endpoint, size_t retention_steps = unlimited_retention)
+        : base_{channel_uid}, endpoint_(std::move(endpoint)), retention_steps_(retention_steps)
     {
     }
 
@@ -79,22 +94,82 @@ public:
     /**
      * @brief Unload spike messages from the endpoint into the message buffer.
      * 
-     * @return vector of spikes.
+     * @return number of received messages.
      * 
-     * @details You should call the method before reading data from the channel.
+     * @details You should call the method before reading data from the channel. Messages of steps that are out of the
+     * retention window are dropped. Messages that arrive after `read_some_from_buffer()` has read their step may be
+     * dropped too.
      */
-    std::vector<core::messaging::SpikeMessage> update();
+    size_t update();
 
     /**
-     * @brief Read a specified interval of messages from sorted internal message buffer.
+     * @brief Read a specified interval of messages from the message buffer and remove them from the buffer.
      * 
      * @param starting_step step from which the method starts reading spike messages.
      * @param final_step step after which the method stops reading spike messages.
      * 
-     * @return vector of messages sent on the specified interval of steps.
+     * @return vector of messages sent on the specified interval of steps sorted by steps.
      */
     std::vector<core::messaging::SpikeMessage> read_some_from_buffer(core::Step starting_step, core::Step final_step);
 
+    /**
+     * @brief Get messages of a step without copying.
+     * 
+     * @param step step.
+     * 
+     * @return messages received at the step or an empty vector if there are no messages of the step in the buffer.
+     * The reference is valid until the next `update()` or `read_some_from_buffer()` call.
+     */
+    [[nodiscard]] const std::vector<core::messaging::SpikeMessage> &get_step_messages(core::Step step) const;
+
+    /**
+     * @brief Get messages of a specified interval of steps without copying or removing them from the buffer.
+     * 
+     * @param starting_step first step of the interval.
+     * @param final_step last step of the interval.
+     * 
+     * @return references to messages sorted by steps. The references are valid until the next `update()` or
+     * `read_some_from_buffer()` call.
+     */
+    [[nodiscard]] std::vector<std::reference_wrapper<const core::messaging::SpikeMessage>> get_messages(
+        core::Step starting_step, core::Step final_step) const;
+
+    /**
+     * @brief Get retention window.
+     * 
+     * @return number of latest steps whose messages are kept in the channel.
+     */
+    [[nodiscard]] size_t get_retention_steps() const { return retention_steps_; }
+
+    /**
+     * @brief Set retention window.
+     * 
+     * @param retention_steps number of latest steps whose messages are kept in the channel.
+     * 
+     * @details Buffered messages of steps that are out of the new window are dropped immediately.
+     */
+    void set_retention_steps(size_t retention_steps);
+
+private:
+    /**
+     * @brief Messages of one step.
+     */
+    struct StepSlot
+    {
+        /**
+         * @brief Step of messages in the slot.
+         */
+        core::Step step_ = 0;
+
+        /**
+         * @brief Messages received at the step.
+         */
+        std::vector<core::messaging::SpikeMessage> messages_;
+    };
+
+    void add_message(core::messaging::SpikeMessage &&message);
+    void apply_retention();
+
 protected:
     /**
      * @brief Base data.
@@ -106,10 +181,14 @@ protected:
      */
     core::MessageEndpoint endpoint_;
 
-    /**
-     * @brief Messages received from output population.
-     */
-    std::vector<core::messaging::SpikeMessage> message_buffer_;  // cppcheck-suppress unusedStructMember
+private:
+    size_t retention_steps_;
+    // Slots of steps with messages sorted by steps.
+    std::deque<StepSlot> slots_;
+    // Messages of steps before the first step are dropped.
+    core::Step first_step_ = 0;
+    // Step after the latest received step.
+    core::Step end_step_ = 0;
 };
 
 
@@ -131,4 +210,27 @@ template <typename ResultType>
     return converter(output_channel.read_some_from_buffer(step_from, step_to));
 }
 
+
+/**
+ * @brief Read all accumulated spike messages from subscription and write them to storage.
+ * 
+ * @param output_channel output channel object.
+ * @param writer spike message writer, for example `storage::native::RasterSpikeMessageWriter`.
+ * @param step_from network step from which the method starts reading spike messages.
+ * @param step_to network step after which the method stops reading spike messages.
+ * 
+ * @return number of written messages.
+ * 
+ * @details Call the function with consecutive step intervals, because writers accept messages in the order of steps.
+ */
+inline size_t output_channel_write(
+    OutputChannel &output_channel, storage::native::SpikeMessageWriter &writer, core::Step step_from,
+    core::Step step_to)
+{
+    output_channel.update();
+    const auto messages = output_channel.read_some_from_buffer(step_from, step_to);
+    writer.write(messages.begin(), messages.end());
+    return messages.size();
+}
+
 }  // namespace knp::framework::io::output
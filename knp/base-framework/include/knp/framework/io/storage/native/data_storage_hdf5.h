@@ -22,8 +22,11 @@
 
 #include <knp/core/impexp.h>
 #include <knp/core/messaging/messaging.h>
+#include <knp/framework/io/storage/native/spike_message_stream.h>
 
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <vector>
 
 
@@ -39,8 +42,6 @@ namespace knp::framework::io::storage
 namespace native
 {
 
-// TODO: Return and get iterators.
-
 /**
  * @brief Read spike messages from an HDF5 file.
  * 
@@ -74,6 +75,119 @@ KNP_DECLSPEC void save_messages_to_h5(
     const std::vector<core::messaging::SpikeMessage> &messages, const std::filesystem::path &path_to_save,
     float time_per_step = 1.0f);
 
+
+/**
+ * @brief Writer that appends spike messages to an HDF5 file during a simulation.
+ * 
+ * @details The writer creates a file of the same format as `save_messages_to_h5()` with chunked datasets that grow
+ * as messages are written. Messages are buffered in memory until the given number of steps is collected, so memory
+ * usage does not depend on the simulation length.
+ */
+class KNP_DECLSPEC H5SpikeMessageWriter : public SpikeMessageWriter
+{
+public:
+    /**
+     * @brief Default number of buffered steps.
+     */
+    static constexpr size_t default_flush_steps = 1024;
+
+public:
+    /**
+     * @brief Create an HDF5 file for writing.
+     * 
+     * @param path_to_save path to file. An existing file is overwritten.
+     * @param time_per_step time per step.
+     * @param flush_steps number of steps buffered before the buffer is written to the file.
+     * @param compression_level deflate compression level from `1` to `9`, `0` disables compression.
+     */
+    explicit H5SpikeMessageWriter(
+        const std::filesystem::path &path_to_save, float time_per_step = 1.0f,
+        size_t flush_steps = default_flush_steps, unsigned compression_level = 0);
+
+    /**
+     * @brief Write buffered messages and close the file.
+     */
+    ~H5SpikeMessageWriter() override;
+
+public:
+    /**
+     * @brief Write a spike message.
+     * 
+     * @param message spike message. Its step must not be less than the step of the previous message.
+     * 
+     * @throw std::invalid_argument if messages are written out of step order.
+     */
+    void write(const core::messaging::SpikeMessage &message) override;
+
+    using SpikeMessageWriter::write;
+
+    /**
+     * @brief Write buffered messages to the file.
+     */
+    void flush() override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+
+/**
+ * @brief Reader that loads spike messages from an HDF5 file on demand.
+ * 
+ * @details The reader loads datasets in chunks of the given number of spikes, so memory usage does not depend on the
+ * file size. Spikes in the file must be sorted by timestamps, as `save_messages_to_h5()` and `H5SpikeMessageWriter`
+ * save them. Spikes with timestamps within the same step form one message.
+ */
+class KNP_DECLSPEC H5SpikeMessageReader : public SpikeMessageReader
+{
+public:
+    /**
+     * @brief Default number of spikes loaded at once.
+     */
+    static constexpr size_t default_chunk_size = 65536;
+
+public:
+    /**
+     * @brief Open an HDF5 file for reading.
+     * 
+     * @param path_to_h5 path to HDF5 data file.
+     * @param uid sender UID.
+     * @param time_per_step time per step.
+     * @param strict_format if `true`, constructor throws exception on wrong format.
+     * @param chunk_size number of spikes loaded at once.
+     */
+    H5SpikeMessageReader(
+        const std::filesystem::path &path_to_h5, const knp::core::UID &uid, float time_per_step = 1.0f,
+        bool strict_format = true, size_t chunk_size = default_chunk_size);
+
+    /**
+     * @brief Close the file.
+     */
+    ~H5SpikeMessageReader() override;
+
+protected:
+    /**
+     * @brief Read spikes of the next step.
+     * 
+     * @return spike message or nothing if there are no more spikes.
+     */
+    std::optional<core::messaging::SpikeMessage> read_message() override;
+
+    /**
+     * @brief Find the first spike with the given or a later step.
+     * 
+     * @param step step.
+     * 
+     * @details The method uses binary search over timestamps and loads only the chunk of the found spike.
+     */
+    void seek_message(core::Step step) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
 }  // namespace native
 
 }  // namespace knp::framework::io::storage
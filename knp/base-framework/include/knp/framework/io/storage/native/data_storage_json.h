@@ -22,8 +22,11 @@
 
 #include <knp/core/impexp.h>
 #include <knp/core/messaging/messaging.h>
+#include <knp/framework/io/storage/native/spike_message_stream.h>
 
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <vector>
 
 
@@ -33,8 +36,6 @@
 namespace knp::framework::io::storage::native
 {
 
-// TODO: return and get iterators.
-
 /**
  * @brief Read spike messages from a JSON file.
  * 
@@ -58,4 +59,108 @@ KNP_DECLSPEC std::vector<core::messaging::SpikeMessage> load_messages_from_json(
  */
 KNP_DECLSPEC void save_messages_to_json(
     const std::vector<core::messaging::SpikeMessage> &messages, const std::filesystem::path &path_to_save);
+
+
+/**
+ * @brief Writer that saves spike messages to a JSON file incrementally.
+ * 
+ * @details The writer creates a file of the same format as `save_messages_to_json()`. Node indexes are written to the
+ * file directly, timestamps are written to a temporary file next to it and appended to the file when the writer is
+ * closed. Memory usage does not depend on the number of messages.
+ */
+class KNP_DECLSPEC JsonSpikeMessageWriter : public SpikeMessageWriter
+{
+public:
+    /**
+     * @brief Create a JSON file for writing.
+     * 
+     * @param path_to_save path to file. An existing file is overwritten.
+     */
+    explicit JsonSpikeMessageWriter(const std::filesystem::path &path_to_save);
+
+    /**
+     * @brief Close the file if it is not closed.
+     */
+    ~JsonSpikeMessageWriter() override;
+
+public:
+    /**
+     * @brief Write a spike message.
+     * 
+     * @param message spike message. Its step must not be less than the step of the previous message.
+     * 
+     * @throw std::invalid_argument if messages are written out of step order.
+     */
+    void write(const core::messaging::SpikeMessage &message) override;
+
+    using SpikeMessageWriter::write;
+
+    /**
+     * @brief Write buffered data to files.
+     * 
+     * @note The JSON file is complete only after the writer is closed.
+     */
+    void flush() override;
+
+    /**
+     * @brief Complete the JSON file and remove the temporary file.
+     * 
+     * @details Messages cannot be written after the writer is closed.
+     */
+    void close();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+
+/**
+ * @brief Reader that parses spike messages from a JSON file on demand.
+ * 
+ * @details The reader does not build a document. It finds node and timestamp arrays with a SAX parser and then reads
+ * both arrays in parallel, one value at a time. Spikes in the file must be sorted by timestamps, as
+ * `save_messages_to_json()` and `JsonSpikeMessageWriter` save them.
+ */
+class KNP_DECLSPEC JsonSpikeMessageReader : public SpikeMessageReader
+{
+public:
+    /**
+     * @brief Open a JSON file for reading.
+     * 
+     * @param path_to_json path to JSON data file.
+     * @param uid sender UID.
+     * @param strict_format if `true`, constructor throws exception on wrong format.
+     */
+    JsonSpikeMessageReader(
+        const std::filesystem::path &path_to_json, const knp::core::UID &uid, bool strict_format = true);
+
+    /**
+     * @brief Close the file.
+     */
+    ~JsonSpikeMessageReader() override;
+
+protected:
+    /**
+     * @brief Read spikes of the next step.
+     * 
+     * @return spike message or nothing if there are no more spikes.
+     */
+    std::optional<core::messaging::SpikeMessage> read_message() override;
+
+    /**
+     * @brief Skip spikes until the given or a later step.
+     * 
+     * @param step step.
+     * 
+     * @details JSON arrays cannot be accessed randomly, so seeking to an earlier step parses the arrays from the
+     * beginning.
+     */
+    void seek_message(core::Step step) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
 }  // namespace knp::framework::io::storage::native
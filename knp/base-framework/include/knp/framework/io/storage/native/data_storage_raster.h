@@ -0,0 +1,241 @@
+/**
+ * @file data_storage_raster.h
+ * @brief Binary spike raster storage.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <knp/core/impexp.h>
+#include <knp/core/messaging/messaging.h>
+#include <knp/framework/io/storage/native/spike_message_stream.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <utility>
+
+
+/**
+ * @brief Data storage namespace.
+ */
+namespace knp::framework::io::storage::native
+{
+
+/**
+ * @brief Read-only spike raster mapped into memory from a binary file.
+ * 
+ * @details A raster file contains a header, packed 32-bit indexes of spiked neurons in the order of steps and a table
+ * of 64-bit offsets of the first index of each step. The table starts from the first written step, steps before it
+ * have no spikes. The file is mapped into memory, so access to spikes of any step takes constant time and requires
+ * no parsing. Values are stored in little-endian byte order.
+ * 
+ * Use `RasterSpikeMessageWriter` to create raster files.
+ */
+class KNP_DECLSPEC SpikeRaster
+{
+public:
+    /**
+     * @brief Range of spiked neuron indexes that points into mapped memory.
+     */
+    using IndexRange = std::pair<const core::messaging::SpikeIndex *, const core::messaging::SpikeIndex *>;
+
+public:
+    /**
+     * @brief Map a raster file into memory.
+     * 
+     * @param path_to_raster path to raster file.
+     * 
+     * @throw std::runtime_error if the file has a wrong format.
+     */
+    explicit SpikeRaster(const std::filesystem::path &path_to_raster);
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~SpikeRaster();
+
+public:
+    /**
+     * @brief Get first step stored in the raster.
+     * 
+     * @return step of the first written message or `0` if the raster is empty.
+     */
+    [[nodiscard]] core::Step get_first_step() const;
+
+    /**
+     * @brief Get number of steps in the raster.
+     * 
+     * @return number of steps from step `0` to the last step with spikes.
+     */
+    [[nodiscard]] size_t get_steps_count() const;
+
+    /**
+     * @brief Get total number of spikes in the raster.
+     * 
+     * @return number of spikes.
+     */
+    [[nodiscard]] size_t get_spikes_count() const;
+
+    /**
+     * @brief Get indexes of neurons that spiked at a step without copying.
+     * 
+     * @param step step.
+     * 
+     * @return range of indexes, which is empty for steps after the last step. The range is valid while the raster
+     * exists.
+     */
+    [[nodiscard]] IndexRange get_indexes(core::Step step) const;
+
+    /**
+     * @brief Get indexes of neurons that spiked at a step.
+     * 
+     * @param step step.
+     * 
+     * @return spiked neuron indexes.
+     */
+    [[nodiscard]] core::messaging::SpikeData get_spikes(core::Step step) const
+    {
+        const auto [begin, end] = get_indexes(step);
+        return core::messaging::SpikeData(begin, end);
+    }
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+
+/**
+ * @brief Writer that saves spike messages to a binary raster file.
+ * 
+ * @details Indexes are written to the file as messages arrive, the offset table is kept in memory and written when
+ * the writer is closed. The table takes 8 bytes per step from the step of the first written message.
+ */
+class KNP_DECLSPEC RasterSpikeMessageWriter : public SpikeMessageWriter
+{
+public:
+    /**
+     * @brief Create a raster file for writing.
+     * 
+     * @param path_to_save path to file. An existing file is overwritten.
+     */
+    explicit RasterSpikeMessageWriter(const std::filesystem::path &path_to_save);
+
+    /**
+     * @brief Close the file if it is not closed.
+     */
+    ~RasterSpikeMessageWriter() override;
+
+public:
+    /**
+     * @brief Write a spike message.
+     * 
+     * @param message spike message. Its step must not be less than the step of the previous message. Indexes of
+     * messages with the same step are merged.
+     * 
+     * @throw std::invalid_argument if messages are written out of step order.
+     */
+    void write(const core::messaging::SpikeMessage &message) override;
+
+    using SpikeMessageWriter::write;
+
+    /**
+     * @brief Write buffered indexes to the file.
+     * 
+     * @note The raster file is complete only after the writer is closed.
+     */
+    void flush() override;
+
+    /**
+     * @brief Write the offset table and the header.
+     * 
+     * @details Messages cannot be written after the writer is closed.
+     */
+    void close();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+
+/**
+ * @brief Reader of spike messages from a binary raster file.
+ * 
+ * @details The reader returns messages of steps with spikes. Seeking to any step takes constant time.
+ */
+class KNP_DECLSPEC RasterSpikeMessageReader : public SpikeMessageReader
+{
+public:
+    /**
+     * @brief Create a reader of a mapped raster.
+     * 
+     * @param raster spike raster.
+     * @param uid sender UID.
+     */
+    RasterSpikeMessageReader(std::shared_ptr<const SpikeRaster> raster, const knp::core::UID &uid)
+        : raster_(std::move(raster)), uid_(uid)
+    {
+    }
+
+    /**
+     * @brief Map a raster file and create a reader.
+     * 
+     * @param path_to_raster path to raster file.
+     * @param uid sender UID.
+     */
+    RasterSpikeMessageReader(const std::filesystem::path &path_to_raster, const knp::core::UID &uid)
+        : RasterSpikeMessageReader(std::make_shared<const SpikeRaster>(path_to_raster), uid)
+    {
+    }
+
+protected:
+    /**
+     * @brief Read spikes of the next step with spikes.
+     * 
+     * @return spike message or nothing if there are no more spikes.
+     */
+    std::optional<core::messaging::SpikeMessage> read_message() override
+    {
+        const size_t steps_count = raster_->get_steps_count();
+        // Steps before the first stored step have no spikes.
+        step_ = std::max<core::Step>(step_, raster_->get_first_step());
+        while (step_ < steps_count)
+        {
+            const core::Step step = step_++;
+            auto spikes = raster_->get_spikes(step);
+            if (!spikes.empty()) return core::messaging::SpikeMessage{{uid_, step}, std::move(spikes)};
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Move to a step.
+     * 
+     * @param step step.
+     */
+    void seek_message(core::Step step) override { step_ = step; }
+
+private:
+    std::shared_ptr<const SpikeRaster> raster_;
+    core::UID uid_;
+    core::Step step_ = 0;
+};
+
+}  // namespace knp::framework::io::storage::native
@@ -0,0 +1,297 @@
+/**
+ * @file spike_message_stream.h
+ * @brief Interfaces of streaming spike message readers and writers.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <knp/core/messaging/messaging.h>
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Data storage namespace.
+ */
+namespace knp::framework::io::storage::native
+{
+
+class SpikeMessageReader;
+
+
+/**
+ * @brief Input iterator that reads spike messages from a reader one by one.
+ * 
+ * @details Only one message is kept in memory. Iterators of the same reader share its position, so the iterator is
+ * single-pass.
+ */
+class SpikeMessageIterator
+{
+public:
+    /**
+     * @brief Iterator category.
+     */
+    using iterator_category = std::input_iterator_tag;
+    /**
+     * @brief Value type.
+     */
+    using value_type = core::messaging::SpikeMessage;
+    /**
+     * @brief Difference type.
+     */
+    using difference_type = std::ptrdiff_t;
+    /**
+     * @brief Pointer type.
+     */
+    using pointer = const core::messaging::SpikeMessage *;
+    /**
+     * @brief Reference type.
+     */
+    using reference = const core::messaging::SpikeMessage &;
+
+public:
+    /**
+     * @brief Construct an end iterator.
+     */
+    SpikeMessageIterator() = default;
+
+    /**
+     * @brief Construct an iterator that points to the next message of a reader.
+     * 
+     * @param reader spike message reader.
+     */
+    explicit SpikeMessageIterator(SpikeMessageReader &reader);
+
+public:
+    /**
+     * @brief Get current message.
+     * 
+     * @return spike message.
+     */
+    reference operator*() const { return *message_; }
+
+    /**
+     * @brief Access current message.
+     * 
+     * @return pointer to spike message.
+     */
+    pointer operator->() const { return &*message_; }
+
+    /**
+     * @brief Read the next message.
+     * 
+     * @return iterator.
+     */
+    SpikeMessageIterator &operator++();
+
+    /**
+     * @brief Compare iterators.
+     * 
+     * @param other other iterator.
+     * 
+     * @return `true` if both iterators are end iterators or point to the same reader.
+     */
+    bool operator==(const SpikeMessageIterator &other) const
+    {
+        return message_.has_value() == other.message_.has_value() && (!message_ || reader_ == other.reader_);
+    }
+
+    /**
+     * @brief Compare iterators.
+     * 
+     * @param other other iterator.
+     * 
+     * @return `true` if iterators are not equal.
+     */
+    bool operator!=(const SpikeMessageIterator &other) const { return !(*this == other); }
+
+private:
+    SpikeMessageReader *reader_ = nullptr;
+    std::optional<core::messaging::SpikeMessage> message_;
+};
+
+
+/**
+ * @brief Base class of readers that load spike messages from storage on demand.
+ * 
+ * @details Readers return messages in the order of steps, one message per step. Storage formats implement
+ * `read_message()` and `seek_message()`, so that callers can switch formats without code changes.
+ */
+class SpikeMessageReader
+{
+public:
+    /**
+     * @brief Default virtual destructor.
+     */
+    virtual ~SpikeMessageReader() = default;
+
+public:
+    /**
+     * @brief Read the next message.
+     * 
+     * @return message or nothing if there are no more messages.
+     */
+    std::optional<core::messaging::SpikeMessage> read()
+    {
+        if (lookahead_) return std::exchange(lookahead_, std::nullopt);
+        return read_message();
+    }
+
+    /**
+     * @brief Move to the first message with the given or a later step.
+     * 
+     * @param step step.
+     */
+    void seek(core::Step step)
+    {
+        lookahead_.reset();
+        seek_message(step);
+    }
+
+    /**
+     * @brief Read messages of a step range.
+     * 
+     * @details The method reads from the current position, call `seek()` to start from the first step of the range.
+     * After the call the reader points to the first message of the next range.
+     * 
+     * @param last_step step after the last step of the range.
+     * 
+     * @return messages with steps less than @p last_step.
+     */
+    std::vector<core::messaging::SpikeMessage> read_until(core::Step last_step)
+    {
+        std::vector<core::messaging::SpikeMessage> result;
+        while (auto message = read())
+        {
+            if (message->header_.send_time_ >= last_step)
+            {
+                lookahead_ = std::move(message);
+                break;
+            }
+            result.push_back(std::move(*message));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Read messages of steps from @p first_step to @p last_step excluding the last one.
+     * 
+     * @param first_step first step of the range.
+     * @param last_step step after the last step of the range.
+     * 
+     * @return messages of the range.
+     */
+    std::vector<core::messaging::SpikeMessage> read_steps(core::Step first_step, core::Step last_step)
+    {
+        seek(first_step);
+        return read_until(last_step);
+    }
+
+    /**
+     * @brief Get iterator to the next message.
+     * 
+     * @return iterator.
+     */
+    SpikeMessageIterator begin() { return SpikeMessageIterator(*this); }
+
+    /**
+     * @brief Get end iterator.
+     * 
+     * @return end iterator.
+     */
+    SpikeMessageIterator end() { return {}; }
+
+protected:
+    /**
+     * @brief Read the next message from storage.
+     * 
+     * @return message or nothing if there are no more messages.
+     */
+    virtual std::optional<core::messaging::SpikeMessage> read_message() = 0;
+
+    /**
+     * @brief Move storage position to the first message with the given or a later step.
+     * 
+     * @param step step.
+     */
+    virtual void seek_message(core::Step step) = 0;
+
+private:
+    std::optional<core::messaging::SpikeMessage> lookahead_;
+};
+
+
+/**
+ * @brief Base class of writers that save spike messages to storage incrementally.
+ * 
+ * @details Messages must be written in the order of steps. Writers keep a bounded buffer and flush it to storage.
+ */
+class SpikeMessageWriter
+{
+public:
+    /**
+     * @brief Default virtual destructor.
+     */
+    virtual ~SpikeMessageWriter() = default;
+
+public:
+    /**
+     * @brief Write a message.
+     * 
+     * @param message spike message.
+     */
+    virtual void write(const core::messaging::SpikeMessage &message) = 0;
+
+    /**
+     * @brief Write buffered messages to storage.
+     */
+    virtual void flush() = 0;
+
+    /**
+     * @brief Write a range of messages.
+     * 
+     * @tparam InputIterator type of message iterator.
+     * 
+     * @param first iterator to the first message.
+     * @param last iterator past the last message.
+     */
+    template <class InputIterator>
+    void write(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first) write(*first);
+    }
+};
+
+
+inline SpikeMessageIterator::SpikeMessageIterator(SpikeMessageReader &reader)
+    : reader_(&reader), message_(reader.read())
+{
+}
+
+
+inline SpikeMessageIterator &SpikeMessageIterator::operator++()
+{
+    message_ = reader_->read();
+    return *this;
+}
+
+}  // namespace knp::framework::io::storage::native
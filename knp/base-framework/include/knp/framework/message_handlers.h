@@ -23,9 +23,9 @@
 #include <knp/core/impexp.h>
 #include <knp/core/message_endpoint.h>
 #include <knp/core/messaging/messaging.h>
+#include <knp/framework/random/philox.h>
 
 #include <algorithm>
-#include <random>
 #include <string>
 #include <utility>
 #include <vector>
@@ -51,11 +51,14 @@ public:
      * 
      * @param winners_number maximum number of groups to pass spikes further.
      * @param seed random generator seed.
+     * @param uid UID of the message handler that uses the functor. Handlers with the same seed and different UIDs
+     * select spikes independently.
      * 
-     * @note The constructor uses `mt19937` generator algorithm for random number generation.
+     * @note The handler uses a counter-based generator keyed by @p seed, @p uid and the message step, so the result
+     * does not depend on the call order.
      */
-    explicit KWtaRandomHandler(size_t winners_number = 1, int seed = 0)
-        : num_winners_(winners_number), random_engine_(seed)
+    explicit KWtaRandomHandler(size_t winners_number = 1, int seed = 0, const core::UID &uid = core::UID{false})
+        : num_winners_(winners_number), random_(static_cast<uint64_t>(seed), uid)
     {
     }
 
@@ -73,7 +76,7 @@ public:
 
 private:
     size_t num_winners_;
-    std::mt19937 random_engine_;
+    random::CounterBasedRandom random_;
 };
 
 
@@ -97,14 +100,17 @@ public:
      * each group.
      * @param num_winning_groups maximum number of groups that can pass their spikes further.
      * @param seed random generator seed.
+     * @param uid UID of the message handler that uses the functor. Handlers with the same seed and different UIDs
+     * select spikes independently.
      * 
      * @details For example, we have a set of spike messages 0, 1, 2, 3, 4, 5. If @p group_borders 
      * is {2, 4}, the set of spike messages will be divided into the following groups: 
      * [0, 1], [2, 3], and [4, 5].
      */
     explicit GroupWtaRandomHandler(
-        const std::vector<size_t> &group_borders, size_t num_winning_groups = 1, int seed = 0)
-        : group_borders_(group_borders), num_winners_(num_winning_groups), random_engine_(seed)
+        const std::vector<size_t> &group_borders, size_t num_winning_groups = 1, int seed = 0,
+        const core::UID &uid = core::UID{false})
+        : group_borders_(group_borders), num_winners_(num_winning_groups), random_(static_cast<uint64_t>(seed), uid)
     {
         std::sort(group_borders_.begin(), group_borders_.end());
     }
@@ -122,8 +128,7 @@ public:
 private:
     std::vector<size_t> group_borders_;
     size_t num_winners_;
-    std::mt19937 random_engine_;
-    std::uniform_int_distribution<size_t> distribution_;
+    random::CounterBasedRandom random_;
 };
 
 
@@ -143,13 +148,19 @@ public:
      * each group.
      * @param winners_per_group number of spikes to pass further from each group.
      * @param seed random generator seed.
+     * @param uid UID of the message handler that uses the functor. Handlers with the same seed and different UIDs
+     * select spikes independently.
      * 
      * @details For example, we have a set of spike messages 0, 1, 2, 3, 4, 5. If @p group_borders 
      * is {2, 4}, the set of spike messages will be divided into the following groups: 
      * [0, 1], [2, 3], and [4, 5].
      */
-    explicit KWtaPerGroup(const std::vector<size_t> &group_borders, size_t winners_per_group = 1, int seed = 0)
-        : group_borders_(group_borders), winners_per_group_(winners_per_group), random_engine_(seed)
+    explicit KWtaPerGroup(
+        const std::vector<size_t> &group_borders, size_t winners_per_group = 1, int seed = 0,
+        const core::UID &uid = core::UID{false})
+        : group_borders_(group_borders),
+          winners_per_group_(winners_per_group),
+          random_(static_cast<uint64_t>(seed), uid)
     {
         std::sort(group_borders_.begin(), group_borders_.end());
     }
@@ -167,7 +178,7 @@ public:
 private:
     std::vector<size_t> group_borders_;
     size_t winners_per_group_;
-    std::mt19937 random_engine_;
+    random::CounterBasedRandom random_;
 };
 
 /**
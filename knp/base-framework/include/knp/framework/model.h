@@ -128,6 +128,26 @@ public:
         add_output_channel(channel_uid, population.get_uid());
     }
 
+    /**
+     * @brief Set retention window of an output channel.
+     * 
+     * @param channel_uid UID of the output channel.
+     * @param retention_steps number of latest steps whose messages are kept in the channel.
+     * 
+     * @details The window is passed to the channel when the model is loaded.
+     */
+    void set_output_channel_retention(const core::UID &channel_uid, size_t retention_steps);
+
+    /**
+     * @brief Get retention window of an output channel.
+     * 
+     * @param channel_uid UID of the output channel.
+     * 
+     * @return number of latest steps whose messages are kept in the channel or
+     * `io::output::OutputChannel::unlimited_retention` if the window isn't set.
+     */
+    [[nodiscard]] size_t get_output_channel_retention(const core::UID &channel_uid) const;
+
     /**
      * @brief Get all input channels UIDs.
      * 
@@ -146,6 +166,7 @@ private:
     knp::framework::Network network_;
     std::unordered_multimap<core::UID, core::UID, core::uid_hash> in_channels_;
     std::unordered_multimap<core::UID, core::UID, core::uid_hash> out_channels_;
+    std::unordered_map<core::UID, size_t, core::uid_hash> out_retention_steps_;
 };
 
 }  // namespace knp::framework
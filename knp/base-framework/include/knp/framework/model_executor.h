@@ -89,12 +89,20 @@ public:
      * 
      * @param message_processor functor to process received messages.
      * @param senders list of observed entities.
+     * @param queue_size maximum number of steps with messages waiting for processing in a background thread. If `0`,
+     * messages are processed on the simulation thread.
+     * @param stop_handler functor called when model execution stops, after all messages are processed.
+     * 
+     * @details Asynchronous observers process all queued messages before `start()` returns.
      */
     template <class Message>
-    void add_observer(monitoring::MessageProcessor<Message> &&message_processor, const std::vector<core::UID> &senders)
+    void add_observer(
+        monitoring::MessageProcessor<Message> &&message_processor, const std::vector<core::UID> &senders,
+        size_t queue_size = 0, std::function<void()> &&stop_handler = {})
     {
         observers_.emplace_back(monitoring::MessageObserver<Message>(
-            get_backend()->get_message_bus().create_endpoint(), std::move(message_processor), core::UID{true}));
+            get_backend()->get_message_bus().create_endpoint(), std::move(message_processor), core::UID{true},
+            queue_size, std::move(stop_handler)));
 
         std::visit([&senders](auto &entity) { entity.subscribe(senders); }, observers_.back());
     }
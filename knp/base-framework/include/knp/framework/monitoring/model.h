@@ -23,10 +23,13 @@
 #include <knp/core/impexp.h>
 #include <knp/core/messaging/messaging.h>
 #include <knp/core/uid.h>
+#include <knp/framework/io/storage/native/spike_message_stream.h>
 #include <knp/framework/model_executor.h>
 #include <knp/framework/monitoring/observer.h>
 
+#include <filesystem>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -43,6 +46,23 @@ namespace knp::framework::monitoring::model
 using SpikeProcessor = knp::framework::monitoring::MessageProcessor<knp::core::messaging::SpikeMessage>;
 
 
+/**
+ * @brief Recorded spikes of one message.
+ */
+struct SpikeRecord
+{
+    /**
+     * @brief Header of the spike message.
+     */
+    knp::core::messaging::MessageHeader header_;
+
+    /**
+     * @brief Spike indexes stored in a compact encoding.
+     */
+    knp::core::messaging::CompactSpikeData spikes_;
+};
+
+
 /**
  * @brief Add a logger that outputs spikes in aggregated format.
  * 
@@ -52,14 +72,18 @@ using SpikeProcessor = knp::framework::monitoring::MessageProcessor<knp::core::m
  * @param spike_accumulator buffer for accumulating spike counts between logging intervals.
  * @param log_stream output stream to write aggregated spike counts.
  * @param logging_period interval between logging operations.
+ * @param queue_size maximum number of aggregated results waiting to be written in a background thread. If `0`,
+ * results are written on the simulation thread.
  * 
  * @details The function sets up an observer that aggregates spike counts from specified senders and 
- * writes the aggregated results to the provided output stream at regular intervals.
+ * writes the aggregated results to the provided output stream at regular intervals. Spikes are always counted on
+ * the simulation thread. If the logger is asynchronous, the stream must not be used by other code until model
+ * execution stops.
  */
 KNP_DECLSPEC void add_aggregated_spikes_logger(
     const knp::framework::Model &model, const std::map<knp::core::UID, std::string> &senders_names,
     knp::framework::ModelExecutor &model_executor, std::map<std::string, size_t> &spike_accumulator,
-    std::ostream &log_stream, size_t logging_period);
+    std::ostream &log_stream, size_t logging_period, size_t queue_size = 0);
 
 
 /**
@@ -78,19 +102,112 @@ KNP_DECLSPEC void add_projection_weights_logger(
     size_t logging_period);
 
 
+/**
+ * @brief Format of synaptic weight files.
+ */
+enum class WeightsFileFormat
+{
+    /**
+     * @brief Packed little-endian binary format with a small header.
+     * 
+     * @details The file starts with a 16-byte header: `uint32` magic number `2682`, `uint32` format version `1` and
+     * `uint64` number of synapses `N`. The header is followed by `N` `uint32` target neuron indexes and `N` `uint32`
+     * source neuron indexes, synapses are sorted by target and then by source. Each record then contains `uint64`
+     * step, `N` `uint64` steps of the last synapse updates and `N` `float32` weights, padded with zeros to a multiple of
+     * 8 bytes. The number of records is defined by the file size.
+     */
+    raw,
+
+    /**
+     * @brief HDF5 format.
+     * 
+     * @details The "weights" group contains "target_ids" and "source_ids" datasets with `N` values, the "steps"
+     * dataset with a step per record, and the "values" and "last_update_steps" datasets of `records x N` size. A chunk
+     * of the datasets contains several records of up to 1 MiB in total, and chunks can be compressed.
+     */
+    hdf5
+};
+
+
+/**
+ * @brief Add a writer that saves synaptic weights from a specific projection to a binary file.
+ * 
+ * @param path_to_save path to weights file. An existing file is overwritten.
+ * @param model_executor model executor.
+ * @param uid UID of the projection to monitor.
+ * @param logging_period interval between logging operations.
+ * @param format file format.
+ * @param compression_level deflate compression level from `1` to `9` for the HDF5 format, `0` disables compression.
+ * @param queue_size maximum number of records waiting to be written in a background thread. If `0`, records are
+ * written on the simulation thread.
+ * 
+ * @details The function sets up an observer that saves weights and steps of the last updates of all projection
+ * synapses at regular intervals. Each record is written with a single call, so a record of millions of synapses does
+ * not require text formatting. Records are buffered and written to the file in batches, and all records are written
+ * when model execution stops. If the writer is asynchronous, weights are copied on the simulation thread, and the
+ * copy is written in a background thread.
+ * 
+ * @throw std::invalid_argument if compression is requested for the raw format.
+ */
+KNP_DECLSPEC void add_projection_weights_writer(
+    const std::filesystem::path &path_to_save, knp::framework::ModelExecutor &model_executor,
+    const knp::core::UID &uid, size_t logging_period, WeightsFileFormat format = WeightsFileFormat::raw,
+    unsigned compression_level = 0, size_t queue_size = 0);
+
+
+/**
+ * @brief Add a writer that saves spikes of the specified senders with a spike message writer.
+ * 
+ * @param model_executor model executor.
+ * @param senders UIDs of senders that will have spike observer attached to them.
+ * @param writer spike message writer, for example `RasterSpikeMessageWriter` for a packed binary file or
+ * `H5SpikeMessageWriter` for an HDF5 file.
+ * @param queue_size maximum number of steps with spikes waiting to be written in a background thread. If `0`, spikes
+ * are written on the simulation thread.
+ * 
+ * @details Messages of different senders are written by the same writer, so use a separate writer for each sender
+ * if sender UIDs must be preserved. Writers buffer spikes, and the file is complete only after the writer is closed
+ * with its `close()` method or destroyed. The model executor shares ownership of the writer, so call `close()` after
+ * model execution stops or release both the writer and the model executor.
+ */
+KNP_DECLSPEC void add_spikes_writer(
+    knp::framework::ModelExecutor &model_executor, const std::vector<knp::core::UID> &senders,
+    std::shared_ptr<knp::framework::io::storage::native::SpikeMessageWriter> writer, size_t queue_size = 0);
+
+
 /**
  * @brief Add a logger that outputs all spike messages with detailed information.
  * 
  * @param model_executor model executor.
  * @param senders_names UID-name mapping of senders that will have spike observer attached to them.
  * @param log_stream output stream to write spike messages.
+ * @param queue_size maximum number of steps with spikes waiting to be written in a background thread. If `0`, spikes
+ * are written on the simulation thread.
  * 
  * @details The function sets up an observer that captures all spike messages from the specified senders and
- * writes detailed spike information to the provided output stream.
+ * writes detailed spike information to the provided output stream. If the logger is asynchronous, the stream must
+ * not be used by other code until model execution stops.
  */
 KNP_DECLSPEC void add_spikes_logger(
     knp::framework::ModelExecutor &model_executor, const std::map<knp::core::UID, std::string> &senders_names,
-    std::ostream &log_stream);
+    std::ostream &log_stream, size_t queue_size = 0);
+
+
+/**
+ * @brief Add a recorder that stores spikes of the specified senders in memory.
+ * 
+ * @param model_executor model executor.
+ * @param senders UIDs of senders that will have spike observer attached to them.
+ * @param records container to which spike records are added.
+ * @param queue_size maximum number of steps with spikes waiting to be recorded in a background thread. If `0`, spikes
+ * are recorded on the simulation thread.
+ * 
+ * @details Spike indexes are stored in the most compact encoding for their density, so long recordings take less
+ * memory than spike messages. If the recorder is asynchronous, @p records can be read after model execution stops.
+ */
+KNP_DECLSPEC void add_spikes_recorder(
+    knp::framework::ModelExecutor &model_executor, const std::vector<knp::core::UID> &senders,
+    std::vector<SpikeRecord> &records, size_t queue_size = 0);
 
 
 /**
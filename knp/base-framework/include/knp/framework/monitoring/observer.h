@@ -22,13 +22,19 @@
 #include <knp/core/impexp.h>
 #include <knp/core/message_endpoint.h>
 #include <knp/core/messaging/messaging.h>
+#include <knp/framework/spsc_queue.h>
 
+#include <atomic>
+#include <exception>
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <boost/mp11.hpp>
@@ -48,12 +54,130 @@ template <class Message>
 using MessageProcessor = std::function<void(const std::vector<Message> &)>;
 
 
+/**
+ * @brief The AsyncProcessor class is a definition of a background thread that processes values in the order in which
+ * they are added.
+ * 
+ * @tparam T type of processed values.
+ * 
+ * @details Values are passed to the thread through a bounded single-producer single-consumer queue. If the queue is
+ * full, `push()` waits until the thread processes the oldest values, so no values are lost. The thread starts on the
+ * first `push()` and processes all queued values before it stops.
+ */
+template <class T>
+class AsyncProcessor
+{
+public:
+    /**
+     * @brief Constructor.
+     * 
+     * @param processor functor to process values.
+     * @param queue_size maximum number of values waiting for processing.
+     */
+    AsyncProcessor(std::function<void(const T &)> &&processor, size_t queue_size)
+        : process_(std::move(processor)), values_(queue_size)
+    {
+    }
+
+    /**
+     * @brief Destructor. Queued values are processed before the thread stops.
+     */
+    ~AsyncProcessor() { stop_thread(); }
+
+    /**
+     * @brief Queue a value for processing.
+     * 
+     * @param value value to process.
+     * 
+     * @details The method rethrows an exception thrown by the processing functor.
+     */
+    void push(T &&value)
+    {
+        if (!thread_.joinable()) thread_ = std::thread([this] { run(); });
+
+        // The queue is not drained after a processing error.
+        if (is_failed_.load(std::memory_order_acquire) ||
+            !values_.push(std::move(value), [this] { return is_failed_.load(std::memory_order_acquire); }))
+        {
+            stop_thread();
+            rethrow_error();
+        }
+    }
+
+    /**
+     * @brief Process all queued values and stop the thread.
+     * 
+     * @details The thread starts again on the next `push()`. An exception thrown by the processing functor is
+     * rethrown.
+     */
+    void stop()
+    {
+        stop_thread();
+        rethrow_error();
+    }
+
+private:
+    void run()
+    {
+        T value;
+        // Queued values are processed before the thread stops.
+        while (values_.pop(value, [this] { return is_stopped_.load(std::memory_order_acquire); }))
+        {
+            try
+            {
+                process_(value);
+            }
+            catch (...)
+            {
+                error_ = std::current_exception();
+                is_failed_.store(true, std::memory_order_release);
+                values_.notify();
+                return;
+            }
+            value = T{};
+        }
+    }
+
+    void stop_thread()
+    {
+        if (!thread_.joinable()) return;
+        is_stopped_.store(true, std::memory_order_release);
+        values_.notify();
+        thread_.join();
+
+        // Values that were not processed after an error are dropped.
+        values_.clear();
+        is_stopped_.store(false, std::memory_order_relaxed);
+    }
+
+    void rethrow_error()
+    {
+        if (!error_) return;
+        is_failed_.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+    std::function<void(const T &)> process_;
+    SpscQueue<T> values_;
+    std::atomic<bool> is_stopped_ = false;
+    std::atomic<bool> is_failed_ = false;
+    std::exception_ptr error_;
+    std::thread thread_;
+};
+
+
 /**
  * @brief The MessageObserver class is a definition of an observer that receives messages and processes them.
  * 
  * @tparam Message message type that is processed by an observer.
  * 
  * @note Use this class for statistics calculation or for information output.
+ * 
+ * @details In asynchronous mode, `update()` moves received messages to a bounded single-producer single-consumer
+ * queue, and the processing functor is called in a background thread in the order of updates. If the queue is full,
+ * `update()` waits until the background thread processes the oldest messages, so no messages are lost. The processing
+ * functor must not access objects that the simulation thread modifies, for example backend state. Queued messages are
+ * processed before the observer is destroyed.
  */
 template <class Message>
 class MessageObserver
@@ -65,11 +189,19 @@ public:
      * @param endpoint endpoint from which to get messages.
      * @param processor functor to process messages.
      * @param uid observer UID.
+     * @param queue_size maximum number of updates waiting for processing in a background thread. If `0`, messages are
+     * processed synchronously in `update()`.
+     * @param stop_handler functor called by `stop()` after all messages are processed, for example to flush output.
      */
     MessageObserver(
-        core::MessageEndpoint &&endpoint, MessageProcessor<Message> &&processor, core::UID uid = core::UID{true})
-        : endpoint_(std::move(endpoint)), process_messages_(processor), base_data_{uid}
+        core::MessageEndpoint &&endpoint, MessageProcessor<Message> &&processor, core::UID uid = core::UID{true},
+        size_t queue_size = 0, std::function<void()> &&stop_handler = {})
+        : endpoint_(std::move(endpoint)), stop_handler_(std::move(stop_handler)), base_data_{uid}
     {
+        if (queue_size)
+            async_queue_ = std::make_unique<AsyncProcessor<std::vector<Message>>>(std::move(processor), queue_size);
+        else
+            process_messages_ = std::move(processor);
     }
 
     /**
@@ -93,14 +225,39 @@ public:
 
     /**
      * @brief Receive and process messages.
+     * 
+     * @details In asynchronous mode, the method queues messages for processing and rethrows an exception thrown by
+     * the processing functor.
      */
     void update()
     {
         endpoint_.receive_all_messages();
         auto messages_raw = endpoint_.unload_messages<Message>(base_data_.uid_);
-        process_messages_(messages_raw);
+        if (async_queue_)
+            async_queue_->push(std::move(messages_raw));
+        else
+            process_messages_(messages_raw);
+    }
+
+    /**
+     * @brief Process all queued messages, stop the background thread and call the stop handler.
+     * 
+     * @details In asynchronous mode, the background thread starts again on the next update. An exception thrown by
+     * the processing functor or the stop handler is rethrown.
+     */
+    void stop()
+    {
+        if (async_queue_) async_queue_->stop();
+        if (stop_handler_) stop_handler_();
     }
 
+    /**
+     * @brief Check whether messages are processed in a background thread.
+     * 
+     * @return `true` if the observer is asynchronous.
+     */
+    [[nodiscard]] bool is_async() const { return static_cast<bool>(async_queue_); }
+
     /**
      * @brief Get observer UID.
      * 
@@ -111,7 +268,10 @@ public:
 private:
     core::MessageEndpoint endpoint_;
     MessageProcessor<Message> process_messages_;
+    std::function<void()> stop_handler_;
     core::BaseData base_data_;
+    // The queue is allocated separately, so that the background thread is not affected by observer moves.
+    std::unique_ptr<AsyncProcessor<std::vector<Message>>> async_queue_;
 };
 
 /**
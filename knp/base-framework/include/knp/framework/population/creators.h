@@ -64,17 +64,20 @@ template <typename NeuronType, template <typename...> class Container>
  * @tparam NeuronType type of neuron parameters.
  * 
  * @param neuron_count number of neurons in a population.
+ * @param seed random generator seed.
+ * @param uid population UID. Populations created with the same seed and UID have the same parameter values.
  * 
  * @return population.
  * 
- * @details This generator uses MT19937 RNG with uniform integer distribution.
+ * @details This generator uses a counter-based RNG keyed by @p seed and @p uid.
  * 
  * @warning Neuron parameter values are absolutely random: generator doesn't pay attention to the limits.
  */
 template <typename NeuronType>
-[[nodiscard]] typename core::Population<NeuronType> make_random(size_t neuron_count)
+[[nodiscard]] typename core::Population<NeuronType> make_random(
+    size_t neuron_count, uint64_t seed = 0, const core::UID &uid = core::UID{})
 {
-    return core::Population<NeuronType>(neurons_generators::MakeRandom<NeuronType>(), neuron_count);
+    return core::Population<NeuronType>(uid, neurons_generators::MakeRandom<NeuronType>(seed, uid), neuron_count);
 }
 
 
@@ -20,10 +20,12 @@
 #pragma once
 
 #include <knp/core/population.h>
+#include <knp/framework/random/philox.h>
 
+#include <algorithm>
 #include <cinttypes>
+#include <cstring>
 #include <optional>
-#include <random>
 
 
 /**
@@ -62,7 +64,8 @@ template <typename NeuronType, template <typename...> class Container>
  * 
  * @tparam NeuronType type of neuron parameters.
  * 
- * @details This generator uses MT19937 RNG with uniform integer distribution.
+ * @details This generator uses a counter-based RNG: parameter values are a function of the seed, the population UID
+ * and the neuron index, so neurons can be generated in any order.
  * 
  * @warning Neuron parameter values are absolutely random: generator doesn't pay attention to the limits.
  */
@@ -72,8 +75,11 @@ class MakeRandom
 public:
     /**
      * @brief Constructor.
+     * 
+     * @param seed random generator seed.
+     * @param uid UID of the population. Populations with the same seed and different UIDs get different values.
      */
-    MakeRandom() : mt_(std::random_device()()), dist_(0, 255) {}
+    explicit MakeRandom(uint64_t seed = 0, const core::UID& uid = core::UID{false}) : random_(seed, uid) {}
 
     /**
      * @brief Call operator.
@@ -82,16 +88,22 @@ public:
      * 
      * @return optional neuron parameters.
      */
-    [[nodiscard]] typename core::Population<NeuronType>::NeuronParameters operator()(size_t index)
+    [[nodiscard]] typename core::Population<NeuronType>::NeuronParameters operator()(size_t index) const
     {
         typename core::Population<NeuronType>::NeuronParameters params;
-        for (size_t i = 0; i < sizeof(params); ++i) reinterpret_cast<uint8_t*>(&params)[i] = dist_(mt_);
+        auto* params_data = reinterpret_cast<uint8_t*>(&params);
+        // Each generated block fills the next bytes of the parameters.
+        for (size_t offset = 0, block_index = 0; offset < sizeof(params); offset += block_size, ++block_index)
+        {
+            const auto block = random_(index, block_index);
+            std::memcpy(params_data + offset, block.data(), std::min(block_size, sizeof(params) - offset));
+        }
         return params;
     }
 
 private:
-    std::mt19937 mt_;
-    std::uniform_int_distribution<int> dist_;
+    static constexpr size_t block_size = sizeof(random::CounterBasedRandom::Block);
+    random::CounterBasedRandom random_;
 };
 
 
@@ -26,7 +26,6 @@
 #include <exception>
 #include <functional>
 #include <optional>
-#include <random>
 #include <tuple>
 
 #include "synapse_generators.h"
@@ -232,6 +231,9 @@ template <typename SynapseType, template <typename, typename, typename...> class
  * @param postsynaptic_pop_size postsynaptic population size.
  * @param connection_probability probability of a connection between two neurons.
  * @param syn_gen generator of synapse parameters.
+ * @param seed random generator seed.
+ * @param uid projection UID. Projections created with the same seed and UID have the same connections, projections
+ * with different UIDs are connected independently.
  * 
  * @return projection.
  * 
@@ -246,13 +248,15 @@ template <typename SynapseType>
     const knp::core::UID &presynaptic_uid, const knp::core::UID &postsynaptic_uid, size_t presynaptic_pop_size,
     size_t postsynaptic_pop_size, double connection_probability,
     parameters_generators::SynGen2ParamsType<SynapseType> syn_gen =
-        parameters_generators::default_synapse_gen_2param<SynapseType>)
+        parameters_generators::default_synapse_gen_2param<SynapseType>,
+    uint64_t seed = 0, const knp::core::UID &uid = knp::core::UID{})
 {
     const auto proj_size = presynaptic_pop_size * postsynaptic_pop_size;
     auto fp = synapse_generators::FixedProbability<SynapseType>{
-        presynaptic_pop_size, postsynaptic_pop_size, connection_probability, syn_gen};
+        presynaptic_pop_size, postsynaptic_pop_size, connection_probability, syn_gen,
+        random::CounterBasedRandom{seed, uid}};
 
-    return knp::core::Projection<SynapseType>(presynaptic_uid, postsynaptic_uid, fp, proj_size);
+    return knp::core::Projection<SynapseType>(uid, presynaptic_uid, postsynaptic_uid, fp, proj_size);
 }
 
 
@@ -300,10 +304,13 @@ template <typename SynapseType>
  * @param postsynaptic_pop_size postsynaptic population size.
  * @param neurons_count number of postsynaptic neurons.
  * @param syn_gen generator of synapse parameters.
+ * @param seed random generator seed.
+ * @param uid projection UID. Projections created with the same seed and UID have the same connections, projections
+ * with different UIDs are connected independently.
  * 
  * @return projection.
  * 
- * @details This connector uses MT19937 generator with uniform integer distribution.
+ * @details This connector uses a counter-based generator with uniform integer distribution.
  * 
  * @note The actual number of connections in the projection may vary depending on the number of postsynaptic neurons
  * available.
@@ -315,13 +322,15 @@ template <typename SynapseType>
     const knp::core::UID &presynaptic_uid, const knp::core::UID &postsynaptic_uid, size_t presynaptic_pop_size,
     size_t postsynaptic_pop_size, size_t neurons_count,
     parameters_generators::SynGen2ParamsType<SynapseType> syn_gen =
-        parameters_generators::default_synapse_gen_2param<SynapseType>)
+        parameters_generators::default_synapse_gen_2param<SynapseType>,
+    uint64_t seed = 0, const knp::core::UID &uid = knp::core::UID{})
 {
     const auto proj_size = presynaptic_pop_size * neurons_count;
 
     return knp::core::Projection<SynapseType>(
-        presynaptic_uid, postsynaptic_uid,
-        synapse_generators::FixedNumberPost<SynapseType>(presynaptic_pop_size, postsynaptic_pop_size, syn_gen),
+        uid, presynaptic_uid, postsynaptic_uid,
+        synapse_generators::FixedNumberPost<SynapseType>(
+            presynaptic_pop_size, postsynaptic_pop_size, syn_gen, random::CounterBasedRandom{seed, uid}),
         proj_size);
 }
 
@@ -338,10 +347,13 @@ template <typename SynapseType>
  * @param postsynaptic_pop_size postsynaptic population size.
  * @param neurons_count number of presynaptic neurons.
  * @param syn_gen generator of synapse parameters.
+ * @param seed random generator seed.
+ * @param uid projection UID. Projections created with the same seed and UID have the same connections, projections
+ * with different UIDs are connected independently.
  * 
  * @return projection.
  * 
- * @details This connector uses MT19937 generator with uniform integer distribution.
+ * @details This connector uses a counter-based generator with uniform integer distribution.
  * 
  * @note The actual number of connections in the projection may vary depending on the number of presynaptic neurons
  * available.
@@ -353,13 +365,15 @@ template <typename SynapseType>
     const knp::core::UID &presynaptic_uid, const knp::core::UID &postsynaptic_uid, size_t presynaptic_pop_size,
     size_t postsynaptic_pop_size, size_t neurons_count,
     parameters_generators::SynGen2ParamsType<SynapseType> syn_gen =
-        parameters_generators::default_synapse_gen_2param<SynapseType>)
+        parameters_generators::default_synapse_gen_2param<SynapseType>,
+    uint64_t seed = 0, const knp::core::UID &uid = knp::core::UID{})
 {
     const auto proj_size = postsynaptic_pop_size * neurons_count;
 
     return knp::core::Projection<SynapseType>(
-        presynaptic_uid, postsynaptic_uid,
-        synapse_generators::FixedNumberPre<SynapseType>(presynaptic_pop_size, postsynaptic_pop_size, syn_gen),
+        uid, presynaptic_uid, postsynaptic_uid,
+        synapse_generators::FixedNumberPre<SynapseType>(
+            presynaptic_pop_size, postsynaptic_pop_size, syn_gen, random::CounterBasedRandom{seed, uid}),
         proj_size);
 }
 
@@ -22,12 +22,12 @@
 
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
+#include <knp/framework/random/philox.h>
 
 #include <algorithm>
 #include <exception>
 #include <functional>
 #include <optional>
-#include <random>
 #include <tuple>
 
 #include "synapse_parameters_generators.h"
@@ -267,17 +267,18 @@ public:
      * @param postsynaptic_pop_size postsynaptic population neuron count.
      * @param connection_probability connection probability.
      * @param syn_gen generator of synapse parameters.
+     * @param random counter-based random number generator.
      */
     FixedProbability(
         size_t presynaptic_pop_size, size_t postsynaptic_pop_size, double connection_probability,
         parameters_generators::SynGen2ParamsType<SynapseType> syn_gen =
-            parameters_generators::default_synapse_gen_2param<SynapseType>)
+            parameters_generators::default_synapse_gen_2param<SynapseType>,
+        const random::CounterBasedRandom &random = random::CounterBasedRandom{0, core::UID{}})
         : presynaptic_pop_size_(presynaptic_pop_size),
           postsynaptic_pop_size_(postsynaptic_pop_size),
           connection_probability_(connection_probability),
           syn_gen_(syn_gen),
-          mt_(std::random_device()()),
-          dist_(0, 1)
+          random_(random)
     {
         if (connection_probability > 1 || connection_probability < 0)
             throw std::logic_error("Incorrect probability, set probability between 0 and 1.");
@@ -289,13 +290,17 @@ public:
      * @param index synapse index.
      * 
      * @return optional synapse parameters.
+     * 
+     * @note The result depends only on the generator key and @p index, so synapses can be generated in any order.
      */
-    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(size_t index)
+    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(
+        size_t index) const
     {
         const size_t index0 = index % presynaptic_pop_size_;
         const size_t index1 = index / presynaptic_pop_size_;
 
-        if (dist_(mt_) < connection_probability_) return std::make_tuple(syn_gen_(index0, index1), index0, index1);
+        if (random_.uniform_real(index) < connection_probability_)
+            return std::make_tuple(syn_gen_(index0, index1), index0, index1);
         return std::nullopt;
     }
 
@@ -304,8 +309,7 @@ private:
     size_t postsynaptic_pop_size_;
     double connection_probability_;
     parameters_generators::SynGen2ParamsType<SynapseType> syn_gen_;
-    std::mt19937 mt_;
-    std::uniform_real_distribution<double> dist_;
+    random::CounterBasedRandom random_;
 };
 
 
@@ -345,7 +349,7 @@ template <typename SynapseType>
  * 
  * @tparam SynapseType projection synapse type.
  * 
- * @details This connector uses MT19937 generator with uniform integer distribution.
+ * @details This connector uses a counter-based generator with uniform integer distribution.
  * 
  * @warning It doesn't get "real" populations and can't be used with populations that contain non-contiguous indexes.
  */
@@ -359,16 +363,17 @@ public:
      * @param presynaptic_pop_size presynaptic population neuron count.
      * @param postsynaptic_pop_size postsynaptic population neuron count.
      * @param syn_gen generator of synapse parameters.
+     * @param random counter-based random number generator.
      */
     FixedNumberPost(
         size_t presynaptic_pop_size, size_t postsynaptic_pop_size,
         std::function<typename knp::core::Projection<SynapseType>::SynapseParameters(size_t index0, size_t index1)>
-            syn_gen = parameters_generators::default_synapse_gen_2param<SynapseType>)
+            syn_gen = parameters_generators::default_synapse_gen_2param<SynapseType>,
+        const random::CounterBasedRandom &random = random::CounterBasedRandom{0, core::UID{}})
         : presynaptic_pop_size_(presynaptic_pop_size),
           postsynaptic_pop_size_(postsynaptic_pop_size),
           syn_gen_(syn_gen),
-          mt_(std::random_device()()),
-          dist_(0, postsynaptic_pop_size - 1)
+          random_(random)
     {
     }
 
@@ -379,10 +384,11 @@ public:
      * 
      * @return optional synapse parameters.
      */
-    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(size_t index)
+    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(
+        size_t index) const
     {
         const size_t index0 = index % presynaptic_pop_size_;
-        const size_t index1 = dist_(mt_);
+        const size_t index1 = random_.uniform_int(index, 0, postsynaptic_pop_size_);
 
         return std::make_tuple(syn_gen_(index0, index1), index0, index1);
     }
@@ -391,8 +397,7 @@ private:
     size_t presynaptic_pop_size_;
     size_t postsynaptic_pop_size_;
     parameters_generators::SynGen2ParamsType<SynapseType> syn_gen_;
-    std::mt19937 mt_;
-    std::uniform_int_distribution<size_t> dist_;
+    random::CounterBasedRandom random_;
 };
 
 
@@ -402,7 +407,7 @@ private:
  * 
  * @tparam SynapseType projection synapse type.
  * 
- * @details This uses MT19937 generator with uniform integer distribution.
+ * @details This connector uses a counter-based generator with uniform integer distribution.
  * 
  * @warning It doesn't get "real" populations and can't be used with populations that contain non-contiguous indexes.
  */
@@ -416,16 +421,17 @@ public:
      * @param presynaptic_pop_size presynaptic population neuron count.
      * @param postsynaptic_pop_size postsynaptic population neuron count.
      * @param syn_gen generator of synapse parameters.
+     * @param random counter-based random number generator.
      */
     FixedNumberPre(
         size_t presynaptic_pop_size, size_t postsynaptic_pop_size,
         std::function<typename knp::core::Projection<SynapseType>::SynapseParameters(size_t index0, size_t index1)>
-            syn_gen = parameters_generators::default_synapse_gen_2param<SynapseType>)
+            syn_gen = parameters_generators::default_synapse_gen_2param<SynapseType>,
+        const random::CounterBasedRandom &random = random::CounterBasedRandom{0, core::UID{}})
         : presynaptic_pop_size_(presynaptic_pop_size),
           postsynaptic_pop_size_(postsynaptic_pop_size),
           syn_gen_(syn_gen),
-          mt_(std::random_device()()),
-          dist_(0, presynaptic_pop_size - 1)
+          random_(random)
     {
     }
 
@@ -436,9 +442,10 @@ public:
      * 
      * @return optional synapse parameters.
      */
-    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(size_t index)
+    [[nodiscard]] typename std::optional<typename knp::core::Projection<SynapseType>::Synapse> operator()(
+        size_t index) const
     {
-        const size_t index0 = dist_(mt_);
+        const size_t index0 = random_.uniform_int(index, 0, presynaptic_pop_size_);
         const size_t index1 = index % postsynaptic_pop_size_;
 
         return std::make_tuple(syn_gen_(index0, index1), index0, index1);
@@ -448,8 +455,7 @@ private:
     size_t presynaptic_pop_size_;
     size_t postsynaptic_pop_size_;
     parameters_generators::SynGen2ParamsType<SynapseType> syn_gen_;
-    std::mt19937 mt_;
-    std::uniform_int_distribution<size_t> dist_;
+    random::CounterBasedRandom random_;
 };
 
 
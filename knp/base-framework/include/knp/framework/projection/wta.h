@@ -41,15 +41,19 @@ namespace knp::framework::projection
  * @param winners_amount number of winners to select for each WTA group.
  * @param borders borders for the WTA behavior, which determine the scope of the WTA competition.
  * @param wta_data vector of pairs, where each pair contains a vector of senders and a vector of receivers for a compound network.
+ * @param seed random generator seed.
  * 
  * @return vector of UIDs for the added WTA handlers.
  * 
  * @details The WTA handlers are added for each compound network specified in @p wta_data which contains pairs of senders 
  * and receivers. @p borders specifies the borders for the WTA behavior, and @p winners_amount specifies the number 
  * of winners to select.
+ * 
+ * Each handler gets its own seed derived from @p seed and the handler position in @p wta_data, so handlers select
+ * winners independently, and calls with the same seed select the same winners.
  */
 KNP_DECLSPEC std::vector<knp::core::UID> add_wta_handlers(
     knp::framework::ModelExecutor& executor, size_t winners_amount, const std::vector<size_t>& borders,
-    const std::vector<std::pair<std::vector<knp::core::UID>, std::vector<knp::core::UID>>>& wta_data);
+    const std::vector<std::pair<std::vector<knp::core::UID>, std::vector<knp::core::UID>>>& wta_data, int seed = 0);
 
 }  // namespace knp::framework::projection
@@ -0,0 +1,289 @@
+/**
+ * @file philox.h
+ * @brief Counter-based random number generator.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/core.h>
+#include <knp/core/uid.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+
+
+/**
+ * @brief Namespace for random number generators.
+ */
+namespace knp::framework::random
+{
+
+/**
+ * @brief Philox4x32-10 block function.
+ * 
+ * @details The function maps a 128-bit counter and a 64-bit key to 128 random bits. Different counters give
+ * statistically independent results, so any element of a random sequence can be generated without generating
+ * the previous ones.
+ * 
+ * @see Salmon J. K. et al. Parallel random numbers: as easy as 1, 2, 3. SC'11.
+ */
+class Philox4x32
+{
+public:
+    /**
+     * @brief Counter and result type.
+     */
+    using Block = std::array<uint32_t, 4>;
+
+    /**
+     * @brief Key type.
+     */
+    using Key = std::array<uint32_t, 2>;
+
+public:
+    /**
+     * @brief Generate a block of random bits.
+     * 
+     * @param counter counter value.
+     * @param key key value.
+     * 
+     * @return 128 random bits.
+     */
+    [[nodiscard]] static constexpr Block generate(Block counter, Key key)
+    {
+        for (int round = 0; round < rounds_count_; ++round)
+        {
+            if (round > 0)
+            {
+                key[0] += weyl_0_;
+                key[1] += weyl_1_;
+            }
+            const uint64_t product_0 = static_cast<uint64_t>(multiplier_0_) * counter[0];
+            const uint64_t product_1 = static_cast<uint64_t>(multiplier_1_) * counter[2];
+            counter = {
+                static_cast<uint32_t>(product_1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(product_1),
+                static_cast<uint32_t>(product_0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(product_0)};
+        }
+        return counter;
+    }
+
+private:
+    static constexpr int rounds_count_ = 10;
+    static constexpr uint32_t multiplier_0_ = 0xD2511F53;
+    static constexpr uint32_t multiplier_1_ = 0xCD9E8D57;
+    static constexpr uint32_t weyl_0_ = 0x9E3779B9;
+    static constexpr uint32_t weyl_1_ = 0xBB67AE85;
+};
+
+
+class CounterBasedEngine;
+
+
+/**
+ * @brief The CounterBasedRandom class is a definition of a stateless random number generator keyed by a seed and
+ * an entity UID.
+ * 
+ * @details A random value is a pure function of `(seed, entity UID, index, step)`. Generators with equal keys return
+ * equal values for equal arguments regardless of the call order or the thread that makes the call. This makes
+ * generation of synapses or selection of spikes parallelizable and bit-reproducible.
+ */
+class CounterBasedRandom
+{
+public:
+    /**
+     * @brief Type of a generated block.
+     */
+    using Block = Philox4x32::Block;
+
+public:
+    /**
+     * @brief Construct a generator.
+     * 
+     * @param seed random seed.
+     * @param uid UID of the entity that uses the generator, for example a projection or a message handler.
+     */
+    explicit CounterBasedRandom(uint64_t seed, const core::UID &uid = core::UID{false}) : key_(make_key(seed, uid)) {}
+
+    /**
+     * @brief Generate a block of random bits for the given element and step.
+     * 
+     * @param index element index, for example a synapse or a neuron index.
+     * @param step network step; use `0` for values that do not depend on step.
+     * 
+     * @return 128 random bits.
+     */
+    [[nodiscard]] Block operator()(uint64_t index, core::Step step = 0) const
+    {
+        return Philox4x32::generate(
+            {static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), static_cast<uint32_t>(step),
+             static_cast<uint32_t>(step >> 32)},
+            key_);
+    }
+
+    /**
+     * @brief Generate a random 64-bit value.
+     * 
+     * @param index element index.
+     * @param step network step.
+     * 
+     * @return random value.
+     */
+    [[nodiscard]] uint64_t uniform_uint64(uint64_t index, core::Step step = 0) const
+    {
+        const Block block = (*this)(index, step);
+        return (static_cast<uint64_t>(block[1]) << 32) | block[0];
+    }
+
+    /**
+     * @brief Generate a random real value uniformly distributed in the `[0, 1)` range.
+     * 
+     * @param index element index.
+     * @param step network step.
+     * 
+     * @return random value.
+     */
+    [[nodiscard]] double uniform_real(uint64_t index, core::Step step = 0) const
+    {
+        // 53 bits fill the double mantissa.
+        return static_cast<double>(uniform_uint64(index, step) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * @brief Generate a random integer value uniformly distributed in the `[0, bound)` range.
+     * 
+     * @param index element index.
+     * @param step network step.
+     * @param bound upper bound of the range, must be greater than `0`.
+     * 
+     * @return random value.
+     */
+    [[nodiscard]] uint64_t uniform_int(uint64_t index, core::Step step, uint64_t bound) const
+    {
+        const uint64_t value = uniform_uint64(index, step);
+        if (bound <= std::numeric_limits<uint32_t>::max())
+        {
+            // Multiply-shift reduction: unbiased enough for 32-bit ranges and cheaper than division.
+            return ((value >> 32) * bound) >> 32;
+        }
+        return value % bound;
+    }
+
+    /**
+     * @brief Create a sequential engine for the given step.
+     * 
+     * @param step network step.
+     * 
+     * @return random bit engine.
+     */
+    [[nodiscard]] CounterBasedEngine engine(core::Step step) const;
+
+private:
+    static constexpr uint64_t mix(uint64_t value)
+    {
+        // SplitMix64 finalizer.
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    static Philox4x32::Key make_key(uint64_t seed, const core::UID &uid)
+    {
+        uint64_t key = mix(seed);
+        for (size_t i = 0; i < uid.tag.size(); i += sizeof(uint64_t))
+        {
+            uint64_t word = 0;
+            for (size_t j = 0; j < sizeof(uint64_t); ++j) word = (word << 8) | uid.tag.data[i + j];
+            key = mix(key ^ word);
+        }
+        return {static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)};
+    }
+
+private:
+    Philox4x32::Key key_;
+};
+
+
+/**
+ * @brief The CounterBasedEngine class is a sequential random bit generator over the counter-based generator.
+ * 
+ * @details Engine meets the `UniformRandomBitGenerator` requirements and can be used with `std::shuffle` and
+ * standard distributions. It enumerates indexes starting from `0` for a fixed step.
+ */
+class CounterBasedEngine
+{
+public:
+    /**
+     * @brief Type of a generated value.
+     */
+    using result_type = uint32_t;
+
+    /**
+     * @brief Engine constructor.
+     * 
+     * @param generator counter-based generator.
+     * @param step step for which values are generated.
+     */
+    CounterBasedEngine(const CounterBasedRandom &generator, core::Step step) : generator_(generator), step_(step) {}
+
+    /**
+     * @brief Get minimum generated value.
+     * 
+     * @return minimum value.
+     */
+    static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+
+    /**
+     * @brief Get maximum generated value.
+     * 
+     * @return maximum value.
+     */
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief Generate next random value.
+     * 
+     * @return random value.
+     */
+    result_type operator()()
+    {
+        if (word_index_ == block_.size())
+        {
+            block_ = generator_(index_++, step_);
+            word_index_ = 0;
+        }
+        return block_[word_index_++];
+    }
+
+private:
+    CounterBasedRandom generator_;
+    core::Step step_;
+    uint64_t index_ = 0;
+    CounterBasedRandom::Block block_{};
+    size_t word_index_ = std::tuple_size_v<CounterBasedRandom::Block>;
+};
+
+
+inline CounterBasedEngine CounterBasedRandom::engine(core::Step step) const
+{
+    return CounterBasedEngine(*this, step);
+}
+
+}  // namespace knp::framework::random
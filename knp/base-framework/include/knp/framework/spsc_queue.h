@@ -0,0 +1,196 @@
+/**
+ * @file spsc_queue.h
+ * @brief Bounded single-producer single-consumer queue.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Framework namespace.
+ */
+namespace knp::framework
+{
+/**
+ * @brief The SpscQueue class is a definition of a bounded queue with one producer thread and one consumer thread.
+ * 
+ * @tparam T element type.
+ * 
+ * @details Elements are passed through a ring buffer without locks. A thread that must wait for free space or
+ * for an element blocks on a condition variable, and the other thread locks the mutex only if somebody waits.
+ * Waiting methods also return when a cancellation predicate becomes `true`. After the state checked by the predicate
+ * is changed, call `notify()` to wake waiting threads.
+ */
+template <class T>
+class SpscQueue
+{
+public:
+    /**
+     * @brief Constructor.
+     * 
+     * @param capacity maximum number of elements in the queue.
+     * 
+     * @throw std::invalid_argument if @p capacity is `0`.
+     */
+    explicit SpscQueue(size_t capacity) : elements_(capacity)
+    {
+        if (!capacity) throw std::invalid_argument("Queue capacity must be positive.");
+    }
+
+    /**
+     * @brief Get maximum number of elements in the queue.
+     * 
+     * @return queue capacity.
+     */
+    [[nodiscard]] size_t capacity() const { return elements_.size(); }
+
+    /**
+     * @brief Add element to the queue if the queue is not full.
+     * 
+     * @param value element to add. The element is not moved if the queue is full.
+     * 
+     * @return `true` if the element was added.
+     * 
+     * @note The method must be called from the producer thread.
+     */
+    bool try_push(T &&value)
+    {
+        const size_t written = written_.load(std::memory_order_relaxed);
+        if (written - read_.load(std::memory_order_acquire) == elements_.size()) return false;
+
+        elements_[written % elements_.size()] = std::move(value);
+        written_.store(written + 1, std::memory_order_release);
+        notify();
+        return true;
+    }
+
+    /**
+     * @brief Add element to the queue, waiting for free space.
+     * 
+     * @param value element to add.
+     * @param is_cancelled predicate that stops waiting if it returns `true`.
+     * 
+     * @return `true` if the element was added, `false` if the queue was full and waiting was cancelled.
+     * 
+     * @note The method must be called from the producer thread.
+     */
+    template <class Cancelled>
+    bool push(T &&value, Cancelled &&is_cancelled)
+    {
+        if (try_push(std::move(value))) return true;
+
+        wait([this, &is_cancelled]
+             { return written_.load(std::memory_order_relaxed) - read_.load() < elements_.size() || is_cancelled(); });
+        return try_push(std::move(value));
+    }
+
+    /**
+     * @brief Extract element from the queue if the queue is not empty.
+     * 
+     * @param value variable to store the element.
+     * 
+     * @return `true` if an element was extracted.
+     * 
+     * @note The method must be called from the consumer thread.
+     */
+    bool try_pop(T &value)
+    {
+        const size_t read = read_.load(std::memory_order_relaxed);
+        if (written_.load(std::memory_order_acquire) == read) return false;
+
+        value = std::move(elements_[read % elements_.size()]);
+        read_.store(read + 1, std::memory_order_release);
+        notify();
+        return true;
+    }
+
+    /**
+     * @brief Extract element from the queue, waiting for an element.
+     * 
+     * @param value variable to store the element.
+     * @param is_cancelled predicate that stops waiting if it returns `true`. Queued elements are extracted even after
+     * cancellation.
+     * 
+     * @return `true` if an element was extracted, `false` if the queue was empty and waiting was cancelled.
+     * 
+     * @note The method must be called from the consumer thread.
+     */
+    template <class Cancelled>
+    bool pop(T &value, Cancelled &&is_cancelled)
+    {
+        if (try_pop(value)) return true;
+
+        wait([this, &is_cancelled]
+             { return written_.load() != read_.load(std::memory_order_relaxed) || is_cancelled(); });
+        return try_pop(value);
+    }
+
+    /**
+     * @brief Wake threads waiting in `push()` or `pop()`, so that they check cancellation predicates again.
+     */
+    void notify()
+    {
+        // Pairs with the fence in `wait()`: either the waiting thread sees the new state or the waiter is counted here.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!waiters_count_.load(std::memory_order_relaxed)) return;
+
+        // Locking the mutex guarantees that the waiting thread is either sleeping or has not checked its predicate yet.
+        { std::lock_guard lock(mutex_); }
+        condition_.notify_all();
+    }
+
+    /**
+     * @brief Remove all elements from the queue.
+     * 
+     * @note The method must not be called while the producer or the consumer uses the queue.
+     */
+    void clear()
+    {
+        for (auto &element : elements_) element = T{};
+        written_.store(0, std::memory_order_relaxed);
+        read_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    template <class Ready>
+    void wait(Ready &&is_ready)
+    {
+        std::unique_lock lock(mutex_);
+        waiters_count_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        condition_.wait(lock, is_ready);
+        waiters_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::vector<T> elements_;
+    // Counters of elements written by the producer and read by the consumer.
+    std::atomic<size_t> written_ = 0;
+    std::atomic<size_t> read_ = 0;
+    std::atomic<size_t> waiters_count_ = 0;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+};
+
+}  // namespace knp::framework
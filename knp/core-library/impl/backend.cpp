@@ -191,4 +191,30 @@ void Backend::select_device(std::unique_ptr<Device>&& device)
     SPDLOG_INFO("Device with UID {} was selected.", std::string(devices_[0]->get_uid()));
 }
 
+
+void Backend::visit_projections(const ProjectionVisitor& visitor) const
+{
+    auto data_ranges = get_network_data();
+    if (!data_ranges.projection_range.first || !data_ranges.projection_range.second) return;
+
+    for (auto& iter = *data_ranges.projection_range.first; iter != *data_ranges.projection_range.second; ++iter)
+    {
+        const auto projection = *iter;
+        std::visit([&visitor](const auto& proj) { visitor(ProjectionConstPointer{&proj}); }, projection);
+    }
+}
+
+
+void Backend::visit_populations(const PopulationVisitor& visitor) const
+{
+    auto data_ranges = get_network_data();
+    if (!data_ranges.population_range.first || !data_ranges.population_range.second) return;
+
+    for (auto& iter = *data_ranges.population_range.first; iter != *data_ranges.population_range.second; ++iter)
+    {
+        const auto population = *iter;
+        std::visit([&visitor](const auto& pop) { visitor(PopulationConstPointer{&pop}); }, population);
+    }
+}
+
 }  // namespace knp::core
@@ -0,0 +1,162 @@
+/**
+ * @file inbox_overflow.h
+ * @brief Handling of endpoint inbox overflows.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/inbox_settings.h>
+#include <knp/core/messaging/message_envelope.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <utility>
+#include <variant>
+#include <vector>
+
+
+/**
+ * @brief Namespace for implementations of message bus.
+ */
+namespace knp::core::messaging::impl
+{
+
+/**
+ * @brief Inbox overflow counters updated by routing and read by endpoint owners.
+ */
+struct AtomicInboxOverflowCounters
+{
+    /**
+     * @brief Get counter values.
+     * @return counters.
+     */
+    [[nodiscard]] InboxOverflowCounters get() const
+    {
+        return {
+            dropped_messages_.load(std::memory_order_relaxed), coalesced_messages_.load(std::memory_order_relaxed),
+            blocked_deliveries_.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @brief Number of dropped messages.
+     */
+    std::atomic<uint64_t> dropped_messages_{0};
+
+    /**
+     * @brief Number of coalesced spike messages.
+     */
+    std::atomic<uint64_t> coalesced_messages_{0};
+
+    /**
+     * @brief Number of deliveries that waited for free space.
+     */
+    std::atomic<uint64_t> blocked_deliveries_{0};
+};
+
+
+/**
+ * @brief Check if a spike message can be merged into a queued message.
+ * @param queued queued message.
+ * @param incoming routed message.
+ * @return `true` if both messages are spike messages of the same sender and step.
+ */
+inline bool can_coalesce(const MessageVariant &queued, const MessageVariant &incoming)
+{
+    const auto *queued_spikes = std::get_if<SpikeMessage>(&queued);
+    const auto *incoming_spikes = std::get_if<SpikeMessage>(&incoming);
+    return queued_spikes && incoming_spikes &&
+           queued_spikes->header_.sender_uid_ == incoming_spikes->header_.sender_uid_ &&
+           queued_spikes->header_.send_time_ == incoming_spikes->header_.send_time_;
+}
+
+
+/**
+ * @brief Append neuron indexes of a spike message to another spike message.
+ * @param target message to append indexes to.
+ * @param source message to take indexes from.
+ */
+inline void coalesce_spikes(MessageVariant &target, const MessageVariant &source)
+{
+    auto &target_indexes = std::get<SpikeMessage>(target).neuron_indexes_;
+    const auto &source_indexes = std::get<SpikeMessage>(source).neuron_indexes_;
+    target_indexes.insert(target_indexes.end(), source_indexes.begin(), source_indexes.end());
+}
+
+
+/**
+ * @brief Check if any message added to an inbox would be dropped.
+ * @details Endpoints use the function to skip unpacking of messages that would be dropped.
+ * @param inbox received messages.
+ * @param settings inbox settings.
+ * @return `true` if the inbox is full and its policy drops new messages.
+ */
+inline bool is_dropping_new_messages(const std::deque<MessageVariant> &inbox, const InboxSettings &settings)
+{
+    return InboxSettings::unlimited != settings.capacity_ && inbox.size() >= settings.capacity_ &&
+           (InboxOverflowPolicy::drop_newest == settings.policy_ || InboxOverflowPolicy::block == settings.policy_);
+}
+
+
+/**
+ * @brief Add a received message to an inbox according to inbox settings.
+ * @details The function is used by endpoints that keep received messages in their own inbox. Such endpoints can't
+ * delay routing, so the `InboxOverflowPolicy::block` policy is handled as `InboxOverflowPolicy::drop_newest`.
+ * @param inbox received messages in the order of arrival.
+ * @param message received message.
+ * @param settings inbox settings.
+ * @param counters overflow counters.
+ */
+inline void push_to_inbox(
+    std::deque<MessageVariant> &inbox, MessageVariant &&message, const InboxSettings &settings,
+    AtomicInboxOverflowCounters &counters)
+{
+    if (InboxSettings::unlimited == settings.capacity_ || inbox.size() < settings.capacity_)
+    {
+        inbox.push_back(std::move(message));
+        return;
+    }
+
+    switch (settings.policy_)
+    {
+        case InboxOverflowPolicy::block:
+        case InboxOverflowPolicy::drop_newest:
+            counters.dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        case InboxOverflowPolicy::coalesce_spikes:
+        {
+            auto queued_iter = std::find_if(
+                inbox.rbegin(), inbox.rend(), [&message](const auto &queued) { return can_coalesce(queued, message); });
+            if (queued_iter != inbox.rend())
+            {
+                coalesce_spikes(*queued_iter, message);
+                counters.coalesced_messages_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            [[fallthrough]];
+        }
+        case InboxOverflowPolicy::drop_oldest:
+            inbox.pop_front();
+            counters.dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+            break;
+    }
+    inbox.push_back(std::move(message));
+}
+
+}  // namespace knp::core::messaging::impl
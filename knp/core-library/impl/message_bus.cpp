@@ -24,9 +24,18 @@
 
 #include <spdlog/spdlog.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
 #include <zmq.hpp>
 
 #include "message_bus_cpu_impl/message_bus_cpu_impl.h"
+#include "message_bus_shm_impl/message_bus_shm_impl.h"
 #include "message_bus_zmq_impl/message_bus_zmq_impl.h"
 
 
@@ -40,6 +49,126 @@ struct make_shared_enabler : public MessageBus
 };
 
 
+namespace
+{
+// Route all sent messages: update the bus and call steps until no messages are left.
+size_t route_all_messages(messaging::impl::MessageBusImpl &impl)
+{
+    auto &metrics_collector = impl.get_metrics_collector();
+    const bool is_metrics_enabled = metrics_collector.is_enabled();
+    const auto routing_start =
+        is_metrics_enabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+    size_t count = 0;
+    impl.update();
+    size_t num_messages = impl.step();
+
+    KNP_UNROLL_LOOP()
+    while (num_messages != 0)
+    {
+        count += num_messages;
+        num_messages = impl.step();
+    }
+
+    if (is_metrics_enabled) metrics_collector.add_routing_cycle(std::chrono::steady_clock::now() - routing_start);
+
+    return count;
+}
+}  // namespace
+
+
+/**
+ * @brief Thread that routes messages continuously.
+ * 
+ * @details Routing cycles are numbered. A fence waits for completion of the first cycle started after the fence was
+ * set, because such a cycle collects all messages sent before the fence.
+ */
+class MessageBus::AsyncRouter
+{
+public:
+    AsyncRouter(messaging::impl::MessageBusImpl &impl, std::chrono::microseconds idle_interval)
+        : impl_(impl), idle_interval_(idle_interval), thread_([this] { run(); })
+    {
+    }
+
+    ~AsyncRouter()
+    {
+        {
+            const std::lock_guard lock(mutex_);
+            is_stop_requested_ = true;
+        }
+        wake_cv_.notify_all();
+        thread_.join();
+    }
+
+    AsyncRouter(const AsyncRouter &) = delete;
+    AsyncRouter &operator=(const AsyncRouter &) = delete;
+
+public:
+    size_t wait_for_routing()
+    {
+        std::unique_lock lock(mutex_);
+        const uint64_t fence_cycle = started_cycles_ + 1;
+        is_fence_set_ = true;
+        wake_cv_.notify_all();
+        done_cv_.wait(lock, [this, fence_cycle] { return completed_cycles_ >= fence_cycle || routing_error_; });
+        if (routing_error_) std::rethrow_exception(routing_error_);
+        return std::exchange(routed_count_, 0);
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock lock(mutex_);
+        while (!is_stop_requested_)
+        {
+            ++started_cycles_;
+            is_fence_set_ = false;
+            lock.unlock();
+
+            size_t count = 0;
+            std::exception_ptr routing_error;
+            try
+            {
+                count = route_all_messages(impl_);
+            }
+            catch (...)
+            {
+                routing_error = std::current_exception();
+            }
+
+            lock.lock();
+            routed_count_ += count;
+            completed_cycles_ = started_cycles_;
+            routing_error_ = routing_error;
+            done_cv_.notify_all();
+            // The thread stops on error, fences rethrow the error.
+            if (routing_error_) break;
+            // Idle cycles are spaced out unless a fence is waiting.
+            if (!count)
+                wake_cv_.wait_for(lock, idle_interval_, [this] { return is_stop_requested_ || is_fence_set_; });
+        }
+    }
+
+private:
+    messaging::impl::MessageBusImpl &impl_;
+    std::chrono::microseconds idle_interval_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+    uint64_t started_cycles_ = 0;
+    uint64_t completed_cycles_ = 0;
+    size_t routed_count_ = 0;
+    bool is_fence_set_ = false;
+    bool is_stop_requested_ = false;
+    std::exception_ptr routing_error_;
+
+    // Thread is started last, when all other members are initialized.
+    std::thread thread_;
+};
+
+
 MessageBus::~MessageBus() = default;
 
 MessageBus::MessageBus(MessageBus &&) noexcept = default;
@@ -57,6 +186,24 @@ std::shared_ptr<MessageBus> MessageBus::construct_zmq_bus()
 }
 
 
+std::shared_ptr<MessageBus> MessageBus::construct_zmq_bus(const ZMQBusSettings &settings)
+{
+    return std::make_shared<make_shared_enabler>(std::make_unique<messaging::impl::MessageBusZMQImpl>(settings));
+}
+
+
+std::shared_ptr<MessageBus> MessageBus::construct_shm_bus()
+{
+    return std::make_shared<make_shared_enabler>(std::make_unique<messaging::impl::MessageBusSHMImpl>());
+}
+
+
+std::shared_ptr<MessageBus> MessageBus::construct_shm_bus(const SHMBusSettings &settings)
+{
+    return std::make_shared<make_shared_enabler>(std::make_unique<messaging::impl::MessageBusSHMImpl>(settings));
+}
+
+
 MessageBus::MessageBus(std::unique_ptr<messaging::impl::MessageBusImpl> &&impl) : impl_(std::move(impl))
 {
     if (!impl_)
@@ -74,6 +221,7 @@ MessageEndpoint MessageBus::create_endpoint()
 
 size_t MessageBus::step()
 {
+    if (async_router_) return async_router_->wait_for_routing();
     return impl_->step();
 }
 
@@ -81,18 +229,46 @@ size_t MessageBus::step()
 size_t MessageBus::route_messages()
 {
     SPDLOG_DEBUG("Message routing cycle started.");
-    size_t count = 0;
-    impl_->update();
-    size_t num_messages = step();
+    if (async_router_) return async_router_->wait_for_routing();
+    return route_all_messages(*impl_);
+}
 
-    KNP_UNROLL_LOOP()
-    while (num_messages != 0)
-    {
-        count += num_messages;
-        num_messages = step();
-    }
 
-    return count;
+void MessageBus::start_async_routing(std::chrono::microseconds idle_interval)
+{
+    if (async_router_) return;
+    if (!impl_->is_async_routing_supported())
+        throw std::logic_error("Message bus implementation doesn't support asynchronous routing.");
+
+    SPDLOG_DEBUG("Starting asynchronous message routing...");
+    impl_->set_async_routing(true);
+    async_router_ = std::make_unique<AsyncRouter>(*impl_, idle_interval);
+}
+
+
+void MessageBus::stop_async_routing()
+{
+    SPDLOG_DEBUG("Stopping asynchronous message routing...");
+    async_router_.reset();
+    impl_->set_async_routing(false);
+}
+
+
+void MessageBus::enable_metrics(bool enable)
+{
+    impl_->get_metrics_collector().enable(enable);
+}
+
+
+MessageBusMetrics MessageBus::get_metrics() const
+{
+    return impl_->get_metrics_collector().get_metrics();
+}
+
+
+void MessageBus::reset_metrics()
+{
+    impl_->get_metrics_collector().reset();
 }
 
 }  // namespace knp::core
@@ -22,6 +22,7 @@
 #include <message_bus_cpu_impl/message_bus_cpu_impl.h>
 #include <message_bus_cpu_impl/message_endpoint_cpu_impl.h>
 
+#include <stdexcept>
 #include <utility>
 
 
@@ -34,7 +35,12 @@ namespace knp::core::messaging::impl
 class MessageEndpointCPU : public MessageEndpoint
 {
 public:
-    explicit MessageEndpointCPU(std::shared_ptr<MessageEndpointCPUImpl> &&ptr) { impl_ = std::move(ptr); }
+    MessageEndpointCPU(std::shared_ptr<MessageEndpointCPUImpl> &&ptr, std::shared_ptr<std::mutex> mutex)
+    {
+        impl_ = std::move(ptr);
+        // Bus reads the sender set under the endpoint mutex.
+        senders_mutex_ = std::move(mutex);
+    }
 };
 
 
@@ -45,21 +51,55 @@ void MessageBusCPUImpl::update()
     auto iter = endpoint_data_.begin();
     while (iter != endpoint_data_.end())
     {
-        auto send_container_ptr = std::get<0>(*iter).lock();
+        auto send_container_ptr = iter->messages_to_send_.lock();
         // Clear up all pointers to expired endpoints.
         if (!send_container_ptr)
         {
-            endpoint_data_.erase(iter++);
+            iter = endpoint_data_.erase(iter);
+            is_routing_table_valid_ = false;
             continue;
         }
 
+        const std::lock_guard endpoint_lock(*iter->mutex_);
         // Read all sent messages to an internal buffer.
         messages_to_route_.insert(
             messages_to_route_.end(), std::make_move_iterator(send_container_ptr->begin()),
             std::make_move_iterator(send_container_ptr->end()));
         send_container_ptr->clear();
+
+        // Check if the endpoint subscribed or unsubscribed since the routing table was built.
+        auto revision_ptr = iter->senders_revision_.lock();
+        if (revision_ptr && *revision_ptr != iter->routed_senders_revision_) is_routing_table_valid_ = false;
         ++iter;
     }
+
+    if (!is_routing_table_valid_) rebuild_routing_table();
+}
+
+
+void MessageBusCPUImpl::rebuild_routing_table()
+{
+    SPDLOG_TRACE("Rebuilding CPU message bus routing table...");
+    sender_handles_.clear();
+    routing_table_.clear();
+    for (size_t endpoint_index = 0; endpoint_index < endpoint_data_.size(); ++endpoint_index)
+    {
+        auto &endpoint_data = endpoint_data_[endpoint_index];
+        // Endpoint changes its senders under the same mutex.
+        const std::lock_guard endpoint_lock(*endpoint_data.mutex_);
+        auto revision_ptr = endpoint_data.senders_revision_.lock();
+        auto allowed_senders_ptr = endpoint_data.senders_.lock();
+        if (!revision_ptr || !allowed_senders_ptr) continue;
+
+        endpoint_data.routed_senders_revision_ = *revision_ptr;
+        for (const auto &sender_uid : *allowed_senders_ptr)
+        {
+            const UIDHandle sender_handle = sender_handles_.intern(sender_uid);
+            if (sender_handle >= routing_table_.size()) routing_table_.resize(sender_handle + 1);
+            routing_table_[sender_handle].push_back(endpoint_index);
+        }
+    }
+    is_routing_table_valid_ = true;
 }
 
 
@@ -67,24 +107,71 @@ size_t MessageBusCPUImpl::step()
 {
     const std::lock_guard lock(mutex_);
     if (messages_to_route_.empty()) return 0;  // No more messages left for endpoints to receive.
-    // Sending a message to every endpoint.
-    auto message = std::move(messages_to_route_.back());
-    // Remove message from container.
-    messages_to_route_.pop_back();
-    const knp::core::UID sender_uid = std::visit([](const auto &msg) { return msg.header_.sender_uid_; }, message);
-    for (auto endpoint_data_containers : endpoint_data_)
+
+    // Routing waits for blocking inboxes under the bus mutex. Synchronous routing is done by the thread that drains
+    // the endpoints, so it would wait for the timeout and drop messages anyway.
+    if (!is_async_routing_.load(std::memory_order_relaxed) &&
+        blocking_inboxes_count_->load(std::memory_order_relaxed) > 0)
+        throw std::logic_error("Inbox overflow policy \"block\" requires asynchronous message routing.");
+
+    // Messages are collected for each endpoint first, so that each endpoint is locked once.
+    std::vector<std::vector<RoutedMessage>> deliveries(endpoint_data_.size());
+
+    // Senders usually send several messages in a row, so the previous sender handle is reused without lookup.
+    knp::core::UID previous_sender_uid{false};
+    UIDHandle sender_handle = UIDInterner::invalid_handle;
+    bool is_first_message = true;
+
+    const bool is_metrics_enabled = metrics_collector_.is_enabled();
+    MessageBusMetricsCollector::SenderCounters *sender_counters = nullptr;
+    size_t deliveries_count = 0;
+
+    for (auto &message : messages_to_route_)
     {
-        auto recv_ptr = std::get<1>(endpoint_data_containers).lock();
-        auto allowed_senders_ptr = std::get<2>(endpoint_data_containers).lock();
-        // Skip all endpoints deleted after previous update(). They will be deleted at the next update().
-        if ((!recv_ptr) || (!allowed_senders_ptr)) continue;
-        if (allowed_senders_ptr->find(sender_uid) != allowed_senders_ptr->end())
+        const knp::core::UID &sender_uid =
+            std::visit([](const auto &msg) -> const knp::core::UID & { return msg.header_.sender_uid_; }, message);
+        if (is_first_message || previous_sender_uid != sender_uid)
+        {
+            sender_handle = sender_handles_.find(sender_uid);
+            previous_sender_uid = sender_uid;
+            is_first_message = false;
+            if (is_metrics_enabled) sender_counters = &metrics_collector_.get_sender_counters(sender_uid);
+        }
+        if (is_metrics_enabled) sender_counters->add_message(get_message_size(message));
+        if (UIDInterner::invalid_handle == sender_handle) continue;
+
+        // All receiving endpoints share one immutable message. A message with a single receiver is owned by it.
+        const auto &receivers = routing_table_[sender_handle];
+        const auto shared_message = std::make_shared<messaging::MessageVariant>(std::move(message));
+        for (const auto endpoint_index : receivers)
         {
-            recv_ptr->emplace_back(message);
+            deliveries[endpoint_index].push_back({shared_message, receivers.size() == 1});
         }
+        deliveries_count += receivers.size();
     }
 
-    return 1;
+    std::vector<size_t> inbox_depths(endpoint_data_.size(), 0);
+    for (size_t endpoint_index = 0; endpoint_index < endpoint_data_.size(); ++endpoint_index)
+    {
+        // Endpoints deleted after previous update() are skipped. They will be deleted at the next update().
+        auto receiver = endpoint_data_[endpoint_index].received_messages_.lock();
+        if (!receiver) continue;
+
+        std::unique_lock endpoint_lock(*endpoint_data_[endpoint_index].mutex_);
+        receiver->push(std::move(deliveries[endpoint_index]), endpoint_lock);
+        inbox_depths[endpoint_index] = receiver->size();
+    }
+
+    const size_t routed_count = messages_to_route_.size();
+    messages_to_route_.clear();
+
+    if (is_metrics_enabled)
+    {
+        metrics_collector_.add_routed_messages(routed_count, deliveries_count);
+        metrics_collector_.update_inbox_depths(inbox_depths);
+    }
+
+    return routed_count;
 }
 
 
@@ -92,13 +179,17 @@ core::MessageEndpoint MessageBusCPUImpl::create_endpoint()
 {
     const std::lock_guard lock(mutex_);
 
-    using VT = std::vector<messaging::MessageVariant>;
-
-    auto messages_to_send_v{std::make_shared<VT>()};
-    auto recv_messages_v{std::make_shared<VT>()};
-
-    auto endpoint = MessageEndpointCPU(std::make_shared<MessageEndpointCPUImpl>(messages_to_send_v, recv_messages_v));
-    endpoint_data_.emplace_back(messages_to_send_v, recv_messages_v, endpoint.get_senders_ptr());
+    auto messages_to_send_v{std::make_shared<std::vector<messaging::MessageVariant>>()};
+    auto recv_messages_v{std::make_shared<MessageInbox>(blocking_inboxes_count_)};
+    auto endpoint_mutex{std::make_shared<std::mutex>()};
+
+    auto endpoint = MessageEndpointCPU(
+        std::make_shared<MessageEndpointCPUImpl>(messages_to_send_v, recv_messages_v, endpoint_mutex),
+        endpoint_mutex);
+    endpoint_data_.push_back(
+        {messages_to_send_v, recv_messages_v, endpoint_mutex, endpoint.get_senders_ptr(),
+         endpoint.get_senders_revision_ptr()});
+    is_routing_table_valid_ = false;
     return std::move(endpoint);
 }
 
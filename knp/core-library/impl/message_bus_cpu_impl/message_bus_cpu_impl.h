@@ -21,15 +21,17 @@
 #pragma once
 
 #include <knp/core/message_bus.h>
+#include <knp/core/uid_interner.h>
 
+#include <message_bus_cpu_impl/message_endpoint_cpu_impl.h>
 #include <message_bus_impl.h>
 
 #include <spdlog/spdlog.h>
 
-#include <list>
+#include <atomic>
 #include <memory>
 #include <mutex>
-#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -52,17 +54,39 @@ public:
     Subscription<MessageType> &subscribe(const UID &receiver, const std::vector<UID> &senders);
     [[nodiscard]] core::MessageEndpoint create_endpoint() override;
 
+private:
+    struct EndpointData
+    {
+        // Messages the endpoint is sending.
+        std::weak_ptr<std::vector<messaging::MessageVariant>> messages_to_send_;
+        // Messages the endpoint is receiving.
+        std::weak_ptr<MessageInbox> received_messages_;
+        // Mutex that guards both message containers and the sender set, shared with the endpoint.
+        std::shared_ptr<std::mutex> mutex_;
+        // Message senders, kept updated by the endpoint when it adds or removes them.
+        std::weak_ptr<std::unordered_set<knp::core::UID, knp::core::uid_hash>> senders_;
+        // Revision of the sender set, changed by the endpoint every time the set changes.
+        std::weak_ptr<const size_t> senders_revision_;
+        // Sender set revision used to build the current routing table.
+        size_t routed_senders_revision_ = 0;
+    };
+
+    void rebuild_routing_table();
+
 private:
     std::vector<knp::core::messaging::MessageVariant> messages_to_route_;
 
-    // This is a list of endpoint data:
-    // First vector is a pointer to a set of messages the endpoint is sending.
-    // Second vector is a set of messages endpoint is receiving.
-    // Third set contains message senders, and is kept updated by endpoints when they add or remove them.
-    std::list<std::tuple<
-        std::weak_ptr<std::vector<messaging::MessageVariant>>, std::weak_ptr<std::vector<messaging::MessageVariant>>,
-        std::weak_ptr<std::unordered_set<knp::core::UID, knp::core::uid_hash>>>>
-        endpoint_data_;
+    std::vector<EndpointData> endpoint_data_;
+
+    // Sender UIDs are interned when the routing table is built, handles index the table.
+    knp::core::UIDInterner sender_handles_;
+    // Sender handle to indexes of subscribed endpoints in `endpoint_data_`.
+    std::vector<std::vector<size_t>> routing_table_;
+    bool is_routing_table_valid_ = false;
+
+    // Number of endpoint inboxes with the `block` overflow policy, shared with the inboxes.
+    std::shared_ptr<std::atomic<size_t>> blocking_inboxes_count_ = std::make_shared<std::atomic<size_t>>(0);
+
     std::mutex mutex_;
 };
 }  // namespace knp::core::messaging::impl
@@ -20,13 +20,18 @@
  */
 #pragma once
 
+#include <inbox_overflow.h>
 #include <message_endpoint_impl.h>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
 #include <memory>
 #include <mutex>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -36,8 +41,190 @@
 namespace knp::core::messaging::impl
 {
 
+/**
+ * @brief Message routed to an endpoint inbox.
+ */
+struct RoutedMessage
+{
+    /**
+     * @brief Message shared between all endpoints that receive it. A shared message must not be modified.
+     */
+    std::shared_ptr<messaging::MessageVariant> message_;
+
+    /**
+     * @brief `true` if the message was routed to a single inbox, so the receiving endpoint owns it.
+     */
+    bool is_exclusive_ = false;
+};
+
+
+/**
+ * @brief Queue of messages routed to an endpoint in the order of routing.
+ * @details The inbox is guarded by the endpoint mutex: all methods except `get_overflow_counters()` must be called
+ * with the mutex locked.
+ */
+class MessageInbox
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param blocking_inboxes_count number of bus inboxes with the `block` policy, the inbox keeps it updated.
+     */
+    explicit MessageInbox(std::shared_ptr<std::atomic<size_t>> blocking_inboxes_count)
+        : blocking_inboxes_count_(std::move(blocking_inboxes_count))
+    {
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~MessageInbox()
+    {
+        if (is_blocking()) blocking_inboxes_count_->fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    MessageInbox(const MessageInbox &) = delete;
+    MessageInbox &operator=(const MessageInbox &) = delete;
+
+    /**
+     * @brief Set inbox capacity and overflow policy.
+     * @param settings inbox settings.
+     */
+    void set_settings(const InboxSettings &settings)
+    {
+        const bool was_blocking = is_blocking();
+        settings_ = settings;
+        if (is_blocking() && !was_blocking) blocking_inboxes_count_->fetch_add(1, std::memory_order_relaxed);
+        if (!is_blocking() && was_blocking) blocking_inboxes_count_->fetch_sub(1, std::memory_order_relaxed);
+        space_cv_.notify_all();
+    }
+
+    /**
+     * @brief Add messages of one routing pass to the inbox applying the overflow policy.
+     * @details If the policy is `InboxOverflowPolicy::block`, the block timeout applies to the whole pass: after
+     * the timeout expires, the rest of the messages are dropped without waiting.
+     * @param messages routed messages.
+     * @param lock lock of the endpoint mutex, it is released while routing waits for free space.
+     */
+    void push(std::vector<RoutedMessage> &&messages, std::unique_lock<std::mutex> &lock)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + settings_.block_timeout_;
+        bool is_timed_out = false;
+        for (auto &message : messages) push(std::move(message), lock, deadline, is_timed_out);
+    }
+
+    /**
+     * @brief Take the oldest message from the inbox.
+     * @return message or an empty message if the inbox is empty.
+     */
+    RoutedMessage pop()
+    {
+        if (messages_.empty()) return {};
+        RoutedMessage message = std::move(messages_.front());
+        messages_.pop_front();
+        space_cv_.notify_all();
+        return message;
+    }
+
+    /**
+     * @brief Take all messages from the inbox.
+     * @return messages in the order of routing.
+     */
+    std::deque<RoutedMessage> take_all()
+    {
+        std::deque<RoutedMessage> result;
+        result.swap(messages_);
+        space_cv_.notify_all();
+        return result;
+    }
+
+    /**
+     * @brief Get number of messages in the inbox.
+     * @return number of messages.
+     */
+    [[nodiscard]] size_t size() const { return messages_.size(); }
+
+    /**
+     * @brief Get overflow counters.
+     * @return counters.
+     */
+    [[nodiscard]] InboxOverflowCounters get_overflow_counters() const { return overflow_counters_.get(); }
+
+private:
+    void push(
+        RoutedMessage &&message, std::unique_lock<std::mutex> &lock,
+        std::chrono::steady_clock::time_point deadline, bool &is_timed_out)
+    {
+        if (!is_full())
+        {
+            messages_.push_back(std::move(message));
+            return;
+        }
+
+        switch (settings_.policy_)
+        {
+            case InboxOverflowPolicy::block:
+                overflow_counters_.blocked_deliveries_.fetch_add(1, std::memory_order_relaxed);
+                if (is_timed_out || !space_cv_.wait_until(lock, deadline, [this] { return !is_full(); }))
+                {
+                    is_timed_out = true;
+                    overflow_counters_.dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                break;
+            case InboxOverflowPolicy::drop_newest:
+                overflow_counters_.dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            case InboxOverflowPolicy::coalesce_spikes:
+                if (coalesce(*message.message_)) return;
+                [[fallthrough]];
+            case InboxOverflowPolicy::drop_oldest:
+                messages_.pop_front();
+                overflow_counters_.dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+                break;
+        }
+        messages_.push_back(std::move(message));
+    }
+
+    [[nodiscard]] bool is_full() const
+    {
+        return InboxSettings::unlimited != settings_.capacity_ && messages_.size() >= settings_.capacity_;
+    }
+
+    [[nodiscard]] bool is_blocking() const
+    {
+        return InboxSettings::unlimited != settings_.capacity_ && InboxOverflowPolicy::block == settings_.policy_;
+    }
+
+    // Merge a spike message into the latest queued spike message of the same sender and step.
+    bool coalesce(const messaging::MessageVariant &message)
+    {
+        for (auto queued_iter = messages_.rbegin(); queued_iter != messages_.rend(); ++queued_iter)
+        {
+            if (!can_coalesce(*queued_iter->message_, message)) continue;
+            // Queued messages may be shared with other endpoints, so the merged message is a new one.
+            auto merged_message = std::make_shared<messaging::MessageVariant>(*queued_iter->message_);
+            coalesce_spikes(*merged_message, message);
+            *queued_iter = {std::move(merged_message), true};
+            overflow_counters_.coalesced_messages_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::deque<RoutedMessage> messages_;
+    InboxSettings settings_;
+    std::condition_variable space_cv_;
+    AtomicInboxOverflowCounters overflow_counters_;
+    std::shared_ptr<std::atomic<size_t>> blocking_inboxes_count_;
+};
+
+
 /**
  * @brief Endpoint implementation class for CPU message bus.
+ * @details Containers of sent and received messages are shared with the bus and guarded by the endpoint mutex, which
+ * is shared with the bus too, so the bus may route messages from another thread.
  * @note It should never be used explicitly.
  */
 class MessageEndpointCPUImpl : public MessageEndpointImpl
@@ -45,41 +232,98 @@ class MessageEndpointCPUImpl : public MessageEndpointImpl
 public:
     MessageEndpointCPUImpl(
         std::shared_ptr<std::vector<messaging::MessageVariant>> messages_to_send,
-        std::shared_ptr<std::vector<messaging::MessageVariant>> received_messages)
-        : messages_to_send_(std::move(messages_to_send)), received_messages_(std::move(received_messages))
+        std::shared_ptr<MessageInbox> received_messages, std::shared_ptr<std::mutex> mutex)
+        : messages_to_send_(std::move(messages_to_send)),
+          received_messages_(std::move(received_messages)),
+          mutex_(std::move(mutex))
     {
         SPDLOG_DEBUG("CPU message endpoint creating...");
     }
 
     void send_message(const knp::core::messaging::MessageVariant &message) override
     {
-        const std::lock_guard lock(mutex_);
+        const std::lock_guard lock(*mutex_);
 
         messages_to_send_->push_back(message);
         SPDLOG_TRACE("Message with type index = {} was sent", message.index());
     }
 
+    void send_messages(std::vector<knp::core::messaging::MessageVariant> &&messages) override
+    {
+        const std::lock_guard lock(*mutex_);
+
+        messages_to_send_->reserve(messages_to_send_->size() + messages.size());
+        std::move(messages.begin(), messages.end(), std::back_inserter(*messages_to_send_));
+        SPDLOG_TRACE("{} messages were sent", messages.size());
+    }
+
     ~MessageEndpointCPUImpl() override = default;
 
     std::optional<knp::core::messaging::MessageVariant> receive_message() override
     {
-        const std::lock_guard lock(mutex_);
+        RoutedMessage message;
+        {
+            const std::lock_guard lock(*mutex_);
+            message = received_messages_->pop();
+        }
+        if (!message.message_) return {};
+        return take_message(std::move(message));
+    }
 
-        if (received_messages_->empty())
+    std::vector<knp::core::messaging::MessageVariant> receive_all_messages() override
+    {
+        std::deque<RoutedMessage> messages;
         {
-            return {};
+            const std::lock_guard lock(*mutex_);
+            messages = received_messages_->take_all();
         }
 
-        auto result = std::move(received_messages_->back());
-        received_messages_->pop_back();
+        std::vector<knp::core::messaging::MessageVariant> result;
+        result.reserve(messages.size());
+        for (auto &message : messages) result.push_back(take_message(std::move(message)));
         return result;
     }
 
+    size_t receive_all_message_views(const MessageViewHandler &handler) override
+    {
+        std::deque<RoutedMessage> messages;
+        {
+            const std::lock_guard lock(*mutex_);
+            messages = received_messages_->take_all();
+        }
+
+        // Views refer to the shared messages, which are kept alive until all views are handled.
+        for (const auto &message : messages) handler(make_message_view(*message.message_));
+        return messages.size();
+    }
+
+    void set_inbox_settings(const InboxSettings &settings) override
+    {
+        const std::lock_guard lock(*mutex_);
+        received_messages_->set_settings(settings);
+    }
+
+    [[nodiscard]] InboxOverflowCounters get_inbox_overflow_counters() const override
+    {
+        return received_messages_->get_overflow_counters();
+    }
+
+private:
+    /**
+     * @brief Get message value from a routed message.
+     * @details A message routed only to this endpoint is moved, a message shared with other endpoints is copied.
+     * Use `receive_all_message_views()` to read shared messages without copying.
+     */
+    static knp::core::messaging::MessageVariant take_message(RoutedMessage &&message)
+    {
+        if (message.is_exclusive_) return std::move(*message.message_);
+        return *message.message_;
+    }
+
 private:
     std::shared_ptr<std::vector<messaging::MessageVariant>> messages_to_send_;
-    std::shared_ptr<std::vector<messaging::MessageVariant>> received_messages_;
-    std::unordered_set<knp::core::UID, knp::core::uid_hash> senders_;
-    std::mutex mutex_;
+    std::shared_ptr<MessageInbox> received_messages_;
+    std::shared_ptr<std::mutex> mutex_;
 };
 
 }  // namespace knp::core::messaging::impl
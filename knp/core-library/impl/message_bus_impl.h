@@ -4,23 +4,27 @@
  * @kaspersky_support Vartenkov A.
  * @date 19.09.2023
  * @license Apache 2.0
- * @copyright © 2024 AO Kaspersky Lab
- *
- * Licensed under the Apache License, Version 2.0 (the "License");
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- * http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
  * limitations under the License.
  */
 #pragma once
 #include <knp/core/message_endpoint.h>
 
+#include <message_bus_metrics_collector.h>
+
+#include <atomic>
+
 /**
  * @brief Namespace for implementations of message bus.
  */
@@ -53,5 +57,34 @@ public:
      * @brief Update if needed. The function is to to be called once before message routing.
      */
     virtual void update() {}
+
+    /**
+     * @brief Check if `update()` and `step()` may be called by a routing thread while endpoints are used.
+     * @return `true` if the bus supports asynchronous routing.
+     */
+    [[nodiscard]] virtual bool is_async_routing_supported() const { return true; }
+
+    /**
+     * @brief Set if `update()` and `step()` are called by a routing thread.
+     * @param is_async `true` if messages are routed asynchronously.
+     */
+    void set_async_routing(bool is_async) { is_async_routing_.store(is_async, std::memory_order_relaxed); }
+
+    /**
+     * @brief Get collector of bus metrics.
+     * @return metrics collector.
+     */
+    MessageBusMetricsCollector &get_metrics_collector() { return metrics_collector_; }
+
+protected:
+    /**
+     * @brief Collector of bus metrics, implementations update it during message routing.
+     */
+    MessageBusMetricsCollector metrics_collector_;
+
+    /**
+     * @brief `true` if messages are routed by a routing thread.
+     */
+    std::atomic<bool> is_async_routing_ = false;
 };
 }  // namespace knp::core::messaging::impl
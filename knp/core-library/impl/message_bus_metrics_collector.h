@@ -0,0 +1,233 @@
+/**
+ * @file message_bus_metrics_collector.h
+ * @brief Collector of message bus metrics.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/message_bus_metrics.h>
+#include <knp/core/messaging/message_envelope.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+
+/**
+ * @brief Namespace for implementations of message bus.
+ */
+namespace knp::core::messaging::impl
+{
+
+/**
+ * @brief Get in-memory size of a message.
+ * @param message message.
+ * @return message size in bytes including the size of message data.
+ */
+inline size_t get_message_size(const MessageVariant &message)
+{
+    return std::visit(
+        [](const auto &msg)
+        {
+            using MessageType = std::decay_t<decltype(msg)>;
+            if constexpr (std::is_same_v<MessageType, SpikeMessage>)
+                return sizeof(MessageType) + msg.neuron_indexes_.size() * sizeof(SpikeIndex);
+            else if constexpr (std::is_same_v<MessageType, SynapticImpactMessage>)
+                return sizeof(MessageType) + msg.impacts_.size() * sizeof(SynapticImpact);
+            else
+                return sizeof(MessageType);
+        },
+        message);
+}
+
+
+/**
+ * @brief Collector of message bus metrics.
+ * @details Counters are relaxed atomics, so routing threads update them without locks. The mutex guards only the
+ * structure of sender and endpoint tables.
+ */
+class MessageBusMetricsCollector
+{
+public:
+    /**
+     * @brief Counters of one message sender.
+     */
+    struct SenderCounters
+    {
+        /**
+         * @brief Count a routed message.
+         * @param bytes message size.
+         */
+        void add_message(size_t bytes)
+        {
+            messages_.fetch_add(1, std::memory_order_relaxed);
+            bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Number of routed messages.
+         */
+        std::atomic<uint64_t> messages_{0};
+
+        /**
+         * @brief Size of routed messages.
+         */
+        std::atomic<uint64_t> bytes_{0};
+    };
+
+public:
+    /**
+     * @brief Enable or disable metrics collection.
+     * @param enable `true` to collect metrics.
+     */
+    void enable(bool enable) { is_enabled_.store(enable, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check if metrics are collected.
+     * @return `true` if metrics collection is enabled.
+     */
+    [[nodiscard]] bool is_enabled() const { return is_enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get counters of a sender.
+     * @details Counters are never removed, so the returned reference may be kept to count messages of the sender.
+     * @param sender_uid sender UID.
+     * @return sender counters.
+     */
+    SenderCounters &get_sender_counters(const UID &sender_uid)
+    {
+        const std::lock_guard lock(mutex_);
+        return sender_counters_[sender_uid];
+    }
+
+    /**
+     * @brief Count routed messages.
+     * @param messages number of routed messages.
+     * @param deliveries number of deliveries of the messages to endpoints.
+     */
+    void add_routed_messages(size_t messages, size_t deliveries)
+    {
+        messages_routed_.fetch_add(messages, std::memory_order_relaxed);
+        deliveries_.fetch_add(deliveries, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Count a routing cycle.
+     * @param routing_time cycle duration.
+     */
+    void add_routing_cycle(std::chrono::nanoseconds routing_time)
+    {
+        const auto nanoseconds = static_cast<uint64_t>(routing_time.count());
+        routing_cycles_.fetch_add(1, std::memory_order_relaxed);
+        total_routing_time_.fetch_add(nanoseconds, std::memory_order_relaxed);
+        routing_time_histogram_[MessageBusMetrics::get_routing_time_bucket(routing_time)].fetch_add(
+            1, std::memory_order_relaxed);
+
+        uint64_t max_time = max_routing_time_.load(std::memory_order_relaxed);
+        while (max_time < nanoseconds &&
+               !max_routing_time_.compare_exchange_weak(max_time, nanoseconds, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /**
+     * @brief Set inbox depths of endpoints after message routing.
+     * @param inbox_depths numbers of messages waiting in endpoints in the order of endpoint creation.
+     */
+    void update_inbox_depths(const std::vector<size_t> &inbox_depths)
+    {
+        const std::lock_guard lock(mutex_);
+        endpoints_.resize(inbox_depths.size());
+        for (size_t i = 0; i < inbox_depths.size(); ++i)
+        {
+            endpoints_[i].inbox_depth_ = inbox_depths[i];
+            endpoints_[i].max_inbox_depth_ = std::max<uint64_t>(endpoints_[i].max_inbox_depth_, inbox_depths[i]);
+        }
+    }
+
+    /**
+     * @brief Get a snapshot of collected metrics.
+     * @return metrics.
+     */
+    [[nodiscard]] MessageBusMetrics get_metrics() const
+    {
+        MessageBusMetrics metrics;
+        metrics.routing_cycles_ = routing_cycles_.load(std::memory_order_relaxed);
+        metrics.messages_routed_ = messages_routed_.load(std::memory_order_relaxed);
+        metrics.deliveries_ = deliveries_.load(std::memory_order_relaxed);
+        metrics.total_routing_time_ = std::chrono::nanoseconds(total_routing_time_.load(std::memory_order_relaxed));
+        metrics.max_routing_time_ = std::chrono::nanoseconds(max_routing_time_.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < routing_time_histogram_.size(); ++i)
+            metrics.routing_time_histogram_[i] = routing_time_histogram_[i].load(std::memory_order_relaxed);
+
+        const std::lock_guard lock(mutex_);
+        for (const auto &[sender_uid, counters] : sender_counters_)
+        {
+            const uint64_t messages = counters.messages_.load(std::memory_order_relaxed);
+            if (messages) metrics.senders_[sender_uid] = {messages, counters.bytes_.load(std::memory_order_relaxed)};
+        }
+        metrics.endpoints_ = endpoints_;
+        return metrics;
+    }
+
+    /**
+     * @brief Reset all counters to zero.
+     */
+    void reset()
+    {
+        routing_cycles_.store(0, std::memory_order_relaxed);
+        messages_routed_.store(0, std::memory_order_relaxed);
+        deliveries_.store(0, std::memory_order_relaxed);
+        total_routing_time_.store(0, std::memory_order_relaxed);
+        max_routing_time_.store(0, std::memory_order_relaxed);
+        for (auto &bucket : routing_time_histogram_) bucket.store(0, std::memory_order_relaxed);
+
+        const std::lock_guard lock(mutex_);
+        // Counters are zeroed rather than removed: routing threads may hold references to them.
+        for (auto &sender_counters : sender_counters_)
+        {
+            sender_counters.second.messages_.store(0, std::memory_order_relaxed);
+            sender_counters.second.bytes_.store(0, std::memory_order_relaxed);
+        }
+        endpoints_.clear();
+    }
+
+private:
+    std::atomic<bool> is_enabled_{false};
+
+    std::atomic<uint64_t> routing_cycles_{0};
+    std::atomic<uint64_t> messages_routed_{0};
+    std::atomic<uint64_t> deliveries_{0};
+    std::atomic<uint64_t> total_routing_time_{0};
+    std::atomic<uint64_t> max_routing_time_{0};
+    std::array<std::atomic<uint64_t>, MessageBusMetrics::routing_time_buckets_count> routing_time_histogram_{};
+
+    // Unordered map nodes are stable, so references to sender counters stay valid.
+    std::unordered_map<UID, SenderCounters, uid_hash> sender_counters_;
+    std::vector<MessageBusMetrics::EndpointMetrics> endpoints_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace knp::core::messaging::impl
@@ -0,0 +1,99 @@
+/**
+ * @file message_bus_shm_impl.cpp
+ * @brief Message bus shared memory implementation.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <message_bus_shm_impl/message_bus_shm_impl.h>
+#include <message_bus_shm_impl/message_endpoint_shm_impl.h>
+#include <message_bus_shm_impl/shared_ring_segment.h>
+#include <spdlog/spdlog.h>
+
+#include <memory>
+#include <utility>
+
+
+namespace knp::core::messaging::impl
+{
+
+class MessageEndpointSHM : public MessageEndpoint
+{
+public:
+    MessageEndpointSHM(std::shared_ptr<MessageEndpointSHMImpl> ptr, std::shared_ptr<std::mutex> senders_mutex)
+    {
+        impl_ = std::move(ptr);
+        // Bus checks the sender set under the mutex.
+        senders_mutex_ = std::move(senders_mutex);
+    }
+};
+
+
+MessageBusSHMImpl::MessageBusSHMImpl(const SHMBusSettings &settings)
+    : settings_(settings), segment_(std::make_shared<SharedRingSegment>(settings))
+{
+    SPDLOG_DEBUG("Shared memory message bus created.");
+}
+
+
+void MessageBusSHMImpl::update()
+{
+    const std::lock_guard lock(endpoints_mutex_);
+    std::vector<std::shared_ptr<MessageEndpointSHMImpl>> endpoints;
+    endpoints.reserve(endpoints_.size());
+    auto iter = endpoints_.begin();
+    while (iter != endpoints_.end())
+    {
+        auto endpoint_ptr = iter->lock();
+        // Clear up all pointers to expired endpoints.
+        if (!endpoint_ptr)
+        {
+            iter = endpoints_.erase(iter);
+            continue;
+        }
+        // Endpoints that subscribed since the previous update receive messages published by this update.
+        endpoint_ptr->update_reading();
+        endpoints.push_back(std::move(endpoint_ptr));
+        ++iter;
+    }
+
+    for (const auto &endpoint_ptr : endpoints) published_messages_count_ += endpoint_ptr->publish();
+}
+
+
+size_t MessageBusSHMImpl::step()
+{
+    // Messages are delivered by publishing, readers take them from the rings directly.
+    return std::exchange(published_messages_count_, 0);
+}
+
+
+MessageEndpoint MessageBusSHMImpl::create_endpoint()
+{
+    auto senders_mutex = std::make_shared<std::mutex>();
+    auto endpoint_impl = std::make_shared<MessageEndpointSHMImpl>(segment_, settings_.timeout_, senders_mutex);
+    auto endpoint = MessageEndpointSHM(endpoint_impl, std::move(senders_mutex));
+    endpoint_impl->set_senders(endpoint.get_senders_ptr());
+    {
+        const std::lock_guard lock(endpoints_mutex_);
+        endpoints_.push_back(std::move(endpoint_impl));
+    }
+
+    return std::move(endpoint);
+}
+
+}  // namespace knp::core::messaging::impl
@@ -0,0 +1,101 @@
+/**
+ * @file message_bus_shm_impl.h
+ * @brief Message bus shared memory implementation header.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/message_bus.h>
+
+#include <message_bus_impl.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+/**
+ * @brief Namespace for implementations of message bus.
+ */
+namespace knp::core::messaging::impl
+{
+class MessageEndpointSHMImpl;
+class SharedRingSegment;
+
+
+/**
+ * @brief Shared memory message bus implementation, not intended for user code.
+ * 
+ * @details Messages are exchanged through ring buffers in a shared memory segment without locks. Routing makes
+ * messages sent by local endpoints visible to endpoints of all buses that use the segment.
+ */
+class MessageBusSHMImpl : public MessageBusImpl
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param settings bus settings.
+     */
+    explicit MessageBusSHMImpl(const SHMBusSettings &settings = {});
+
+    /**
+     * @brief Publish messages sent by endpoints of the bus.
+     */
+    void update() override;
+
+    /**
+     * @brief Get number of messages published by the previous update.
+     * @return number of published messages.
+     */
+    size_t step() override;
+
+    /**
+     * @brief Create an endpoint that can be used for message exchange.
+     * @return new endpoint.
+     */
+    [[nodiscard]] MessageEndpoint create_endpoint() override;
+
+private:
+    /**
+     * @brief Bus settings.
+     */
+    SHMBusSettings settings_;
+
+    /**
+     * @brief Shared memory segment. Endpoints own it too, so the segment lives while any endpoint exists.
+     */
+    std::shared_ptr<SharedRingSegment> segment_;
+
+    /**
+     * @brief Endpoints created by the bus.
+     */
+    std::vector<std::weak_ptr<MessageEndpointSHMImpl>> endpoints_;
+
+    /**
+     * @brief Mutex that guards endpoint list.
+     */
+    std::mutex endpoints_mutex_;
+
+    /**
+     * @brief Number of messages published by the previous update.
+     */
+    size_t published_messages_count_ = 0;
+};
+
+}  // namespace knp::core::messaging::impl
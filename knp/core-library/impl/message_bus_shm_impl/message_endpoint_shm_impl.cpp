@@ -0,0 +1,164 @@
+/**
+ * @file message_endpoint_shm_impl.cpp
+ * @brief Message endpoint shared memory implementation.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "message_endpoint_shm_impl.h"
+
+#include <spdlog/spdlog.h>
+
+#include <utility>
+
+
+namespace knp::core::messaging::impl
+{
+
+MessageEndpointSHMImpl::MessageEndpointSHMImpl(
+    std::shared_ptr<SharedRingSegment> segment, std::chrono::milliseconds timeout,
+    std::shared_ptr<std::mutex> senders_mutex)
+    : segment_(std::move(segment)),
+      slot_(segment_->acquire_slot()),
+      timeout_(timeout),
+      senders_mutex_(std::move(senders_mutex))
+{
+    SPDLOG_DEBUG("Shared memory message endpoint creating, slot = {}...", slot_);
+}
+
+
+MessageEndpointSHMImpl::~MessageEndpointSHMImpl()
+{
+    segment_->release_slot(slot_);
+}
+
+
+void MessageEndpointSHMImpl::send_message(const knp::core::messaging::MessageVariant &message)
+{
+    knp::core::messaging::pack_to_envelope(
+        message,
+        [this](const uint8_t *data, size_t size)
+        {
+            SPDLOG_TRACE("Packed message size: {}.", size);
+            const std::lock_guard lock(send_mutex_);
+            segment_->write(slot_, data, size, timeout_);
+            ++sent_messages_count_;
+        });
+}
+
+
+void MessageEndpointSHMImpl::send_messages(std::vector<knp::core::messaging::MessageVariant> &&messages)
+{
+    const std::lock_guard lock(send_mutex_);
+    for (const auto &message : messages)
+    {
+        knp::core::messaging::pack_to_envelope(
+            message, [this](const uint8_t *data, size_t size) { segment_->write(slot_, data, size, timeout_); });
+    }
+    sent_messages_count_ += messages.size();
+}
+
+
+void MessageEndpointSHMImpl::set_senders(std::weak_ptr<const std::unordered_set<UID, uid_hash>> senders)
+{
+    const std::lock_guard lock(*senders_mutex_);
+    senders_ = std::move(senders);
+}
+
+
+void MessageEndpointSHMImpl::update_reading()
+{
+    bool has_senders = false;
+    {
+        const std::lock_guard lock(*senders_mutex_);
+        const auto senders_ptr = senders_.lock();
+        has_senders = senders_ptr && !senders_ptr->empty();
+    }
+
+    // Reading is not stopped while the endpoint reads records in place.
+    const std::lock_guard lock(receive_mutex_);
+    if (has_senders)
+        segment_->start_reading(slot_);
+    else
+        segment_->stop_reading(slot_);
+}
+
+
+size_t MessageEndpointSHMImpl::publish()
+{
+    const std::lock_guard lock(send_mutex_);
+    segment_->publish(slot_);
+    return std::exchange(sent_messages_count_, 0);
+}
+
+
+bool MessageEndpointSHMImpl::is_sender(const uint8_t *data) const
+{
+    const UID sender_uid = knp::core::messaging::get_envelope_sender(data);
+    const std::lock_guard lock(*senders_mutex_);
+    const auto senders_ptr = senders_.lock();
+    return senders_ptr && senders_ptr->count(sender_uid);
+}
+
+
+std::optional<messaging::MessageVariant> MessageEndpointSHMImpl::receive_message()
+{
+    std::optional<messaging::MessageVariant> result;
+    const std::lock_guard lock(receive_mutex_);
+    const auto read_record = [this, &result](const uint8_t *data, size_t)
+    {
+        if (is_sender(data)) result = knp::core::messaging::extract_from_envelope(data);
+    };
+    // Records of other senders are skipped until a message is received or all records are read.
+    while (!result && segment_->read(slot_, read_record, 1))
+    {
+    }
+    return result;
+}
+
+
+std::vector<messaging::MessageVariant> MessageEndpointSHMImpl::receive_all_messages()
+{
+    std::vector<messaging::MessageVariant> result;
+    const std::lock_guard lock(receive_mutex_);
+    segment_->read(
+        slot_,
+        [this, &result](const uint8_t *data, size_t)
+        {
+            if (is_sender(data)) result.push_back(knp::core::messaging::extract_from_envelope(data));
+        });
+    return result;
+}
+
+
+size_t MessageEndpointSHMImpl::receive_all_message_views(const messaging::MessageViewHandler &handler)
+{
+    // Views refer to ring data, so messages are not unpacked.
+    const std::lock_guard lock(receive_mutex_);
+    size_t views_count = 0;
+    segment_->read(
+        slot_,
+        [this, &handler, &views_count](const uint8_t *data, size_t)
+        {
+            if (!is_sender(data)) return;
+            handler(knp::core::messaging::view_envelope(data));
+            ++views_count;
+        });
+    return views_count;
+}
+
+}  // namespace knp::core::messaging::impl
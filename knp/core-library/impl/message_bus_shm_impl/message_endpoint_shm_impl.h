@@ -0,0 +1,108 @@
+/**
+ * @file message_endpoint_shm_impl.h
+ * @brief Message endpoint shared memory implementation header.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/uid.h>
+
+#include <message_bus_shm_impl/shared_ring_segment.h>
+#include <message_endpoint_impl.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+
+/**
+ * @brief Namespace for implementations of message bus.
+ */
+namespace knp::core::messaging::impl
+{
+
+/**
+ * @brief Endpoint implementation class for shared memory message bus.
+ * 
+ * @details The endpoint serializes sent messages to the ring of its slot and reads messages of all endpoints in place.
+ * The endpoint reads sender UIDs of all records published by the bus and unpacks only messages of its senders, other
+ * records are skipped. The endpoint reads messages only while it has senders, so endpoints that only send messages
+ * don't hold ring space.
+ * @note It should never be used explicitly.
+ */
+class MessageEndpointSHMImpl : public MessageEndpointImpl
+{
+public:
+    MessageEndpointSHMImpl(
+        std::shared_ptr<SharedRingSegment> segment, std::chrono::milliseconds timeout,
+        std::shared_ptr<std::mutex> senders_mutex);
+
+    ~MessageEndpointSHMImpl() override;
+
+public:
+    std::optional<messaging::MessageVariant> receive_message() override;
+
+    std::vector<messaging::MessageVariant> receive_all_messages() override;
+
+    size_t receive_all_message_views(const messaging::MessageViewHandler &handler) override;
+
+    void send_message(const knp::core::messaging::MessageVariant &message) override;
+
+    void send_messages(std::vector<knp::core::messaging::MessageVariant> &&messages) override;
+
+    /**
+     * @brief Set sender set of the endpoint.
+     * @param senders sender set that the endpoint changes under the sender mutex.
+     */
+    void set_senders(std::weak_ptr<const std::unordered_set<UID, uid_hash>> senders);
+
+    /**
+     * @brief Start reading messages if the endpoint has senders, stop reading otherwise.
+     */
+    void update_reading();
+
+    /**
+     * @brief Make sent messages visible to other endpoints.
+     * @return number of messages sent since the previous call.
+     */
+    size_t publish();
+
+private:
+    // Check whether a packed message was sent by a sender of the endpoint without unpacking the message.
+    bool is_sender(const uint8_t *data) const;
+
+private:
+    std::shared_ptr<SharedRingSegment> segment_;
+    size_t slot_;
+    std::chrono::milliseconds timeout_;
+
+    // Guards writing to the ring: the bus publishes endpoints from its own thread.
+    std::mutex send_mutex_;
+    size_t sent_messages_count_ = 0;
+
+    // Guards reading: the bus starts and stops reading from its own thread.
+    std::mutex receive_mutex_;
+    std::shared_ptr<std::mutex> senders_mutex_;
+    std::weak_ptr<const std::unordered_set<UID, uid_hash>> senders_;
+};
+
+}  // namespace knp::core::messaging::impl
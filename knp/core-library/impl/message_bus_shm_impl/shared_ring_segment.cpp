@@ -0,0 +1,427 @@
+/**
+ * @file shared_ring_segment.cpp
+ * @brief Shared memory segment with message ring buffers.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knp/core/uid.h>
+
+#include <message_bus_shm_impl/shared_ring_segment.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/sync/interprocess_condition.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+
+namespace knp::core::messaging::impl
+{
+
+namespace
+{
+// Size prefix of a record in a ring.
+using RecordSize = uint64_t;
+
+// Size of a record that means the next record starts at the ring beginning.
+constexpr RecordSize wrap_marker = std::numeric_limits<RecordSize>::max();
+
+// Value that marks an initialized segment.
+constexpr uint64_t segment_magic = 0x4b4e5053484d4255;
+
+constexpr size_t cache_line_size = 64;
+
+
+constexpr size_t get_aligned_size(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+
+enum SlotState : uint32_t
+{
+    free_slot = 0,
+    claimed_slot = 1,
+    // Slot only sends messages.
+    active_slot = 2,
+    // Slot sends and receives messages.
+    reading_slot = 3
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory bus requires lock-free 64-bit atomics.");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared memory bus requires lock-free 32-bit atomics.");
+}  // namespace
+
+
+struct SharedRingSegment::SegmentHeader
+{
+    std::atomic<uint64_t> magic_;
+    uint64_t slots_count_;
+    uint64_t ring_size_;
+    // Writers that wait for free ring space, readers notify the condition only if there are such writers.
+    std::atomic<uint32_t> waiting_writers_;
+    boost::interprocess::interprocess_mutex space_mutex_;
+    boost::interprocess::interprocess_condition space_freed_;
+};
+
+
+// Fields that are changed by different parties are placed to different cache lines.
+struct SharedRingSegment::RingHeader
+{
+    alignas(cache_line_size) std::atomic<uint32_t> state_;
+    alignas(cache_line_size) std::atomic<uint64_t> write_position_;
+    alignas(cache_line_size) std::atomic<uint64_t> published_position_;
+};
+
+
+SharedRingSegment::SharedRingSegment(const SHMBusSettings &settings)
+{
+    if (settings.name_.empty())
+    {
+        name_ = "knp_bus_" + std::string(UID());
+        create_segment(settings);
+        return;
+    }
+
+    name_ = settings.name_;
+    try
+    {
+        create_segment(settings);
+    }
+    catch (const boost::interprocess::interprocess_exception &)
+    {
+        if (is_owner_) throw;
+        SPDLOG_DEBUG("Shared memory segment {} exists, opening...", name_);
+        open_segment(settings);
+    }
+}
+
+
+SharedRingSegment::~SharedRingSegment()
+{
+    // Processes that opened the segment keep their mappings after removal.
+    if (is_owner_) boost::interprocess::shared_memory_object::remove(name_.c_str());
+}
+
+
+void SharedRingSegment::create_segment(const SHMBusSettings &settings)
+{
+    static_assert(sizeof(RingHeader) == 3 * cache_line_size, "Unexpected ring header size.");
+
+    shared_memory_ = boost::interprocess::shared_memory_object(
+        boost::interprocess::create_only, name_.c_str(), boost::interprocess::read_write);
+    is_owner_ = true;
+
+    if (settings.max_endpoints_ == 0) throw std::invalid_argument("Shared memory bus must have endpoint slots.");
+    slots_count_ = settings.max_endpoints_;
+    ring_size_ = get_aligned_size(std::max<size_t>(settings.ring_size_, cache_line_size), cache_line_size);
+
+    SPDLOG_DEBUG(
+        "Creating shared memory segment {} with {} rings of {} bytes...", name_, slots_count_, ring_size_);
+    shared_memory_.truncate(static_cast<boost::interprocess::offset_t>(compute_layout()));
+    map_segment();
+
+    auto *header = new (base_) SegmentHeader{};
+    header->slots_count_ = slots_count_;
+    header->ring_size_ = ring_size_;
+    for (size_t slot = 0; slot < slots_count_; ++slot)
+    {
+        new (&ring_header(slot)) RingHeader{};
+        for (size_t reader_slot = 0; reader_slot < slots_count_; ++reader_slot)
+        {
+            new (&read_position(reader_slot, slot)) std::atomic<uint64_t>(0);
+        }
+    }
+    header->magic_.store(segment_magic, std::memory_order_release);
+}
+
+
+void SharedRingSegment::open_segment(const SHMBusSettings &settings)
+{
+    shared_memory_ = boost::interprocess::shared_memory_object(
+        boost::interprocess::open_only, name_.c_str(), boost::interprocess::read_write);
+
+    // Creator could have not resized or initialized the segment yet.
+    const auto deadline = std::chrono::steady_clock::now() + settings.timeout_;
+    boost::interprocess::offset_t segment_size = 0;
+    while (!shared_memory_.get_size(segment_size) || static_cast<size_t>(segment_size) < sizeof(SegmentHeader))
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            throw std::runtime_error("Shared memory segment \"" + name_ + "\" was not initialized.");
+        std::this_thread::yield();
+    }
+
+    map_segment();
+    while (segment_header().magic_.load(std::memory_order_acquire) != segment_magic)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            throw std::runtime_error("Shared memory segment \"" + name_ + "\" was not initialized.");
+        std::this_thread::yield();
+    }
+
+    slots_count_ = segment_header().slots_count_;
+    ring_size_ = segment_header().ring_size_;
+    compute_layout();
+    SPDLOG_DEBUG("Opened shared memory segment {} with {} rings of {} bytes.", name_, slots_count_, ring_size_);
+}
+
+
+size_t SharedRingSegment::compute_layout()
+{
+    // Segment header, ring headers, read positions of each reader in all rings, ring data.
+    ring_headers_offset_ = get_aligned_size(sizeof(SegmentHeader), cache_line_size);
+    read_positions_offset_ = ring_headers_offset_ + slots_count_ * sizeof(RingHeader);
+    read_positions_row_size_ = get_aligned_size(slots_count_ * sizeof(std::atomic<uint64_t>), cache_line_size);
+    rings_offset_ = read_positions_offset_ + slots_count_ * read_positions_row_size_;
+    return rings_offset_ + slots_count_ * ring_size_;
+}
+
+
+void SharedRingSegment::map_segment()
+{
+    region_ = boost::interprocess::mapped_region(shared_memory_, boost::interprocess::read_write);
+    base_ = static_cast<uint8_t *>(region_.get_address());
+}
+
+
+SharedRingSegment::SegmentHeader &SharedRingSegment::segment_header() const
+{
+    return *std::launder(reinterpret_cast<SegmentHeader *>(base_));
+}
+
+
+SharedRingSegment::RingHeader &SharedRingSegment::ring_header(size_t slot) const
+{
+    return *std::launder(reinterpret_cast<RingHeader *>(base_ + ring_headers_offset_) + slot);
+}
+
+
+std::atomic<uint64_t> &SharedRingSegment::read_position(size_t reader_slot, size_t slot) const
+{
+    // Each reader changes only its own row, rows are placed to different cache lines.
+    auto *row = base_ + read_positions_offset_ + reader_slot * read_positions_row_size_;
+    return *std::launder(reinterpret_cast<std::atomic<uint64_t> *>(row) + slot);
+}
+
+
+uint8_t *SharedRingSegment::ring_data(size_t slot) const
+{
+    return base_ + rings_offset_ + slot * ring_size_;
+}
+
+
+size_t SharedRingSegment::acquire_slot()
+{
+    for (size_t slot = 0; slot < slots_count_; ++slot)
+    {
+        auto &state = ring_header(slot).state_;
+        uint32_t expected = free_slot;
+        if (!state.compare_exchange_strong(expected, claimed_slot)) continue;
+
+        state.store(active_slot, std::memory_order_release);
+        SPDLOG_TRACE("Shared memory bus slot {} acquired.", slot);
+        return slot;
+    }
+
+    throw std::runtime_error("No free endpoint slots in the shared memory bus.");
+}
+
+
+void SharedRingSegment::release_slot(size_t slot)
+{
+    auto &header = ring_header(slot);
+    header.write_position_.store(header.published_position_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    header.state_.store(free_slot, std::memory_order_seq_cst);
+    notify_writers();
+    SPDLOG_TRACE("Shared memory bus slot {} released.", slot);
+}
+
+
+void SharedRingSegment::start_reading(size_t slot)
+{
+    auto &state = ring_header(slot).state_;
+    if (state.load(std::memory_order_relaxed) == reading_slot) return;
+
+    // Writers that don't see the slot reading yet can reuse ring space up to the published position they read
+    // before. Reading published positions after the state change guarantees that the reader doesn't start below it.
+    for (size_t ring = 0; ring < slots_count_; ++ring)
+    {
+        read_position(slot, ring).store(
+            ring_header(ring).published_position_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+    state.store(reading_slot, std::memory_order_seq_cst);
+    for (size_t ring = 0; ring < slots_count_; ++ring)
+    {
+        read_position(slot, ring).store(
+            ring_header(ring).published_position_.load(std::memory_order_seq_cst), std::memory_order_release);
+    }
+    SPDLOG_TRACE("Shared memory bus slot {} started reading.", slot);
+}
+
+
+void SharedRingSegment::stop_reading(size_t slot)
+{
+    auto &state = ring_header(slot).state_;
+    if (state.load(std::memory_order_relaxed) != reading_slot) return;
+
+    state.store(active_slot, std::memory_order_seq_cst);
+    notify_writers();
+    SPDLOG_TRACE("Shared memory bus slot {} stopped reading.", slot);
+}
+
+
+bool SharedRingSegment::is_reading(size_t slot) const
+{
+    return ring_header(slot).state_.load(std::memory_order_relaxed) == reading_slot;
+}
+
+
+uint64_t SharedRingSegment::get_reusable_position(size_t slot) const
+{
+    // Unpublished records and records that some reading slot didn't read can't be overwritten.
+    uint64_t position = ring_header(slot).published_position_.load(std::memory_order_seq_cst);
+    for (size_t reader_slot = 0; reader_slot < slots_count_; ++reader_slot)
+    {
+        if (ring_header(reader_slot).state_.load(std::memory_order_seq_cst) != reading_slot) continue;
+        position = std::min(position, read_position(reader_slot, slot).load(std::memory_order_acquire));
+    }
+    return position;
+}
+
+
+void SharedRingSegment::write(size_t slot, const uint8_t *data, size_t size, std::chrono::milliseconds timeout)
+{
+    const uint64_t record_size = sizeof(RecordSize) + get_aligned_size(size, sizeof(RecordSize));
+    if (record_size > ring_size_ / 2)
+        throw std::length_error("Message is too large for the shared memory bus ring.");
+
+    auto &header = ring_header(slot);
+    uint64_t position = header.write_position_.load(std::memory_order_relaxed);
+    const uint64_t offset = position % ring_size_;
+    // Record data must be contiguous, so the rest of the ring is skipped if the record doesn't fit.
+    const uint64_t padding = offset + record_size > ring_size_ ? ring_size_ - offset : 0;
+    const uint64_t end_position = position + padding + record_size;
+
+    // Readers don't free space of unpublished records, so there is no point in waiting.
+    if (end_position - header.published_position_.load(std::memory_order_relaxed) > ring_size_)
+        throw std::length_error("Messages sent by an endpoint during one step don't fit the shared memory bus ring.");
+
+    if (end_position - get_reusable_position(slot) > ring_size_) wait_for_space(slot, end_position, timeout);
+
+    uint8_t *ring = ring_data(slot);
+    if (padding > 0)
+    {
+        std::memcpy(ring + offset, &wrap_marker, sizeof(RecordSize));
+        position += padding;
+    }
+
+    const RecordSize data_size = size;
+    std::memcpy(ring + position % ring_size_, &data_size, sizeof(RecordSize));
+    std::memcpy(ring + position % ring_size_ + sizeof(RecordSize), data, size);
+    header.write_position_.store(position + record_size, std::memory_order_release);
+}
+
+
+void SharedRingSegment::wait_for_space(size_t slot, uint64_t end_position, std::chrono::milliseconds timeout)
+{
+    auto &header = segment_header();
+    const auto deadline =
+        boost::posix_time::microsec_clock::universal_time() + boost::posix_time::milliseconds(timeout.count());
+    const auto is_space_free = [this, slot, end_position]
+    { return end_position - get_reusable_position(slot) <= ring_size_; };
+
+    // The counter is increased before space is checked again, so readers that free space after the check see it.
+    header.waiting_writers_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool has_space = false;
+    {
+        boost::interprocess::scoped_lock<boost::interprocess::interprocess_mutex> lock(header.space_mutex_);
+        has_space = header.space_freed_.timed_wait(lock, deadline, is_space_free);
+    }
+    header.waiting_writers_.fetch_sub(1, std::memory_order_relaxed);
+
+    if (!has_space) throw std::runtime_error("Shared memory bus ring is full: endpoints don't receive messages.");
+}
+
+
+void SharedRingSegment::notify_writers()
+{
+    auto &header = segment_header();
+    // Pairs with the fence of a waiting writer: either the writer sees freed space or the reader sees the writer.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header.waiting_writers_.load(std::memory_order_relaxed) == 0) return;
+
+    // Writer checks space under the mutex, so the notification can't be lost between its check and wait.
+    boost::interprocess::scoped_lock<boost::interprocess::interprocess_mutex> lock(header.space_mutex_);
+    header.space_freed_.notify_all();
+}
+
+
+void SharedRingSegment::publish(size_t slot)
+{
+    auto &header = ring_header(slot);
+    header.published_position_.store(
+        header.write_position_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+}
+
+
+size_t SharedRingSegment::read(
+    size_t reader_slot, const std::function<void(const uint8_t *, size_t)> &handler, size_t max_records)
+{
+    size_t records_count = 0;
+    if (!is_reading(reader_slot)) return records_count;
+
+    for (size_t slot = 0; slot < slots_count_ && records_count < max_records; ++slot)
+    {
+        auto &position = read_position(reader_slot, slot);
+        uint64_t current_position = position.load(std::memory_order_relaxed);
+        const uint64_t published_position = ring_header(slot).published_position_.load(std::memory_order_acquire);
+        const uint8_t *ring = ring_data(slot);
+
+        while (current_position < published_position && records_count < max_records)
+        {
+            const uint64_t offset = current_position % ring_size_;
+            RecordSize data_size = 0;
+            std::memcpy(&data_size, ring + offset, sizeof(RecordSize));
+            if (data_size == wrap_marker)
+            {
+                current_position += ring_size_ - offset;
+                continue;
+            }
+
+            // Record is read in place, so the writer can reuse its space only after the handler returns.
+            handler(ring + offset + sizeof(RecordSize), data_size);
+            current_position += sizeof(RecordSize) + get_aligned_size(data_size, sizeof(RecordSize));
+            position.store(current_position, std::memory_order_release);
+            ++records_count;
+        }
+        position.store(current_position, std::memory_order_release);
+    }
+
+    if (records_count > 0) notify_writers();
+    return records_count;
+}
+
+}  // namespace knp::core::messaging::impl
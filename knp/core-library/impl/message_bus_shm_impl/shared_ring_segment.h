@@ -0,0 +1,168 @@
+/**
+ * @file shared_ring_segment.h
+ * @brief Shared memory segment with message ring buffers.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/message_bus.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+
+/**
+ * @brief Namespace for implementations of message bus.
+ */
+namespace knp::core::messaging::impl
+{
+
+/**
+ * @brief Shared memory segment that contains a ring buffer for each endpoint slot.
+ * 
+ * @details Each endpoint writes serialized messages to the ring of its slot, and the ring has one writer.
+ * Endpoints of reading slots read the ring in place, each with its own read position, so a message is serialized
+ * once regardless of the number of readers. Written messages become visible to readers only after the ring is
+ * published. A writer reuses ring space only after all reading slots have passed it, slots that only send messages
+ * don't hold ring space. Rings are guarded by atomic positions only. A writer waits for free space on a condition
+ * that readers notify only if some writer waits, so reading and writing don't take locks.
+ * 
+ * Ring records consist of a 64-bit record size and data aligned to 8 bytes. A record that doesn't fit before the
+ * ring end is preceded by a wrap marker, so that record data is always contiguous.
+ */
+class SharedRingSegment
+{
+public:
+    /**
+     * @brief Create a segment or open a segment created by another process.
+     * @param settings bus settings.
+     */
+    explicit SharedRingSegment(const SHMBusSettings &settings);
+
+    /**
+     * @brief Destructor. The segment creator removes the segment name.
+     */
+    ~SharedRingSegment();
+
+    SharedRingSegment(const SharedRingSegment &) = delete;
+    SharedRingSegment &operator=(const SharedRingSegment &) = delete;
+
+public:
+    /**
+     * @brief Occupy a free endpoint slot.
+     * @details The slot doesn't read records until reading is started.
+     * @return slot index.
+     */
+    size_t acquire_slot();
+
+    /**
+     * @brief Free an endpoint slot. Unpublished messages of the slot are discarded.
+     * @param slot slot index.
+     */
+    void release_slot(size_t slot);
+
+    /**
+     * @brief Start reading records by a slot.
+     * @details The slot reads only records published after the call. Writers don't reuse ring space that the slot
+     * didn't read.
+     * @param slot slot index.
+     */
+    void start_reading(size_t slot);
+
+    /**
+     * @brief Stop reading records by a slot, so that writers don't wait for the slot.
+     * @param slot slot index.
+     */
+    void stop_reading(size_t slot);
+
+    /**
+     * @brief Check if a slot reads records.
+     * @param slot slot index.
+     * @return `true` if the slot reads records.
+     */
+    [[nodiscard]] bool is_reading(size_t slot) const;
+
+    /**
+     * @brief Write a record to the ring of a slot.
+     * @details The method waits for readers if the ring is full.
+     * @param slot slot index.
+     * @param data record data.
+     * @param size record data size in bytes.
+     * @param timeout maximum time to wait for free space in the ring.
+     * @throw std::length_error if the record doesn't fit the ring together with unpublished records.
+     * @throw std::runtime_error if readers didn't free space in the ring during the timeout.
+     */
+    void write(size_t slot, const uint8_t *data, size_t size, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Make all written records of a slot ring visible to readers.
+     * @param slot slot index.
+     */
+    void publish(size_t slot);
+
+    /**
+     * @brief Read published records of all rings.
+     * @details A slot that doesn't read records gets no records.
+     * @param reader_slot slot of the reader.
+     * @param handler function that gets record data. Data is valid only during the function call.
+     * @param max_records maximum number of records to read.
+     * @return number of read records.
+     */
+    size_t read(
+        size_t reader_slot, const std::function<void(const uint8_t *, size_t)> &handler,
+        size_t max_records = SIZE_MAX);
+
+private:
+    struct SegmentHeader;
+    struct RingHeader;
+
+    [[nodiscard]] SegmentHeader &segment_header() const;
+    [[nodiscard]] RingHeader &ring_header(size_t slot) const;
+    [[nodiscard]] std::atomic<uint64_t> &read_position(size_t reader_slot, size_t slot) const;
+    [[nodiscard]] uint8_t *ring_data(size_t slot) const;
+    [[nodiscard]] uint64_t get_reusable_position(size_t slot) const;
+    void wait_for_space(size_t slot, uint64_t end_position, std::chrono::milliseconds timeout);
+    void notify_writers();
+
+    size_t compute_layout();
+    void create_segment(const SHMBusSettings &settings);
+    void open_segment(const SHMBusSettings &settings);
+    void map_segment();
+
+private:
+    std::string name_;
+    bool is_owner_ = false;
+    boost::interprocess::shared_memory_object shared_memory_;
+    boost::interprocess::mapped_region region_;
+    uint8_t *base_ = nullptr;
+    size_t slots_count_ = 0;
+    size_t ring_size_ = 0;
+    size_t ring_headers_offset_ = 0;
+    size_t read_positions_offset_ = 0;
+    size_t read_positions_row_size_ = 0;
+    size_t rings_offset_ = 0;
+};
+
+}  // namespace knp::core::messaging::impl
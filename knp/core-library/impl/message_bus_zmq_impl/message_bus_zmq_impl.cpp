@@ -23,8 +23,14 @@
 #include <message_bus_zmq_impl/message_endpoint_zmq_impl.h>
 #include <spdlog/spdlog.h>
 
+#include <cstring>
 #include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <zmq.hpp>
@@ -33,106 +39,331 @@
 namespace knp::core::messaging::impl
 {
 
-#if defined(_MSC_VER)
-#    pragma warning(push)
-#    pragma warning(disable : 4455)
-#endif
-using std::chrono_literals::operator""ms;
-#if defined(_MSC_VER)
-#    pragma warning(pop)
-#endif
-
-
 class MessageEndpointZMQ : public MessageEndpoint
 {
 public:
-    explicit MessageEndpointZMQ(zmq::socket_t &&sub_socket, zmq::socket_t &&pub_socket)
-    {
-        impl_ = std::make_shared<MessageEndpointZMQImpl>(std::move(sub_socket), std::move(pub_socket));
-    }
+    explicit MessageEndpointZMQ(std::shared_ptr<MessageEndpointZMQImpl> &&ptr) { impl_ = std::move(ptr); }
 };
 
 
-MessageBusZMQImpl::MessageBusZMQImpl()
-    :  // TODO: Replace with std::format.
-      router_sock_address_("inproc://route_" + std::string(UID())),
-      publish_sock_address_("inproc://publish_" + std::string(UID())),
-      router_socket_(context_, zmq::socket_type::router),
-      publish_socket_(context_, zmq::socket_type::pub)
+namespace
 {
-    SPDLOG_DEBUG("ZMQ message bus creating...");
-    SPDLOG_DEBUG("Router socket binding to {}...", router_sock_address_);
-    router_socket_.bind(router_sock_address_);
-    SPDLOG_DEBUG("Publish socket binding to {}...", publish_sock_address_);
-    publish_socket_.bind(publish_sock_address_);
-    // zmq::proxy(router_socket_, publish_socket_);
+// Number of endpoints which finished a round.
+using EndpointsCount = uint64_t;
+
+// Control messages of buses consist of the tag frame and the frame with the number of endpoints, so that they are
+// not confused with batch frames of endpoints, which are sent as single frames.
+constexpr std::string_view round_end_tag = "knp_round_end";
+
+
+template <class ValueType>
+void set_socket_option(zmq::socket_t &socket, int option, ValueType value)
+{
+#if defined(__GNUC__)
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    socket.setsockopt(option, value);
+#    pragma GCC diagnostic pop
+#else
+    socket.setsockopt(option, value);
+#endif
 }
 
 
-zmq::recv_result_t MessageBusZMQImpl::poll(zmq::message_t &message)
+// Configure a socket that exchanges messages with other processes: frames must not be dropped and waiting
+// must not be infinite.
+void setup_multiprocess_socket(zmq::socket_t &socket, const ZMQBusSettings &settings)
 {
-    // recv_result is an optional and if it doesn't contain a value, EAGAIN is returned by the call.
-    zmq::recv_result_t recv_result;
+    set_socket_option(socket, ZMQ_SNDHWM, 0);
+    set_socket_option(socket, ZMQ_RCVHWM, 0);
+    set_socket_option(socket, ZMQ_RCVTIMEO, static_cast<int>(settings.timeout_.count()));
+}
+
 
-    std::vector<zmq_pollitem_t> items = {
-        zmq_pollitem_t{router_socket_.handle(), 0, ZMQ_POLLIN, 0},
-    };
+void send_routed_frame(zmq::socket_t &socket, const std::string &routing_id, zmq::message_t &&frame)
+{
+    socket.send(zmq::message_t(routing_id.data(), routing_id.size()), zmq::send_flags::sndmore);
+    socket.send(std::move(frame), zmq::send_flags::none);
+}
 
-    SPDLOG_DEBUG("Running poll()...");
 
-    if (zmq::poll(items, 0ms) > 0)
-    {
-        SPDLOG_TRACE("poll() was successful, receiving data...");
-        do
-        {
-            recv_result = router_socket_.recv(message, zmq::recv_flags::dontwait);
+// Count messages of a batch frame in sender metrics.
+size_t add_frame_to_metrics(const zmq::message_t &frame, MessageBusMetricsCollector &metrics_collector)
+{
+    UID previous_sender_uid{false};
+    MessageBusMetricsCollector::SenderCounters *sender_counters = nullptr;
 
-            if (recv_result.has_value())
+    return for_each_batch_envelope(
+        frame,
+        [&](const uint8_t *envelope_data, size_t envelope_size)
+        {
+            const auto message_view = knp::core::messaging::view_envelope(envelope_data);
+            const UID &sender_uid = std::visit(
+                [](const auto &view) -> const UID & { return view.header_.sender_uid_; }, message_view);
+            if (!sender_counters || sender_uid != previous_sender_uid)
             {
-                SPDLOG_TRACE("Bus received {} bytes.", recv_result.value());
+                sender_counters = &metrics_collector.get_sender_counters(sender_uid);
+                previous_sender_uid = sender_uid;
             }
-            else
+            sender_counters->add_message(envelope_size);
+        });
+}
+}  // namespace
+
+
+MessageBusZMQImpl::MessageBusZMQImpl(const ZMQBusSettings &settings)
+    :  // TODO: Replace with std::format.
+      settings_(settings),
+      router_sock_address_(is_multiprocess() ? settings.address_ : "inproc://route_" + std::string(UID())),
+      publish_sock_address_(is_multiprocess() ? "" : "inproc://publish_" + std::string(UID()))
+{
+    SPDLOG_DEBUG("ZMQ message bus creating...");
+
+    if (!is_multiprocess())
+    {
+        router_socket_ = zmq::socket_t(context_, zmq::socket_type::router);
+        publish_socket_ = zmq::socket_t(context_, zmq::socket_type::pub);
+        SPDLOG_DEBUG("Router socket binding to {}...", router_sock_address_);
+        router_socket_.bind(router_sock_address_);
+        SPDLOG_DEBUG("Publish socket binding to {}...", publish_sock_address_);
+        publish_socket_.bind(publish_sock_address_);
+        // zmq::proxy(router_socket_, publish_socket_);
+        return;
+    }
+
+    if (settings_.is_router_)
+    {
+        router_socket_ = zmq::socket_t(context_, zmq::socket_type::router);
+        setup_multiprocess_socket(router_socket_, settings_);
+        SPDLOG_DEBUG("Router socket binding to {}...", router_sock_address_);
+        router_socket_.bind(router_sock_address_);
+        return;
+    }
+
+    control_socket_ = zmq::socket_t(context_, zmq::socket_type::dealer);
+    setup_multiprocess_socket(control_socket_, settings_);
+    SPDLOG_DEBUG("Control socket connecting to {}...", router_sock_address_);
+    control_socket_.connect(router_sock_address_);
+}
+
+
+void MessageBusZMQImpl::add_routed_messages_to_metrics(size_t messages_count, size_t receivers_count)
+{
+    metrics_collector_.add_routed_messages(messages_count, messages_count * receivers_count);
+
+    // Every local endpoint receives all routed frames.
+    std::vector<size_t> inbox_depths;
+    {
+        const std::lock_guard lock(endpoints_mutex_);
+        inbox_depths.reserve(endpoints_.size());
+        for (const auto &endpoint : endpoints_)
+        {
+            auto endpoint_ptr = endpoint.lock();
+            if (!endpoint_ptr)
             {
-                SPDLOG_WARN("Bus received error [EAGAIN].");
+                inbox_depths.push_back(0);
+                continue;
             }
-        } while (!recv_result.has_value());
+            endpoint_ptr->add_routed_messages(messages_count);
+            inbox_depths.push_back(endpoint_ptr->get_inbox_depth());
+        }
     }
-    else
+    metrics_collector_.update_inbox_depths(inbox_depths);
+}
+
+
+size_t MessageBusZMQImpl::flush_endpoints(bool send_round_marker)
+{
+    const std::lock_guard lock(endpoints_mutex_);
+    auto iter = endpoints_.begin();
+    while (iter != endpoints_.end())
     {
-        SPDLOG_DEBUG("poll() returned 0, exiting...");
-        return std::nullopt;
+        auto endpoint_ptr = iter->lock();
+        // Clear up all pointers to expired endpoints.
+        if (!endpoint_ptr)
+        {
+            iter = endpoints_.erase(iter);
+            continue;
+        }
+        endpoint_ptr->flush(send_round_marker);
+        ++iter;
     }
 
-    return recv_result;
+    return endpoints_.size();
+}
+
+
+void MessageBusZMQImpl::update()
+{
+    if (!is_multiprocess())
+    {
+        flush_endpoints(false);
+        return;
+    }
+
+    const size_t endpoints_count = flush_endpoints(true);
+
+    if (settings_.is_router_)
+    {
+        // Round is routed by the `step()` call.
+        round_endpoints_count_ = endpoints_count;
+        is_round_pending_ = true;
+        return;
+    }
+
+    try
+    {
+        const EndpointsCount count = endpoints_count;
+        SPDLOG_TRACE("Reporting round end of {} endpoints...", count);
+        control_socket_.send(
+            zmq::message_t(round_end_tag.data(), round_end_tag.size()), zmq::send_flags::sndmore);
+        control_socket_.send(zmq::message_t(&count, sizeof(count)), zmq::send_flags::none);
+
+        zmq::message_t message;
+        // Routing bus replies with an empty frame when messages of all processes were routed.
+        if (!control_socket_.recv(message).has_value())
+            throw std::runtime_error("Message round was not routed in time.");
+    }
+    catch (const zmq::error_t &e)
+    {
+        SPDLOG_CRITICAL(e.what());
+        throw;
+    }
 }
 
 
 size_t MessageBusZMQImpl::step()
 {
-    zmq::message_t message;
-    zmq::recv_result_t recv_result;
+    if (!is_multiprocess()) return route_inproc();
+    // Only the routing bus routes messages, other buses wait for the round end in `update()`.
+    if (!settings_.is_router_ || !is_round_pending_) return 0;
+    return route_round();
+}
+
+
+size_t MessageBusZMQImpl::route_inproc()
+{
+    size_t frames_count = 0;
+    const bool is_metrics_enabled = metrics_collector_.is_enabled();
+    size_t messages_count = 0;
 
     try
     {
-        recv_result = this->poll(message);
-        if (!recv_result.has_value())
+        // Drain all frames received by the router socket.
+        while (true)
         {
-            return 0;
+            zmq::message_t message;
+            // recv_result is an optional and if it doesn't contain a value, EAGAIN is returned by the call.
+            const zmq::recv_result_t recv_result = router_socket_.recv(message, zmq::recv_flags::dontwait);
+            if (!recv_result.has_value()) break;
+
+            SPDLOG_TRACE("Bus received {} bytes.", recv_result.value());
+            ++frames_count;
+
+            // Router socket prefixes each data frame with a sender ID frame.
+            if (message.more()) continue;
+
+            SPDLOG_DEBUG("Data was received, bus the message will be resent.");
+            if (is_metrics_enabled) messages_count += add_frame_to_metrics(message, metrics_collector_);
+            // `send_result` is `std::optional` and if it doesn't contain a value, `EAGAIN` is returned by the call.
+            zmq::send_result_t send_result;
+            do
+            {
+                send_result = publish_socket_.send(message, zmq::send_flags::none);
+            } while (!send_result.has_value());
+            SPDLOG_TRACE("Bus sent {} bytes.", send_result.value());
         }
+    }
+    catch (const zmq::error_t &e)
+    {
+        SPDLOG_CRITICAL(e.what());
+        throw;
+    }
+
+    if (is_metrics_enabled)
+    {
+        size_t endpoints_count = 0;
+        {
+            const std::lock_guard lock(endpoints_mutex_);
+            endpoints_count = endpoints_.size();
+        }
+        add_routed_messages_to_metrics(messages_count, endpoints_count);
+    }
+
+    return frames_count;
+}
+
+
+size_t MessageBusZMQImpl::route_round()
+{
+    is_round_pending_ = false;
 
-        if (isit_id(recv_result))
+    size_t markers_expected = round_endpoints_count_;
+    size_t markers_received = 0;
+    std::vector<std::string> control_ids;
+    // Every endpoint sends a round marker, so endpoints that were destroyed are not routed to.
+    std::set<std::string> endpoint_ids;
+    std::vector<zmq::message_t> data_frames;
+
+    try
+    {
+        // Collect frames until all processes report the round end and all their endpoints send round markers.
+        while (control_ids.size() + 1 < settings_.processes_count_ || markers_received < markers_expected)
         {
-            return 1;
+            zmq::message_t id_frame;
+            zmq::message_t frame;
+            if (!router_socket_.recv(id_frame).has_value() || !router_socket_.recv(frame).has_value())
+                throw std::runtime_error("Message round was not routed in time.");
+
+            std::string routing_id(id_frame.data<char>(), id_frame.size());
+            if (frame.more())
+            {
+                zmq::message_t count_frame;
+                if (!router_socket_.recv(count_frame).has_value())
+                    throw std::runtime_error("Message round was not routed in time.");
+                if (std::string_view(frame.data<char>(), frame.size()) != round_end_tag ||
+                    count_frame.size() != sizeof(EndpointsCount) || count_frame.more())
+                {
+                    // Unknown control messages would break round counting, so the round can't be completed.
+                    throw std::runtime_error("Wrong control message was received.");
+                }
+                EndpointsCount count = 0;
+                std::memcpy(&count, count_frame.data(), sizeof(count));
+                markers_expected += count;
+                control_ids.push_back(std::move(routing_id));
+                continue;
+            }
+
+            endpoint_ids.insert(std::move(routing_id));
+            if (frame.size() == 0)
+                ++markers_received;
+            else if (verify_batch_frame(frame))
+                data_frames.push_back(std::move(frame));
+            else
+                SPDLOG_ERROR("Damaged batch frame of {} bytes was dropped.", frame.size());
         }
 
-        SPDLOG_DEBUG("Data was received, bus the message will be resent.");
-        // `send_result` is `std::optional` and if it doesn't contain a value, `EAGAIN` is returned by the call.
-        zmq::send_result_t send_result;
-        do
+        SPDLOG_TRACE("Routing {} frames to {} endpoints...", data_frames.size(), endpoint_ids.size());
+        if (metrics_collector_.is_enabled())
         {
-            send_result = publish_socket_.send(message, zmq::send_flags::none);
-        } while (!send_result.has_value());
-        SPDLOG_TRACE("Bus sent {} bytes.", send_result.value());
+            size_t messages_count = 0;
+            for (const auto &data_frame : data_frames)
+                messages_count += add_frame_to_metrics(data_frame, metrics_collector_);
+            add_routed_messages_to_metrics(messages_count, endpoint_ids.size());
+        }
+        for (const auto &endpoint_id : endpoint_ids)
+        {
+            for (auto &data_frame : data_frames)
+            {
+                // Large frames are reference-counted by ZeroMQ, so copying doesn't copy data.
+                zmq::message_t frame_copy;
+                frame_copy.copy(data_frame);
+                send_routed_frame(router_socket_, endpoint_id, std::move(frame_copy));
+            }
+            send_routed_frame(router_socket_, endpoint_id, zmq::message_t());
+        }
+
+        for (const auto &control_id : control_ids) send_routed_frame(router_socket_, control_id, zmq::message_t());
     }
     catch (const zmq::error_t &e)
     {
@@ -140,15 +371,33 @@ size_t MessageBusZMQImpl::step()
         throw;
     }
 
-    return recv_result.has_value() && (recv_result.value() != 0) ? 1 : 0;
+    return data_frames.size();
 }
 
 
 MessageEndpoint MessageBusZMQImpl::create_endpoint()
 {
-    zmq::socket_t sub_socket{context_, zmq::socket_type::sub};
     zmq::socket_t pub_socket{context_, zmq::socket_type::dealer};
 
+    if (is_multiprocess())
+    {
+        // Dealer socket both sends messages to the routing bus and receives routed messages.
+        setup_multiprocess_socket(pub_socket, settings_);
+        SPDLOG_DEBUG("Dealer socket connecting to {}...", router_sock_address_);
+        pub_socket.connect(router_sock_address_);
+
+        auto endpoint_impl = std::make_shared<MessageEndpointZMQImpl>(
+            zmq::socket_t{}, std::move(pub_socket), settings_.max_batch_size_, true);
+        {
+            const std::lock_guard lock(endpoints_mutex_);
+            endpoints_.push_back(endpoint_impl);
+        }
+
+        return std::move(MessageEndpointZMQ(std::move(endpoint_impl)));
+    }
+
+    zmq::socket_t sub_socket{context_, zmq::socket_type::sub};
+
 // #if (ZMQ_VERSION >= ZMQ_MAKE_VERSION(4, 3, 4))
 //         sub_socket_.set(zmq::sockopt::subscribe, "");
 // #else
@@ -171,7 +420,14 @@ MessageEndpoint MessageBusZMQImpl::create_endpoint()
     SPDLOG_DEBUG("Sub socket connecting to {}...", publish_sock_address_);
     sub_socket.connect(publish_sock_address_);
 
-    return std::move(MessageEndpointZMQ(std::move(sub_socket), std::move(pub_socket)));
+    auto endpoint_impl = std::make_shared<MessageEndpointZMQImpl>(
+        std::move(sub_socket), std::move(pub_socket), settings_.max_batch_size_);
+    {
+        const std::lock_guard lock(endpoints_mutex_);
+        endpoints_.push_back(endpoint_impl);
+    }
+
+    return std::move(MessageEndpointZMQ(std::move(endpoint_impl)));
 }
 
 }  // namespace knp::core::messaging::impl
@@ -4,33 +4,39 @@
  * @kaspersky_support Artiom N.
  * @date 31.03.2023
  * @license Apache 2.0
- * @copyright © 2024 AO Kaspersky Lab
- *
- * Licensed under the Apache License, Version 2.0 (the "License");
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- * http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
  * limitations under the License.
  */
 
 #pragma once
 
+#include <knp/core/message_bus.h>
+
 #include <message_bus_impl.h>
 #include <spdlog/spdlog.h>
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <zmq.hpp>
 
 
 namespace knp::core::messaging::impl
 {
+class MessageEndpointZMQImpl;
 
 /**
  * @brief Internal message bus class, not intended for user code.
@@ -38,10 +44,22 @@ namespace knp::core::messaging::impl
 class MessageBusZMQImpl : public MessageBusImpl
 {
 public:
-    MessageBusZMQImpl();
+    /**
+     * @brief Constructor.
+     * @param settings bus settings.
+     */
+    explicit MessageBusZMQImpl(const ZMQBusSettings &settings = {});
 
     /**
-     * @brief Send a message from one socket to another.
+     * @brief Send batched messages of all endpoints.
+     * @details If the bus exchanges messages with other processes and doesn't route them, the method waits until
+     * the routing bus sends messages of the current round to all endpoints.
+     */
+    void update() override;
+
+    /**
+     * @brief Resend all frames received by router socket to endpoints.
+     * @return number of frames received by router socket.
      */
     size_t step() override;
 
@@ -51,11 +69,22 @@ public:
      */
     [[nodiscard]] MessageEndpoint create_endpoint() override;
 
+    // Routing rounds of several processes are synchronized by `route_messages()` calls.
+    [[nodiscard]] bool is_async_routing_supported() const override { return !is_multiprocess(); }
+
 private:
-    zmq::recv_result_t poll(zmq::message_t &message);
-    bool isit_id(const zmq::recv_result_t &recv_result) const { return recv_result.value() == 5; }
+    [[nodiscard]] bool is_multiprocess() const { return !settings_.address_.empty(); }
+    size_t flush_endpoints(bool send_round_marker);
+    size_t route_inproc();
+    size_t route_round();
+    void add_routed_messages_to_metrics(size_t messages_count, size_t receivers_count);
 
 private:
+    /**
+     * @brief Bus settings.
+     */
+    ZMQBusSettings settings_;
+
     /**
      * @brief Router socket address.
      */
@@ -79,9 +108,34 @@ private:
     zmq::socket_t router_socket_;
 
     /**
-     * @brief Publish socket.
+     * @brief Publish socket, used only inside one process.
      */
     zmq::socket_t publish_socket_;
+
+    /**
+     * @brief Socket that reports round completion to the routing bus of another process.
+     */
+    zmq::socket_t control_socket_;
+
+    /**
+     * @brief Endpoints that must be flushed before routing.
+     */
+    std::vector<std::weak_ptr<MessageEndpointZMQImpl>> endpoints_;
+
+    /**
+     * @brief Mutex that guards endpoint list.
+     */
+    std::mutex endpoints_mutex_;
+
+    /**
+     * @brief Number of local endpoints that take part in the current round.
+     */
+    size_t round_endpoints_count_ = 0;
+
+    /**
+     * @brief `true` if endpoints were flushed, but the round was not routed yet.
+     */
+    bool is_round_pending_ = false;
 };
 
 
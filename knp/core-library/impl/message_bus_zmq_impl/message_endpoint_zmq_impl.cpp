@@ -25,7 +25,10 @@
 
 #include <spdlog/spdlog.h>
 
+#include <cstring>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 
 #include <zmq.hpp>
@@ -34,20 +37,195 @@
 namespace knp::core::messaging::impl
 {
 
-#if defined(_MSC_VER)
-#    pragma warning(push)
-#    pragma warning(disable : 4455)
-#endif
-using std::chrono_literals::operator""ms;
-#if defined(_MSC_VER)
-#    pragma warning(pop)
-#endif
+MessageEndpointZMQImpl::MessageEndpointZMQImpl(
+    zmq::socket_t &&sub_socket, zmq::socket_t &&pub_socket, size_t max_batch_size, bool use_round_barrier)
+    : sub_socket_(std::move(sub_socket)),
+      pub_socket_(std::move(pub_socket)),
+      max_batch_size_(max_batch_size),
+      use_round_barrier_(use_round_barrier)
+{
+    SPDLOG_DEBUG("ZMQ message endpoint creating...");
+}
 
 
-MessageEndpointZMQImpl::MessageEndpointZMQImpl(zmq::socket_t &&sub_socket, zmq::socket_t &&pub_socket)
-    : sub_socket_(std::move(sub_socket)), pub_socket_(std::move(pub_socket))
+MessageEndpointZMQImpl::~MessageEndpointZMQImpl()
 {
-    SPDLOG_DEBUG("ZMQ message endpoint creating...");
+    try
+    {
+        flush();
+    }
+    catch (const zmq::error_t &e)
+    {
+        SPDLOG_ERROR("Batched messages were not sent: {}.", e.what());
+    }
+}
+
+
+void MessageEndpointZMQImpl::send_message(const knp::core::messaging::MessageVariant &message)
+{
+    knp::core::messaging::pack_to_envelope(
+        message,
+        [this](const uint8_t *data, size_t size)
+        {
+            SPDLOG_TRACE("Packed message size: {}.", size);
+            const std::lock_guard lock(send_mutex_);
+            add_to_batch(data, size);
+        });
+}
+
+
+void MessageEndpointZMQImpl::send_messages(std::vector<knp::core::messaging::MessageVariant> &&messages)
+{
+    const std::lock_guard lock(send_mutex_);
+    for (const auto &message : messages)
+    {
+        knp::core::messaging::pack_to_envelope(
+            message, [this](const uint8_t *data, size_t size) { add_to_batch(data, size); });
+    }
+    SPDLOG_TRACE("{} messages were packed.", messages.size());
+}
+
+
+void MessageEndpointZMQImpl::add_to_batch(const uint8_t *data, size_t size)
+{
+    const size_t record_start = send_batch_.size();
+    const EnvelopeSize envelope_size = size;
+    send_batch_.resize(record_start + sizeof(EnvelopeSize) + get_aligned_size(size));
+    std::memcpy(send_batch_.data() + record_start, &envelope_size, sizeof(EnvelopeSize));
+    std::memcpy(send_batch_.data() + record_start + sizeof(EnvelopeSize), data, size);
+
+    if (send_batch_.size() >= max_batch_size_) flush_batch();
+}
+
+
+void MessageEndpointZMQImpl::flush(bool send_round_marker)
+{
+    const std::lock_guard lock(send_mutex_);
+    flush_batch();
+
+    if (!send_round_marker || !use_round_barrier_) return;
+    SPDLOG_TRACE("Sending round {} marker...", rounds_sent_);
+    send_zmq_message(nullptr, 0);
+    ++rounds_sent_;
+}
+
+
+void MessageEndpointZMQImpl::flush_batch()
+{
+    if (send_batch_.empty()) return;
+    SPDLOG_TRACE("Sending batch of {} bytes...", send_batch_.size());
+    send_zmq_message(send_batch_.data(), send_batch_.size());
+    send_batch_.clear();
+}
+
+
+std::optional<std::pair<const uint8_t *, size_t>> MessageEndpointZMQImpl::next_received_envelope()
+{
+    std::optional<std::pair<const uint8_t *, size_t>> envelope;
+    while (!envelope.has_value())
+    {
+        while (received_frame_offset_ >= received_frame_.size())
+        {
+            auto frame = receive_zmq_message();
+            if (!frame.has_value()) return std::nullopt;
+            received_frame_ = std::move(frame.value());
+            received_frame_offset_ = 0;
+        }
+
+        envelope = read_batch_envelope(received_frame_, received_frame_offset_);
+        if (!envelope.has_value())
+        {
+            SPDLOG_ERROR(
+                "Damaged batch frame: {} bytes were dropped.", received_frame_.size() - received_frame_offset_);
+            received_frame_offset_ = received_frame_.size();
+        }
+    }
+
+    // Saturating decrement: messages routed before metrics were enabled are not counted in the inbox depth.
+    size_t inbox_depth = inbox_depth_.load(std::memory_order_relaxed);
+    while (inbox_depth > 0 &&
+           !inbox_depth_.compare_exchange_weak(inbox_depth, inbox_depth - 1, std::memory_order_relaxed))
+    {
+    }
+
+    return envelope;
+}
+
+
+void MessageEndpointZMQImpl::fill_inbox()
+{
+    // ZMQ routing can't wait for a subscriber, so the limit is applied when messages are taken from the socket.
+    while (auto envelope = next_received_envelope())
+    {
+        // Capacity is checked before unpacking, so that messages to drop are not unpacked.
+        if (is_dropping_new_messages(inbox_, inbox_settings_))
+        {
+            inbox_overflow_counters_.dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        push_to_inbox(
+            inbox_, knp::core::messaging::extract_from_envelope(envelope->first), inbox_settings_,
+            inbox_overflow_counters_);
+    }
+}
+
+
+std::optional<messaging::MessageVariant> MessageEndpointZMQImpl::receive_message()
+{
+    if (InboxSettings::unlimited == inbox_settings_.capacity_ && inbox_.empty())
+    {
+        auto envelope = next_received_envelope();
+        if (!envelope.has_value()) return std::nullopt;
+        return knp::core::messaging::extract_from_envelope(envelope->first);
+    }
+
+    fill_inbox();
+    if (inbox_.empty()) return std::nullopt;
+    auto message = std::move(inbox_.front());
+    inbox_.pop_front();
+    return message;
+}
+
+
+std::vector<messaging::MessageVariant> MessageEndpointZMQImpl::receive_all_messages()
+{
+    std::vector<messaging::MessageVariant> result;
+    if (InboxSettings::unlimited == inbox_settings_.capacity_ && inbox_.empty())
+    {
+        while (auto envelope = next_received_envelope())
+        {
+            result.push_back(knp::core::messaging::extract_from_envelope(envelope->first));
+        }
+        return result;
+    }
+
+    fill_inbox();
+    result.assign(std::make_move_iterator(inbox_.begin()), std::make_move_iterator(inbox_.end()));
+    inbox_.clear();
+    return result;
+}
+
+
+size_t MessageEndpointZMQImpl::receive_all_message_views(const messaging::MessageViewHandler &handler)
+{
+    // Limited inbox keeps unpacked messages.
+    if (InboxSettings::unlimited != inbox_settings_.capacity_ || !inbox_.empty())
+        return MessageEndpointImpl::receive_all_message_views(handler);
+
+    size_t messages_counter = 0;
+    // Views refer to the data of received ZMQ frames, so messages are not unpacked.
+    while (auto envelope = next_received_envelope())
+    {
+        handler(knp::core::messaging::view_envelope(envelope->first));
+        ++messages_counter;
+    }
+    return messages_counter;
+}
+
+
+void MessageEndpointZMQImpl::set_inbox_settings(const InboxSettings &settings)
+{
+    inbox_settings_ = settings;
 }
 
 
@@ -82,41 +260,21 @@ void MessageEndpointZMQImpl::send_zmq_message(const void *data, size_t size)
 
 std::optional<zmq::message_t> MessageEndpointZMQImpl::receive_zmq_message()
 {
+    if (use_round_barrier_) return receive_round_message();
+
     zmq::message_t msg;
-    // `recv_result` is `std::optional` and if it doesn't contain a value, `EAGAIN` is returned by the call.
-    zmq::recv_result_t result;
 
     try
     {
-        std::vector<zmq_pollitem_t> items = {
-            zmq_pollitem_t{sub_socket_.handle(), 0, ZMQ_POLLIN, 0},
-        };
-
-        SPDLOG_DEBUG("Running poll() to receive a message...");
-        // cppcheck-suppress "cppcheckError"
-        if (zmq::poll(items, 0ms) > 0)
-        {
-            SPDLOG_TRACE("poll() was successful, receiving data...");
-            KNP_UNROLL_LOOP()
-            do
-            {
-                result = sub_socket_.recv(msg, zmq::recv_flags::dontwait);
-
-                if (result.has_value())
-                {
-                    SPDLOG_TRACE("Endpoint received {} bytes.", result.value());
-                }
-                else
-                {
-                    SPDLOG_WARN("Endpoint receivied error [EAGAIN].");
-                }
-            } while (!result.has_value());
-        }
-        else
+        // Non-blocking receiving returns `EAGAIN` if there are no frames, so no poll() call is needed.
+        // `recv_result` is `std::optional` and if it doesn't contain a value, `EAGAIN` is returned by the call.
+        const zmq::recv_result_t result = sub_socket_.recv(msg, zmq::recv_flags::dontwait);
+        if (!result.has_value())
         {
-            SPDLOG_DEBUG("poll() returned 0, exiting...");
+            SPDLOG_TRACE("No frames to receive.");
             return std::nullopt;
         }
+        SPDLOG_TRACE("Endpoint received {} bytes.", result.value());
     }
     catch (const zmq::error_t &e)
     {
@@ -126,4 +284,44 @@ std::optional<zmq::message_t> MessageEndpointZMQImpl::receive_zmq_message()
 
     return msg;
 }
+
+
+std::optional<zmq::message_t> MessageEndpointZMQImpl::receive_round_message()
+{
+    // Dealer socket is shared with the sending code.
+    const std::lock_guard lock(send_mutex_);
+
+    try
+    {
+        while (true)
+        {
+            // Receiving blocks until markers of all sent rounds return from the routing bus.
+            const bool is_round_pending = rounds_received_ < rounds_sent_;
+            zmq::message_t msg;
+            const zmq::recv_result_t result =
+                pub_socket_.recv(msg, is_round_pending ? zmq::recv_flags::none : zmq::recv_flags::dontwait);
+            if (!result.has_value())
+            {
+                if (is_round_pending) throw std::runtime_error("Message round was not routed in time.");
+                SPDLOG_TRACE("No frames to receive.");
+                return std::nullopt;
+            }
+
+            if (msg.size() > 0)
+            {
+                SPDLOG_TRACE("Endpoint received {} bytes.", result.value());
+                return msg;
+            }
+
+            SPDLOG_TRACE("Round {} marker received.", rounds_received_);
+            ++rounds_received_;
+        }
+    }
+    catch (const zmq::error_t &e)
+    {
+        SPDLOG_CRITICAL(e.what());
+        throw;
+    }
+}
+
 }  // namespace knp::core::messaging::impl
@@ -20,11 +20,20 @@
  */
 
 #pragma once
+#include <inbox_overflow.h>
 #include <message_endpoint_impl.h>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <zmq.hpp>
@@ -36,40 +45,192 @@
 namespace knp::core::messaging::impl
 {
 
+/**
+ * @brief Size prefix of a message in a batch frame.
+ */
+using EnvelopeSize = uint64_t;
+
+
+/**
+ * @brief Alignment of messages in a batch frame.
+ */
+constexpr size_t batch_alignment = sizeof(EnvelopeSize);
+
+
+/**
+ * @brief Get size of a message in a batch frame aligned to the batch alignment.
+ * @param size message size.
+ * @return aligned size.
+ */
+constexpr size_t get_aligned_size(size_t size)
+{
+    return (size + batch_alignment - 1) / batch_alignment * batch_alignment;
+}
+
+
+/**
+ * @brief Read a message envelope from a batch frame.
+ * @param frame batch frame.
+ * @param offset offset of the envelope size prefix. The offset is moved to the next envelope.
+ * @return envelope data and size or nothing if the envelope doesn't fit into the frame.
+ */
+inline std::optional<std::pair<const uint8_t *, size_t>> read_batch_envelope(
+    const zmq::message_t &frame, size_t &offset)
+{
+    const size_t frame_size = frame.size();
+    if (offset > frame_size || frame_size - offset < sizeof(EnvelopeSize)) return std::nullopt;
+
+    EnvelopeSize envelope_size = 0;
+    std::memcpy(&envelope_size, frame.data<uint8_t>() + offset, sizeof(EnvelopeSize));
+    const size_t envelope_offset = offset + sizeof(EnvelopeSize);
+    const size_t space_left = frame_size - envelope_offset;
+    if (envelope_size > space_left || get_aligned_size(envelope_size) > space_left) return std::nullopt;
+
+    offset = envelope_offset + get_aligned_size(envelope_size);
+    return std::make_pair(frame.data<uint8_t>() + envelope_offset, static_cast<size_t>(envelope_size));
+}
+
+
+/**
+ * @brief Check that all envelopes of a batch frame fit into the frame and contain correct messages.
+ * @param frame batch frame.
+ * @return `true` if messages of the frame can be extracted safely.
+ */
+inline bool verify_batch_frame(const zmq::message_t &frame)
+{
+    size_t offset = 0;
+    while (offset < frame.size())
+    {
+        const auto envelope = read_batch_envelope(frame, offset);
+        if (!envelope.has_value() || !knp::core::messaging::verify_envelope(envelope->first, envelope->second))
+            return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Call a function for each message envelope in a batch frame.
+ * @param frame batch frame.
+ * @param handler function that gets envelope data and size.
+ * @return number of envelopes in the frame.
+ * @throw std::runtime_error if an envelope doesn't fit into the frame.
+ */
+template <class Handler>
+size_t for_each_batch_envelope(const zmq::message_t &frame, Handler &&handler)
+{
+    size_t envelopes_count = 0;
+    for (size_t offset = 0; offset < frame.size(); ++envelopes_count)
+    {
+        const auto envelope = read_batch_envelope(frame, offset);
+        if (!envelope.has_value()) throw std::runtime_error("Batch frame is damaged.");
+        handler(envelope->first, envelope->second);
+    }
+    return envelopes_count;
+}
+
+
+/**
+ * @brief Endpoint implementation class for ZMQ message bus.
+ * 
+ * @details The endpoint packs sent messages into a batch and sends the batch as one ZMQ frame when the batch size
+ * exceeds the limit or when the message bus flushes the endpoint before routing. Each message in a frame is
+ * prefixed by its size and aligned to 8 bytes. The rest of a received frame is dropped if a message doesn't fit into
+ * the frame. Frames of other processes are verified by the routing bus.
+ * 
+ * If messages are exchanged with other processes, the endpoint both sends and receives frames with the dealer
+ * socket. After each flush the endpoint sends an empty frame that marks the end of a round and waits until the
+ * routing bus returns the same marker, so messages of a round are received before the next round begins.
+ */
 class MessageEndpointZMQImpl : public MessageEndpointImpl
 {
 public:
-    explicit MessageEndpointZMQImpl(zmq::socket_t &&sub_socket, zmq::socket_t &&pub_socket);
+    explicit MessageEndpointZMQImpl(
+        zmq::socket_t &&sub_socket, zmq::socket_t &&pub_socket, size_t max_batch_size = 0,
+        bool use_round_barrier = false);
+
+    ~MessageEndpointZMQImpl() override;
 
 public:
-    std::optional<messaging::MessageVariant> receive_message() override
+    std::optional<messaging::MessageVariant> receive_message() override;
+
+    std::vector<messaging::MessageVariant> receive_all_messages() override;
+
+    size_t receive_all_message_views(const messaging::MessageViewHandler &handler) override;
+
+    void send_message(const knp::core::messaging::MessageVariant &message) override;
+
+    void send_messages(std::vector<knp::core::messaging::MessageVariant> &&messages) override;
+
+    void set_inbox_settings(const InboxSettings &settings) override;
+
+    [[nodiscard]] InboxOverflowCounters get_inbox_overflow_counters() const override
     {
-        auto message_var = receive_zmq_message();
-        if (!message_var.has_value())
-        {
-            return {};
-        }
-
-        auto message = knp::core::messaging::extract_from_envelope(message_var->data());
-        return message;
+        return inbox_overflow_counters_.get();
     }
 
-    void send_message(const knp::core::messaging::MessageVariant &message) override
+    /**
+     * @brief Send all batched messages.
+     * @param send_round_marker if `true`, send a marker of the round end after the messages.
+     */
+    void flush(bool send_round_marker = false);
+
+    /**
+     * @brief Add messages routed to the endpoint to its inbox depth.
+     * @param messages_count number of routed messages.
+     */
+    void add_routed_messages(size_t messages_count)
     {
-        auto packed_msg = knp::core::messaging::pack_to_envelope(message);
-        SPDLOG_TRACE("Packed message size: {}.", packed_msg.size());
-        send_zmq_message(packed_msg.data(), packed_msg.size());
+        inbox_depth_.fetch_add(messages_count, std::memory_order_relaxed);
     }
 
+    /**
+     * @brief Get number of routed messages that the endpoint has not received yet.
+     * @return inbox depth.
+     */
+    [[nodiscard]] size_t get_inbox_depth() const { return inbox_depth_.load(std::memory_order_relaxed); }
+
 public:
     void send_zmq_message(const std::vector<uint8_t> &data);
     void send_zmq_message(const void *data, size_t size);
     std::optional<zmq::message_t> receive_zmq_message();
 
+private:
+    void add_to_batch(const uint8_t *data, size_t size);
+    void flush_batch();
+    std::optional<zmq::message_t> receive_round_message();
+    std::optional<std::pair<const uint8_t *, size_t>> next_received_envelope();
+    void fill_inbox();
+
 private:
     // zmq::context_t &context_;
     zmq::socket_t sub_socket_;
     zmq::socket_t pub_socket_;
+
+    // Messages are sent immediately if the maximum batch size is 0.
+    size_t max_batch_size_;
+    std::vector<uint8_t> send_batch_;
+    // Guards sending socket and batch: the bus flushes endpoints from its own thread.
+    std::mutex send_mutex_;
+
+    // Received frame and offset of the next message in it.
+    zmq::message_t received_frame_;
+    size_t received_frame_offset_ = 0;
+
+    // If `true`, frames are received by the dealer socket and rounds are separated by empty frames.
+    bool use_round_barrier_;
+    size_t rounds_sent_ = 0;
+    size_t rounds_received_ = 0;
+
+    // Messages routed while bus metrics were enabled and not received yet.
+    std::atomic<size_t> inbox_depth_{0};
+
+    // Limited inbox takes all received frames before the endpoint receives messages, the limit is applied to each
+    // message taken. Socket high water marks can't replace the limit: round markers of multiprocess buses must not
+    // be dropped, and inbox settings are changed after the socket is connected.
+    InboxSettings inbox_settings_;
+    std::deque<messaging::MessageVariant> inbox_;
+    AtomicInboxOverflowCounters inbox_overflow_counters_;
 };
 
 }  // namespace knp::core::messaging::impl
@@ -65,9 +65,13 @@ std::pair<size_t, UID> MessageEndpoint::get_subscription_key(const MessageEndpoi
 
 MessageEndpoint::MessageEndpoint(MessageEndpoint &&endpoint) noexcept
     : impl_(std::move(endpoint.impl_)),
+      senders_mutex_(std::move(endpoint.senders_mutex_)),
       subscriptions_(std::move(endpoint.subscriptions_)),
-      senders_(std::move(endpoint.senders_))
+      senders_(std::move(endpoint.senders_)),
+      senders_revision_(std::move(endpoint.senders_revision_))
 {
+    // Subscription index is not moved, it is rebuilt on the first message receiving.
+    // Sender set, its revision and mutex are recreated if the moved-from endpoint subscribes again.
 }
 
 
@@ -89,8 +93,15 @@ Subscription<MessageType> &MessageEndpoint::subscribe(const UID &receiver, const
 
     auto iter = subscriptions_.find(std::make_pair(index, receiver));
 
-    if (!senders_) senders_ = std::make_shared<std::unordered_set<knp::core::UID, knp::core::uid_hash>>();
-    senders_->insert(senders.begin(), senders.end());
+    if (!senders_mutex_) senders_mutex_ = std::make_shared<std::mutex>();
+    {
+        // Message bus can read the sender set from the routing thread.
+        const std::lock_guard lock(*senders_mutex_);
+        if (!senders_) senders_ = std::make_shared<std::unordered_set<knp::core::UID, knp::core::uid_hash>>();
+        if (!senders_revision_) senders_revision_ = std::make_shared<size_t>(0);
+        senders_->insert(senders.begin(), senders.end());
+        ++*senders_revision_;
+    }
 
     if (iter != subscriptions_.end())
     {
@@ -101,6 +112,7 @@ Subscription<MessageType> &MessageEndpoint::subscribe(const UID &receiver, const
     }
 
     SPDLOG_TRACE("Existing subscription was not found, creating new subscription...");
+    is_subscription_index_valid_ = false;
     auto sub_variant = SubscriptionVariant{Subscription<MessageType>{receiver, senders}};
     assert(index == sub_variant.index());
     auto insert_res = subscriptions_.emplace(std::make_pair(index, receiver), sub_variant);
@@ -118,9 +130,10 @@ bool MessageEndpoint::unsubscribe(const UID &receiver)
     if (iter != subscriptions_.end())
     {
         subscriptions_.erase(iter);
+        is_subscription_index_valid_ = false;
+        update_senders();
         return true;
     }
-    update_senders();
     return false;
 }
 
@@ -129,11 +142,16 @@ void MessageEndpoint::remove_receiver(const UID &receiver)
 {
     SPDLOG_DEBUG("Removing receiver {}...", std::string(receiver));
 
-    for (auto sub_iter = subscriptions_.begin(); sub_iter != subscriptions_.end(); ++sub_iter)
+    for (auto sub_iter = subscriptions_.begin(); sub_iter != subscriptions_.end();)
     {
         if (get_receiver_uid(sub_iter->second) == receiver)
         {
-            subscriptions_.erase(sub_iter);
+            sub_iter = subscriptions_.erase(sub_iter);
+            is_subscription_index_valid_ = false;
+        }
+        else
+        {
+            ++sub_iter;
         }
     }
     update_senders();
@@ -148,59 +166,103 @@ void MessageEndpoint::send_message(const knp::core::messaging::MessageVariant &m
 }
 
 
-bool MessageEndpoint::receive_message()
+void MessageEndpoint::send_messages(std::vector<knp::core::messaging::MessageVariant> &&messages)
 {
-    SPDLOG_DEBUG("Receiving message...");
+    if (messages.empty()) return;
+    SPDLOG_TRACE("Sending {} messages...", messages.size());
+    impl_->send_messages(std::move(messages));
+}
 
-    auto message_opt = impl_->receive_message();
-    if (!message_opt.has_value())
+
+void MessageEndpoint::update_subscription_index()
+{
+    size_t senders_revision = 0;
+    for (const auto &sub : subscriptions_)
     {
-        SPDLOG_TRACE("No message received.");
-        return false;
+        senders_revision += std::visit([](const auto &sub_var) { return sub_var.get_senders_revision(); }, sub.second);
     }
-    auto &message = message_opt.value();
-    const UID &sender_uid = get_header(message).sender_uid_;
-    const size_t type_index = message.index();
 
-    SPDLOG_TRACE("Subscription count = {}.", subscriptions_.size());
+    if (is_subscription_index_valid_ && senders_revision == indexed_senders_revision_) return;
+
+    SPDLOG_TRACE("Rebuilding subscription index, subscription count = {}.", subscriptions_.size());
+    constexpr size_t message_types_count = std::variant_size_v<messaging::MessageVariant>;
 
-    // Find a subscription.
+    sender_handles_.clear();
+    subscription_index_.clear();
     for (auto &&[k, sub_variant] : subscriptions_)
     {
-        if (sub_variant.index() != type_index)
+        const auto &sub_senders = std::visit([](const auto &sub_var) -> const auto & { return sub_var.get_senders(); },
+                                             sub_variant);
+        for (const auto &sender_uid : sub_senders)
         {
-            SPDLOG_TRACE(
-                "Subscription message type index does not match the message type index [{} != {}].",
-                sub_variant.index(), type_index);
-            continue;
+            const size_t index_position = sender_handles_.intern(sender_uid) * message_types_count + sub_variant.index();
+            if (index_position >= subscription_index_.size())
+                subscription_index_.resize((index_position / message_types_count + 1) * message_types_count);
+            subscription_index_[index_position].push_back(&sub_variant);
         }
+    }
+    // Handles were renumbered.
+    last_sender_handle_ = UIDInterner::invalid_handle;
+    last_sender_uid_ = UID{false};
+    indexed_senders_revision_ = senders_revision;
+    is_subscription_index_valid_ = true;
+}
+
+
+void MessageEndpoint::dispatch_message(messaging::MessageVariant &&message)
+{
+    constexpr size_t message_types_count = std::variant_size_v<messaging::MessageVariant>;
+    const UID &sender_uid = get_header(message).sender_uid_;
+    const size_t type_index = message.index();
 
+    if (UIDInterner::invalid_handle == last_sender_handle_ || sender_uid != last_sender_uid_)
+    {
+        last_sender_handle_ = sender_handles_.find(sender_uid);
+        last_sender_uid_ = sender_uid;
+    }
+
+    if (UIDInterner::invalid_handle == last_sender_handle_ ||
+        subscription_index_[last_sender_handle_ * message_types_count + type_index].empty())
+    {
+        SPDLOG_TRACE("No subscriptions to sender {}, message type index = {}.", std::string(sender_uid), type_index);
+        return;
+    }
+
+    const auto &subscriptions = subscription_index_[last_sender_handle_ * message_types_count + type_index];
+    for (size_t i = 0; i < subscriptions.size(); ++i)
+    {
         std::visit(
-            [&sender_uid, &message](auto &&subscription)
+            [&message, is_last = (i + 1 == subscriptions.size())](auto &subscription)
             {
-                SPDLOG_TRACE("Adding message to subscription, checking sender UID: {}.", std::string(sender_uid));
-                if (subscription.has_sender(sender_uid))
-                {
-                    SPDLOG_TRACE("Subscription has sender with UID {}.", std::string(sender_uid));
-                    subscription.add_message(
-                        std::get<typename std::decay_t<decltype(subscription)>::MessageType>(message));
-                    SPDLOG_TRACE("Message with type index {} was added in the subscription to sender {}.",
-                                 message.index(),
-                                 std::string(sender_uid));
-                }
+                using MessageType = typename std::decay_t<decltype(subscription)>::MessageType;
+                // The last subscription gets the message itself, others get copies.
+                if (is_last)
+                    subscription.add_message(std::move(std::get<MessageType>(message)));
                 else
-                {
-                    SPDLOG_TRACE("Subscription has not sender UID: {}.", std::string(sender_uid));
-                    SPDLOG_TRACE(
-                        "Message was added to the subscription with receiver {}.",
-                        std::string(get_receiver_uid(subscription)));
-                }
+                    subscription.add_message(std::get<MessageType>(message));
             },
-            sub_variant);
+            *subscriptions[i]);
+        SPDLOG_TRACE(
+            "Message with type index {} was added in the subscription to sender {}.", type_index,
+            std::string(sender_uid));
+    }
+}
+
 
-        // sub_variant.swap(v);
+bool MessageEndpoint::receive_message()
+{
+    SPDLOG_DEBUG("Receiving message...");
+
+    auto message_opt = impl_->receive_message();
+    if (!message_opt.has_value())
+    {
+        SPDLOG_TRACE("No message received.");
+        return false;
     }
 
+    update_subscription_index();
+    dispatch_message(std::move(message_opt.value()));
+
     return true;
 }
 
@@ -209,19 +271,44 @@ size_t MessageEndpoint::receive_all_messages(const std::chrono::milliseconds &sl
 {
     size_t messages_counter = 0;
 
+    if (sleep_duration.count() == 0)
+    {
+        auto messages = impl_->receive_all_messages();
+        update_subscription_index();
+        for (auto &message : messages) dispatch_message(std::move(message));
+        return messages.size();
+    }
+
     while (receive_message())
     {
         ++messages_counter;
-        if (sleep_duration.count() != 0)
-        {
-            std::this_thread::sleep_for(sleep_duration);
-        }
+        std::this_thread::sleep_for(sleep_duration);
     }
 
     return messages_counter;
 }
 
 
+size_t MessageEndpoint::receive_all_message_views(const messaging::MessageViewHandler &handler)
+{
+    SPDLOG_DEBUG("Receiving message views...");
+    return impl_->receive_all_message_views(handler);
+}
+
+
+void MessageEndpoint::set_inbox_settings(const InboxSettings &settings)
+{
+    SPDLOG_DEBUG("Setting endpoint inbox capacity to {}...", settings.capacity_);
+    impl_->set_inbox_settings(settings);
+}
+
+
+InboxOverflowCounters MessageEndpoint::get_inbox_overflow_counters() const
+{
+    return impl_->get_inbox_overflow_counters();
+}
+
+
 template <class MessageType>
 std::vector<MessageType> MessageEndpoint::unload_messages(const knp::core::UID &receiver_uid)
 {
@@ -243,15 +330,20 @@ std::vector<MessageType> MessageEndpoint::unload_messages(const knp::core::UID &
 
 void MessageEndpoint::update_senders()
 {
-    if (!senders_) senders_ = std::make_shared<std::unordered_set<knp::core::UID, knp::core::uid_hash>>();
-
     std::unordered_set<knp::core::UID, knp::core::uid_hash> new_senders;
-    new_senders.reserve(senders_->size());
     for (const auto &sub : subscriptions_)
     {
         auto sub_senders = std::visit([](auto &sub_var) { return sub_var.get_senders(); }, sub.second);
         new_senders.insert(sub_senders.begin(), sub_senders.end());
     }
+
+    if (!senders_mutex_) senders_mutex_ = std::make_shared<std::mutex>();
+    // Message bus can read the sender set from the routing thread.
+    const std::lock_guard lock(*senders_mutex_);
+    if (!senders_) senders_ = std::make_shared<std::unordered_set<knp::core::UID, knp::core::uid_hash>>();
+    if (!senders_revision_) senders_revision_ = std::make_shared<size_t>(0);
+    *senders_ = std::move(new_senders);
+    ++*senders_revision_;
 }
 
 
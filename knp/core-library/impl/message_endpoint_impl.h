@@ -4,24 +4,31 @@
  * @kaspersky_support An. Vartenkov
  * @date 25.09.2023
  * @license Apache 2.0
- * @copyright © 2024 AO Kaspersky Lab
- *
- * Licensed under the Apache License, Version 2.0 (the "License");
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- * http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
  * limitations under the License.
  */
 
 #pragma once
 
 #include <knp/core/messaging/message_envelope.h>
+#include <knp/core/inbox_settings.h>
+#include <knp/core/messaging/message_view.h>
+
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace knp::core::messaging::impl
 {
@@ -37,12 +44,64 @@ public:
      */
     virtual std::optional<MessageVariant> receive_message() = 0;
 
+    /**
+     * @brief Receive all messages available at the moment from message bus.
+     * @return received messages in the order of their arrival.
+     * @note Default implementation receives messages one by one.
+     */
+    virtual std::vector<MessageVariant> receive_all_messages()
+    {
+        std::vector<MessageVariant> result;
+        while (auto message = receive_message()) result.push_back(std::move(message.value()));
+        return result;
+    }
+
+    /**
+     * @brief Receive all messages available at the moment from message bus and pass their views to a handler.
+     * @param handler function that gets message views. Views are valid only during the function call.
+     * @return number of received messages.
+     * @note Default implementation receives messages and makes views of them.
+     */
+    virtual size_t receive_all_message_views(const MessageViewHandler &handler)
+    {
+        auto messages = receive_all_messages();
+        for (const auto &message : messages) handler(make_message_view(message));
+        return messages.size();
+    }
+
     /**
      * @brief Send a message to a message bus.
      * @param message message to send.
      */
     virtual void send_message(const MessageVariant &message) = 0;
 
+    /**
+     * @brief Send a batch of messages to a message bus.
+     * @param messages messages to send in the order of sending.
+     * @note Default implementation sends messages one by one.
+     */
+    virtual void send_messages(std::vector<MessageVariant> &&messages)
+    {
+        for (const auto &message : messages) send_message(message);
+    }
+
+    /**
+     * @brief Set capacity and overflow policy of the endpoint inbox.
+     * @param settings inbox settings.
+     * @throw std::logic_error if the implementation doesn't support inbox limits.
+     */
+    virtual void set_inbox_settings(const InboxSettings &settings)
+    {
+        if (InboxSettings::unlimited != settings.capacity_)
+            throw std::logic_error("Message endpoint implementation doesn't support inbox limits.");
+    }
+
+    /**
+     * @brief Get counters of inbox overflows.
+     * @return overflow counters.
+     */
+    [[nodiscard]] virtual InboxOverflowCounters get_inbox_overflow_counters() const { return {}; }
+
     MessageEndpointImpl() = default;
     MessageEndpointImpl(const MessageEndpointImpl &) = default;
     MessageEndpointImpl(MessageEndpointImpl &&) = default;
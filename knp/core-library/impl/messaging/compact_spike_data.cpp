@@ -0,0 +1,175 @@
+/**
+ * @file compact_spike_data.cpp
+ * @brief Compact spike index encoding implementation.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knp/core/messaging/compact_spike_data.h>
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+
+namespace knp::core::messaging
+{
+
+namespace
+{
+uint64_t get_zigzag_delta(SpikeIndex previous, SpikeIndex current)
+{
+    const int64_t delta = static_cast<int64_t>(current) - static_cast<int64_t>(previous);
+    return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+}
+
+
+size_t get_varint_size(uint64_t value)
+{
+    size_t size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+
+bool is_strictly_increasing(const SpikeData &spikes)
+{
+    return std::adjacent_find(spikes.begin(), spikes.end(), std::greater_equal<SpikeIndex>()) == spikes.end();
+}
+
+
+size_t get_delta_varint_size(const SpikeData &spikes)
+{
+    size_t size = 0;
+    SpikeIndex previous = 0;
+    for (const auto spike : spikes)
+    {
+        size += get_varint_size(get_zigzag_delta(previous, spike));
+        previous = spike;
+    }
+    return size;
+}
+
+
+size_t get_bitmap_size(const SpikeData &spikes)
+{
+    return (static_cast<size_t>(spikes.back()) - spikes.front()) / 8 + 1;
+}
+
+
+std::vector<uint8_t> encode_raw(const SpikeData &spikes)
+{
+    // Indexes are stored in host order, like FlatBuffers do on little-endian hosts.
+    std::vector<uint8_t> data(spikes.size() * sizeof(SpikeIndex));
+    if (!spikes.empty()) std::memcpy(data.data(), spikes.data(), data.size());
+    return data;
+}
+
+
+std::vector<uint8_t> encode_delta_varint(const SpikeData &spikes)
+{
+    std::vector<uint8_t> data;
+    data.reserve(get_delta_varint_size(spikes));
+    SpikeIndex previous = 0;
+    for (const auto spike : spikes)
+    {
+        uint64_t value = get_zigzag_delta(previous, spike);
+        while (value >= 0x80)
+        {
+            data.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<uint8_t>(value));
+        previous = spike;
+    }
+    return data;
+}
+
+
+std::vector<uint8_t> encode_bitmap(const SpikeData &spikes)
+{
+    std::vector<uint8_t> data(get_bitmap_size(spikes), 0);
+    for (const auto spike : spikes)
+    {
+        const size_t bit = spike - spikes.front();
+        data[bit / 8] |= static_cast<uint8_t>(1U << (bit % 8));
+    }
+    return data;
+}
+}  // namespace
+
+
+CompactSpikeData::CompactSpikeData(const SpikeData &spikes) : CompactSpikeData(spikes, choose_encoding(spikes)) {}
+
+
+CompactSpikeData::CompactSpikeData(const SpikeData &spikes, SpikeEncoding encoding)
+    : encoding_(encoding), spikes_count_(spikes.size())
+{
+    switch (encoding)
+    {
+        case SpikeEncoding::raw:
+            data_ = encode_raw(spikes);
+            break;
+        case SpikeEncoding::delta_varint:
+            data_ = encode_delta_varint(spikes);
+            break;
+        case SpikeEncoding::bitmap:
+            if (!is_strictly_increasing(spikes))
+                throw std::invalid_argument("Bitmap encoding requires strictly increasing spike indexes.");
+            if (spikes.empty()) break;
+            index_base_ = spikes.front();
+            data_ = encode_bitmap(spikes);
+            break;
+        default:
+            throw std::invalid_argument("Unknown spike encoding.");
+    }
+}
+
+
+CompactSpikeData::CompactSpikeData(
+    SpikeEncoding encoding, std::vector<uint8_t> data, size_t spikes_count, SpikeIndex index_base)
+    : encoding_(encoding), data_(std::move(data)), spikes_count_(spikes_count), index_base_(index_base)
+{
+}
+
+
+SpikeEncoding CompactSpikeData::choose_encoding(const SpikeData &spikes)
+{
+    if (spikes.empty()) return SpikeEncoding::raw;
+
+    // Simpler encoding is preferred if sizes are equal.
+    SpikeEncoding encoding = SpikeEncoding::raw;
+    size_t size = spikes.size() * sizeof(SpikeIndex);
+
+    const size_t delta_varint_size = get_delta_varint_size(spikes);
+    if (delta_varint_size < size)
+    {
+        encoding = SpikeEncoding::delta_varint;
+        size = delta_varint_size;
+    }
+
+    if (is_strictly_increasing(spikes) && get_bitmap_size(spikes) < size) encoding = SpikeEncoding::bitmap;
+
+    return encoding;
+}
+
+}  // namespace knp::core::messaging
@@ -20,6 +20,7 @@
  */
 
 #include <knp/core/messaging/message_envelope.h>
+#include <knp/core/messaging/message_view.h>
 #ifdef __clang__
 #    pragma clang diagnostic push
 #    pragma clang diagnostic ignored "-Wdocumentation"
@@ -32,34 +33,62 @@
 
 #include "spike_message_impl.h"
 #include "synaptic_impact_message_impl.h"
+#include "uid_marshal.h"
+
+#include <type_traits>
 
 
 namespace knp::core::messaging
 {
 
-std::vector<uint8_t> pack_to_envelope(const MessageVariant &message)
+namespace
 {
-    ::flatbuffers::FlatBufferBuilder builder;
-    ::flatbuffers::Offset<marshal::MessageEnvelope> s_msg;
+// Builder is reused by all messages packed in the thread.
+::flatbuffers::FlatBufferBuilder &get_thread_builder()
+{
+    thread_local ::flatbuffers::FlatBufferBuilder builder;
+    builder.Clear();
+    return builder;
+}
 
+
+void pack_to_builder(::flatbuffers::FlatBufferBuilder &builder, const MessageVariant &message)
+{
     SPDLOG_TRACE("Message index = {}.", message.index());
 
     std::visit(
-        [&builder, &s_msg, &message](const auto &msg)
+        [&builder, &message](const auto &msg)
         {
             // Zero index is NONE.
             const auto message_type_index = message.index() + 1;
             SPDLOG_TRACE("Creating envelope for the message type {}...", message_type_index);
-            s_msg = marshal::CreateMessageEnvelope(
+            auto s_msg = marshal::CreateMessageEnvelope(
                 builder, static_cast<marshal::Message>(message_type_index), pack_internal(builder, msg));
             marshal::FinishMessageEnvelopeBuffer(builder, s_msg);
         },
         message);
+}
+}  // namespace
+
+
+std::vector<uint8_t> pack_to_envelope(const MessageVariant &message)
+{
+    auto &builder = get_thread_builder();
+    pack_to_builder(builder, message);
 
     return std::vector<uint8_t>(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
 }
 
 
+void pack_to_envelope(
+    const MessageVariant &message, const std::function<void(const uint8_t *data, size_t size)> &consumer)
+{
+    auto &builder = get_thread_builder();
+    pack_to_builder(builder, message);
+    consumer(builder.GetBufferPointer(), builder.GetSize());
+}
+
+
 MessageVariant extract_from_envelope(const void *buffer)
 {
     auto msg_ev = marshal::GetMessageEnvelope(buffer);
@@ -83,4 +112,76 @@ boost::mp11::mp_rename<AllMessages, std::variant> extract_from_envelope(const st
     return extract_from_envelope(buffer.data());
 }
 
+
+UID get_envelope_sender(const void *buffer)
+{
+    auto msg_ev = marshal::GetMessageEnvelope(buffer);
+
+    switch (msg_ev->message_type())
+    {
+        case marshal::Message_SpikeMessage:
+            return get_unmarshaled_uid(msg_ev->message_as_SpikeMessage()->header()->sender_uid());
+        case marshal::Message_SynapticImpactMessage:
+            return get_unmarshaled_uid(msg_ev->message_as_SynapticImpactMessage()->header()->sender_uid());
+        default:
+            SPDLOG_ERROR("Unknown message type {}.", static_cast<int>(msg_ev->message_type()));
+            throw std::logic_error("Unknown message type.");
+    }
+}
+
+
+bool verify_envelope(const void *buffer, size_t size)
+{
+    ::flatbuffers::Verifier verifier(static_cast<const uint8_t *>(buffer), size);
+    return marshal::VerifyMessageEnvelopeBuffer(verifier);
+}
+
+
+MessageViewVariant view_envelope(const void *buffer)
+{
+    auto msg_ev = marshal::GetMessageEnvelope(buffer);
+
+    switch (msg_ev->message_type())
+    {
+        case marshal::Message_SpikeMessage:
+            SPDLOG_TRACE("Viewing spike message in the envelope...");
+            return view(msg_ev->message_as_SpikeMessage());
+        case marshal::Message_SynapticImpactMessage:
+            SPDLOG_TRACE("Viewing synaptic impact message in the envelope...");
+            return view(msg_ev->message_as_SynapticImpactMessage());
+        default:
+            SPDLOG_ERROR("Unknown message type {}.", static_cast<int>(msg_ev->message_type()));
+            throw std::logic_error("Unknown message type.");
+    }
+}
+
+
+MessageViewVariant make_message_view(const MessageVariant &message)
+{
+    return std::visit(
+        [](const auto &msg) -> MessageViewVariant
+        {
+            using MessageType = std::decay_t<decltype(msg)>;
+            if constexpr (std::is_same_v<MessageType, SpikeMessage>)
+            {
+                return SpikeMessageView{
+                    msg.header_,
+                    SpikeEncoding::raw,
+                    reinterpret_cast<const uint8_t *>(msg.neuron_indexes_.data()),
+                    msg.neuron_indexes_.size(),
+                    0,
+                    msg.neuron_indexes_.size() * sizeof(SpikeIndex)};
+            }
+            else
+            {
+                static_assert(std::is_same_v<MessageType, SynapticImpactMessage>, "Unsupported message type.");
+                return SynapticImpactMessageView{
+                    msg.header_,          msg.presynaptic_population_uid_, msg.postsynaptic_population_uid_,
+                    msg.is_forcing_,      msg.impacts_.size(),             msg.impacts_.data(),
+                    nullptr};
+            }
+        },
+        message);
+}
+
 }  // namespace knp::core::messaging
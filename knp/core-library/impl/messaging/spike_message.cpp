@@ -21,6 +21,10 @@
 
 #include <spdlog/spdlog.h>
 
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
 #include "spike_message_impl.h"
 #include "uid_marshal.h"
 
@@ -75,14 +79,29 @@ std::istream &operator>>(std::istream &stream, SpikeMessage &msg)
 
     marshal::MessageHeader header(get_marshaled_uid(msg.header_.sender_uid_), msg.header_.send_time_);
 
-    return marshal::CreateSpikeMessageDirect(builder, &header, &msg.neuron_indexes_).o;
+    const SpikeEncoding encoding = CompactSpikeData::choose_encoding(msg.neuron_indexes_);
+    // Raw indexes are stored as a plain vector, so they are readable by older versions.
+    if (SpikeEncoding::raw == encoding)
+    {
+        return marshal::CreateSpikeMessageDirect(builder, &header, &msg.neuron_indexes_).o;
+    }
+
+    const CompactSpikeData compact_spikes(msg.neuron_indexes_, encoding);
+    SPDLOG_TRACE(
+        "Spike indexes encoded with encoding {}: {} bytes instead of {}.", static_cast<int>(encoding),
+        compact_spikes.get_data().size(), msg.neuron_indexes_.size() * sizeof(SpikeIndex));
+
+    return marshal::CreateSpikeMessageDirect(
+               builder, &header, nullptr, static_cast<marshal::SpikeEncoding>(encoding), &compact_spikes.get_data(),
+               static_cast<uint32_t>(compact_spikes.size()), compact_spikes.get_index_base())
+        .o;
 }
 
 
 std::vector<uint8_t> pack(const SpikeMessage &msg)
 {
-    // TODO: Don't create an instance every time.
-    ::flatbuffers::FlatBufferBuilder builder;
+    thread_local ::flatbuffers::FlatBufferBuilder builder;
+    builder.Clear();
     auto s_msg = pack_internal(builder, msg);
     marshal::FinishSpikeMessageBuffer(builder, ::flatbuffers::Offset<marshal::SpikeMessage>(s_msg));
     return {builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize()};
@@ -103,8 +122,68 @@ SpikeMessage unpack(const marshal::SpikeMessage *s_msg)
         s_msg_header->sender_uid().data()->end(),    // clang_sa_ignore [core.CallAndMessage]
         uid1.tag.begin());
 
-    return SpikeMessage{
-        {uid1, s_msg_header->send_time()}, {s_msg->neuron_indexes()->begin(), s_msg->neuron_indexes()->end()}};
+    const SpikeMessageView spikes_view = view(s_msg);
+    if (SpikeEncoding::raw == spikes_view.encoding_)
+    {
+        // Raw indexes are copied at once instead of decoding them one by one.
+        SpikeMessage message{{uid1, s_msg_header->send_time()}, SpikeData(spikes_view.size())};
+        if (!message.neuron_indexes_.empty())
+        {
+            std::memcpy(
+                message.neuron_indexes_.data(), spikes_view.encoded_indexes_,
+                message.neuron_indexes_.size() * sizeof(SpikeIndex));
+        }
+        return message;
+    }
+    return SpikeMessage{{uid1, s_msg_header->send_time()}, {spikes_view.begin(), spikes_view.end()}};
+}
+
+
+SpikeMessageView view(const marshal::SpikeMessage *s_msg)
+{
+    SPDLOG_TRACE("Viewing spike message FlatBuffers class...");
+
+    assert(s_msg);
+
+    const marshal::MessageHeader *const s_msg_header{s_msg->header()};
+    const MessageHeader header{get_unmarshaled_uid(s_msg_header->sender_uid()), s_msg_header->send_time()};
+    const auto encoding = static_cast<SpikeEncoding>(s_msg->encoding());
+
+    if (SpikeEncoding::raw == encoding)
+    {
+        const auto *neuron_indexes = s_msg->neuron_indexes();
+        if (!neuron_indexes) return SpikeMessageView{header};
+        // FlatBuffers store scalars in little-endian order, so the indexes are read in place on little-endian hosts.
+        return SpikeMessageView{
+            header,
+            encoding,
+            reinterpret_cast<const uint8_t *>(neuron_indexes->data()),
+            neuron_indexes->size(),
+            0,
+            neuron_indexes->size() * sizeof(SpikeIndex)};
+    }
+
+    const auto *encoded_indexes = s_msg->encoded_indexes();
+    if (!encoded_indexes) return SpikeMessageView{header};
+
+    // Each varint takes at least one byte, each bitmap bit marks at most one index.
+    const size_t encoded_size = encoded_indexes->size();
+    const size_t spikes_count = s_msg->spikes_count();
+    if ((SpikeEncoding::delta_varint == encoding && spikes_count > encoded_size) ||
+        (SpikeEncoding::bitmap == encoding && spikes_count > encoded_size * 8) ||
+        (SpikeEncoding::delta_varint != encoding && SpikeEncoding::bitmap != encoding))
+    {
+        throw std::runtime_error(
+            "Wrong spike message: " + std::to_string(spikes_count) + " indexes in " + std::to_string(encoded_size) +
+            " bytes with encoding " + std::to_string(static_cast<int>(encoding)) + ".");
+    }
+    return SpikeMessageView{
+        header,
+        encoding,
+        encoded_indexes->data(),
+        spikes_count,
+        static_cast<SpikeIndex>(s_msg->index_base()),
+        encoded_size};
 }
 
 
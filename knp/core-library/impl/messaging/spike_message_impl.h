@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <knp/core/messaging/message_view.h>
 #include <knp/core/messaging/spike_message.h>
 
 #ifdef __clang__
@@ -39,4 +40,5 @@ namespace knp::core::messaging
 {
 ::flatbuffers::uoffset_t pack_internal(::flatbuffers::FlatBufferBuilder &builder, const SpikeMessage &msg);
 SpikeMessage unpack(const marshal::SpikeMessage *s_msg);
+SpikeMessageView view(const marshal::SpikeMessage *s_msg);
 }  // namespace knp::core::messaging
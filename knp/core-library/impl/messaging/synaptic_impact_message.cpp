@@ -123,8 +123,8 @@ std::istream &operator>>(std::istream &stream, SynapticImpactMessage &msg)
 
 std::vector<uint8_t> pack(const SynapticImpactMessage &msg)
 {
-    // TODO: Don't create instance every time.
-    ::flatbuffers::FlatBufferBuilder builder;
+    thread_local ::flatbuffers::FlatBufferBuilder builder;
+    builder.Clear();
     auto s_msg = std::move(pack_internal(builder, msg));
     marshal::FinishSynapticImpactMessageBuffer(
         builder, static_cast<::flatbuffers::Offset<marshal::SynapticImpactMessage>>(s_msg));
@@ -167,4 +167,36 @@ SynapticImpactMessage unpack(const marshal::SynapticImpactMessage *s_msg)
         {sender_uid, s_msg_header->send_time()}, presynaptic_uid, postsynaptic_uid, is_forcing, std::move(impacts)};
 }
 
+
+SynapticImpactMessageView view(const marshal::SynapticImpactMessage *s_msg)
+{
+    SPDLOG_TRACE("Viewing synaptic impact message FlatBuffers class...");
+    assert(s_msg);
+
+    const marshal::MessageHeader *const s_msg_header{s_msg->header()};
+
+    return SynapticImpactMessageView{
+        {get_unmarshaled_uid(s_msg_header->sender_uid()), s_msg_header->send_time()},
+        get_unmarshaled_uid(*s_msg->presynaptic_population_uid()),
+        get_unmarshaled_uid(*s_msg->postsynaptic_population_uid()),
+        s_msg->is_forcing(),
+        s_msg->impacts()->size(),
+        nullptr,
+        s_msg->impacts()};
+}
+
+
+SynapticImpact SynapticImpactMessageView::get_impact(size_t index) const
+{
+    if (impacts_) return impacts_[index];
+
+    const auto *s_impacts =
+        static_cast<const ::flatbuffers::Vector<const marshal::SynapticImpact *> *>(serialized_impacts_);
+    const auto *s_impact = s_impacts->Get(index);
+    return SynapticImpact{
+        s_impact->connection_index(), s_impact->impact_value(),
+        static_cast<knp::synapse_traits::OutputType>(s_impact->output_type()), s_impact->presynaptic_neuron_index(),
+        s_impact->postsynaptic_neuron_index()};
+}
+
 }  // namespace knp::core::messaging
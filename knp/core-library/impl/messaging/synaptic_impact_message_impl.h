@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <knp/core/messaging/message_view.h>
 #include <knp/core/messaging/synaptic_impact_message.h>
 
 #ifdef __clang__
@@ -40,4 +41,5 @@ namespace knp::core::messaging
 
 ::flatbuffers::uoffset_t pack_internal(::flatbuffers::FlatBufferBuilder &builder, const SynapticImpactMessage &msg);
 SynapticImpactMessage unpack(const marshal::SynapticImpactMessage *s_msg);
+SynapticImpactMessageView view(const marshal::SynapticImpactMessage *s_msg);
 }  // namespace knp::core::messaging
@@ -30,4 +30,12 @@ inline marshal::UID get_marshaled_uid(const knp::core::UID& uid)
     return flatbuffers::span<const uint8_t, decltype(uid.tag)::static_size()>(uid.tag.data, uid.tag.size());
 }
 
+
+inline knp::core::UID get_unmarshaled_uid(const marshal::UID& uid)
+{
+    knp::core::UID result{false};
+    std::copy(uid.data()->begin(), uid.data()->end(), result.tag.begin());
+    return result;
+}
+
 }  // namespace knp::core::messaging
@@ -23,6 +23,9 @@
 
 #include <spdlog/spdlog.h>
 
+#include <memory>
+#include <utility>
+
 
 // Index functions.
 template <class Index, class Connection>
@@ -137,7 +140,7 @@ Projection<SynapseType>::Projection(
     {
         if (auto params = generator(i))
         {
-            parameters_.emplace_back(std::move(params.value()));
+            parameters_->emplace_back(std::move(params.value()));
         }
     }
     reindex();
@@ -158,13 +161,46 @@ Projection<SynapseType>::Projection(
         if (auto params = generator(i))
         {
             auto &&[p, id_from, id_to] = std::move(params.value());
-            parameters_.emplace_back(Synapse{std::move(p), id_from, id_to});
+            parameters_->emplace_back(Synapse{std::move(p), id_from, id_to});
         }
     }
     reindex();
 }
 
 
+template <typename SynapseType>
+Projection<SynapseType>::Projection(Projection &&projection)
+    : base_(std::move(projection.base_)),
+      presynaptic_uid_(projection.presynaptic_uid_),
+      postsynaptic_uid_(projection.postsynaptic_uid_),
+      is_locked_(projection.is_locked_),
+      parameters_(std::exchange(projection.parameters_, std::make_shared<SynapsesContainer>())),
+      index_(std::move(projection.index_)),
+      is_index_updated_(std::exchange(projection.is_index_updated_, false)),
+      shared_parameters_(std::move(projection.shared_parameters_))
+{
+}
+
+
+template <typename SynapseType>
+Projection<SynapseType> &Projection<SynapseType>::operator=(Projection &&projection)
+{
+    if (this == &projection) return *this;
+
+    // The empty container is allocated first, so that the source projection is not changed if allocation fails.
+    auto empty_synapses = std::make_shared<SynapsesContainer>();
+    base_ = std::move(projection.base_);
+    presynaptic_uid_ = projection.presynaptic_uid_;
+    postsynaptic_uid_ = projection.postsynaptic_uid_;
+    is_locked_ = projection.is_locked_;
+    parameters_ = std::exchange(projection.parameters_, std::move(empty_synapses));
+    index_ = std::move(projection.index_);
+    is_index_updated_ = std::exchange(projection.is_index_updated_, false);
+    shared_parameters_ = std::move(projection.shared_parameters_);
+    return *this;
+}
+
+
 template <typename SynapseType>
 std::vector<size_t> knp::core::Projection<SynapseType>::find_synapses(
     size_t neuron_id, Search search_criterion) const  //!OCLINT(Parameters used)
@@ -192,23 +228,25 @@ template <typename SynapseType>
 size_t knp::core::Projection<SynapseType>::add_synapses(
     SynapseGenerator generator, size_t num_iterations)  //!OCLINT(Parameters used)
 {
-    const size_t starting_size = parameters_.size();
+    auto &synapses = mutable_synapses();
+    const size_t starting_size = synapses.size();
     is_index_updated_ = false;
     for (size_t i = 0; i < num_iterations; ++i)
     {
         if (auto data = generator(i))
         {
-            parameters_.emplace_back(std::move(data.value()));
+            synapses.emplace_back(std::move(data.value()));
         }
     }
-    return parameters_.size() - starting_size;
+    return synapses.size() - starting_size;
 }
 
 
 template <typename SynapseType>
 void Projection<SynapseType>::clear()
 {
-    parameters_.clear();
+    // Shared synapses are not copied, the projection just drops its reference to them.
+    parameters_ = std::make_shared<SynapsesContainer>();
     index_.clear();
 }
 
@@ -217,35 +255,38 @@ template <typename SynapseType>
 void knp::core::Projection<SynapseType>::remove_synapse(size_t index)  //!OCLINT
 {
     is_index_updated_ = false;
-    parameters_.erase(parameters_.begin() + index);
+    auto &synapses = mutable_synapses();
+    synapses.erase(synapses.begin() + index);
 }
 
 
 template <typename SynapseType>
 size_t knp::core::Projection<SynapseType>::remove_synapse_if(std::function<bool(const Synapse &)> predicate)  //!OCLINT
 {
-    const size_t starting_size = parameters_.size();
+    auto &synapses = mutable_synapses();
+    const size_t starting_size = synapses.size();
     is_index_updated_ = false;
-    parameters_.resize(std::remove_if(parameters_.begin(), parameters_.end(), predicate) - parameters_.begin());
-    return starting_size - parameters_.size();
+    synapses.resize(std::remove_if(synapses.begin(), synapses.end(), predicate) - synapses.begin());
+    return starting_size - synapses.size();
 }
 
 
 template <typename SynapseType>
 size_t knp::core::Projection<SynapseType>::remove_postsynaptic_neuron_synapses(size_t neuron_index)  //!OCLINT
 {
-    const size_t starting_size = parameters_.size();
+    auto &synapses = mutable_synapses();
+    const size_t starting_size = synapses.size();
     bool was_index_updated = is_index_updated_;
     // Basic exception safety.
     is_index_updated_ = false;
     auto synapses_to_remove = find_synapses(neuron_index, Search::by_postsynaptic);
     std::sort(synapses_to_remove.begin(), synapses_to_remove.end());
-    remove_by_index(parameters_, synapses_to_remove);
+    remove_by_index(synapses, synapses_to_remove);
     if (was_index_updated)
         for (auto &synapse : synapses_to_remove) index_.erase(synapse);
 
     is_index_updated_ = was_index_updated;
-    return starting_size - parameters_.size();
+    return starting_size - synapses.size();
 }
 
 
@@ -267,9 +308,9 @@ void knp::core::Projection<SynapseType>::reindex() const
     }
 
     index_.clear();
-    for (size_t i = 0; i < parameters_.size(); ++i)
+    for (size_t i = 0; i < parameters_->size(); ++i)
     {
-        auto &synapse = parameters_[i];
+        const auto &synapse = (*parameters_)[i];
         insert_to_index(
             index_,
             Connection{
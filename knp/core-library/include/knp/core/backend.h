@@ -33,9 +33,11 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <boost/config.hpp>
+#include <boost/mp11.hpp>
 
 
 /**
@@ -419,6 +421,85 @@ public:
      */
     [[nodiscard]] virtual DataRanges get_network_data() const = 0;
 
+public:
+    /**
+     * @brief Constant pointer to an entity of the given type.
+     * 
+     * @tparam EntityType population or projection type.
+     */
+    template <class EntityType>
+    using ConstPointer = const EntityType *;
+
+    /**
+     * @brief Variant of constant pointers to any projection type specified in `AllProjections`.
+     */
+    using ProjectionConstPointer =
+        boost::mp11::mp_rename<boost::mp11::mp_transform<ConstPointer, AllProjections>, std::variant>;
+
+    /**
+     * @brief Variant of constant pointers to any population type specified in `AllPopulations`.
+     */
+    using PopulationConstPointer =
+        boost::mp11::mp_rename<boost::mp11::mp_transform<ConstPointer, AllPopulations>, std::variant>;
+
+    /**
+     * @brief Type of the function that receives projections loaded to the backend.
+     */
+    using ProjectionVisitor = std::function<void(const ProjectionConstPointer &)>;
+
+    /**
+     * @brief Type of the function that receives populations loaded to the backend.
+     */
+    using PopulationVisitor = std::function<void(const PopulationConstPointer &)>;
+
+    /**
+     * @brief Pass every projection loaded to the backend to a visitor function.
+     * 
+     * @param visitor function that receives a pointer to a projection.
+     * 
+     * @details Pointers are valid only during the visitor call. The default implementation copies projections by using
+     * `get_network_data()`, backends override the method to pass projections without copying.
+     */
+    virtual void visit_projections(const ProjectionVisitor &visitor) const;
+
+    /**
+     * @brief Pass every population loaded to the backend to a visitor function.
+     * 
+     * @param visitor function that receives a pointer to a population.
+     * 
+     * @details Pointers are valid only during the visitor call. The default implementation copies populations by using
+     * `get_network_data()`, backends override the method to pass populations without copying.
+     */
+    virtual void visit_populations(const PopulationVisitor &visitor) const;
+
+    /**
+     * @brief Call a function for every projection loaded to the backend.
+     * 
+     * @tparam Visitor type of a callable object that accepts a constant reference to any projection type.
+     * 
+     * @param visitor callable object.
+     */
+    template <class Visitor>
+    void for_each_projection(const Visitor &visitor) const
+    {
+        visit_projections([&visitor](const ProjectionConstPointer &projection)
+                          { std::visit([&visitor](const auto *proj) { visitor(*proj); }, projection); });
+    }
+
+    /**
+     * @brief Call a function for every population loaded to the backend.
+     * 
+     * @tparam Visitor type of a callable object that accepts a constant reference to any population type.
+     * 
+     * @param visitor callable object.
+     */
+    template <class Visitor>
+    void for_each_population(const Visitor &visitor) const
+    {
+        visit_populations([&visitor](const PopulationConstPointer &population)
+                          { std::visit([&visitor](const auto *pop) { visitor(*pop); }, population); });
+    }
+
 protected:
     /**
      * @brief Backend default constructor.
@@ -0,0 +1,112 @@
+/**
+ * @file inbox_settings.h
+ * @brief Settings of endpoint inboxes.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief Policy applied to a message routed to an endpoint whose inbox is full.
+ */
+enum class InboxOverflowPolicy
+{
+    /**
+     * @brief Routing waits until the endpoint receives messages. If the inbox is still full after the timeout, the
+     * message is dropped.
+     * 
+     * @details The policy requires asynchronous routing, synchronous routing of the CPU bus throws
+     * `std::logic_error` if an endpoint inbox has the policy. Buses that can't delay routing drop the routed message.
+     */
+    block,
+    /**
+     * @brief The oldest message in the inbox is dropped.
+     */
+    drop_oldest,
+    /**
+     * @brief The routed message is dropped.
+     */
+    drop_newest,
+    /**
+     * @brief Neuron indexes of a spike message are appended to a queued spike message of the same sender and step.
+     * If there is no such message, the oldest message is dropped.
+     */
+    coalesce_spikes
+};
+
+
+/**
+ * @brief Settings of an endpoint inbox, which keeps messages routed to the endpoint until it receives them.
+ */
+struct InboxSettings
+{
+    /**
+     * @brief Capacity value that means no limit.
+     */
+    static constexpr size_t unlimited = 0;
+
+    /**
+     * @brief Maximum number of messages in the inbox.
+     */
+    size_t capacity_ = unlimited;
+
+    /**
+     * @brief Policy applied when the inbox is full.
+     */
+    InboxOverflowPolicy policy_ = InboxOverflowPolicy::drop_oldest;
+
+    /**
+     * @brief Maximum time routing waits for free space if the policy is `InboxOverflowPolicy::block`.
+     */
+    std::chrono::milliseconds block_timeout_ = std::chrono::seconds(1);
+};
+
+
+/**
+ * @brief Counters of inbox overflows.
+ */
+struct InboxOverflowCounters
+{
+    /**
+     * @brief Number of dropped messages.
+     */
+    uint64_t dropped_messages_ = 0;
+
+    /**
+     * @brief Number of spike messages merged into queued messages.
+     */
+    uint64_t coalesced_messages_ = 0;
+
+    /**
+     * @brief Number of times routing waited for free space.
+     */
+    uint64_t blocked_deliveries_ = 0;
+};
+
+}  // namespace knp::core
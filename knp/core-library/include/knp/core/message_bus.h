@@ -21,10 +21,13 @@
 
 #pragma once
 
+#include <knp/core/message_bus_metrics.h>
 #include <knp/core/message_endpoint.h>
 
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <string>
 
 /**
  * @brief Namespace for message bus implementations.
@@ -43,6 +46,98 @@ class MessageBusImpl;
  */
 namespace knp::core
 {
+/**
+ * @brief Settings of ZMQ-based message bus.
+ * 
+ * @details If the address is empty, the bus routes messages inside the process. Otherwise buses of several processes
+ * exchange messages: the routing bus binds to the address, other buses connect to it. Each call of
+ * `MessageBus::route_messages()` is a barrier: the routing bus waits for messages from all processes, sends the
+ * messages to endpoints of all processes, and only after that other processes continue. All processes must call
+ * `route_messages()` the same number of times, and endpoints wait for routed messages when receiving them.
+ */
+struct ZMQBusSettings
+{
+    /**
+     * @brief Default size in bytes after which an endpoint sends its batch of messages.
+     */
+    static constexpr size_t default_max_batch_size = 1024 * 1024;
+
+    /**
+     * @brief Address of the routing bus, for example `ipc:///tmp/knp_bus` or `tcp://127.0.0.1:5555`.
+     */
+    std::string address_;
+
+    /**
+     * @brief `true` if the bus binds to the address and routes messages, `false` if the bus connects to a routing
+     * bus in another process.
+     */
+    bool is_router_ = true;
+
+    /**
+     * @brief Number of processes that exchange messages, including the process of the routing bus.
+     */
+    size_t processes_count_ = 1;
+
+    /**
+     * @brief Size in bytes after which an endpoint sends its batch before message routing.
+     * 
+     * @details Endpoints pack sent messages into batches and send each batch as one ZMQ frame. Use 0 to send every
+     * message in a separate frame.
+     */
+    size_t max_batch_size_ = default_max_batch_size;
+
+    /**
+     * @brief Maximum time to wait for other processes during message routing.
+     */
+    std::chrono::milliseconds timeout_ = std::chrono::minutes(1);
+};
+
+
+/**
+ * @brief Settings of shared memory message bus.
+ * 
+ * @details Endpoints of the bus write serialized messages to lock-free ring buffers in a shared memory segment,
+ * and other endpoints read the messages in place. Buses of several processes on one host exchange messages if they
+ * use the same segment name. Each bus makes messages of its own endpoints visible during
+ * `MessageBus::route_messages()`, and an endpoint receives messages published after it was created.
+ */
+struct SHMBusSettings
+{
+    /**
+     * @brief Default size in bytes of an endpoint ring buffer.
+     */
+    static constexpr size_t default_ring_size = 1024 * 1024;
+
+    /**
+     * @brief Shared memory segment name. If the name is empty, the bus uses a private segment.
+     * 
+     * @details The first bus creates the segment and removes its name on destruction, other buses open it and use
+     * segment parameters set by the first bus.
+     */
+    std::string name_;
+
+    /**
+     * @brief Maximum number of endpoints that exist at the same time.
+     */
+    size_t max_endpoints_ = 32;
+
+    /**
+     * @brief Size in bytes of a ring buffer that keeps messages of one endpoint.
+     * 
+     * @details A message must not take more than half of the ring. Messages sent by an endpoint during one step must
+     * fit the ring, because endpoints receive them only after routing.
+     */
+    size_t ring_size_ = default_ring_size;
+
+    /**
+     * @brief Maximum time an endpoint waits for other endpoints to receive messages if its ring is full.
+     * 
+     * @details Only endpoints with subscriptions hold ring space.
+     */
+    std::chrono::milliseconds timeout_ = std::chrono::seconds(10);
+};
+
+
 /**
  * @brief The MessageBus class is a definition of an interface to a message bus.
  */
@@ -63,6 +158,39 @@ public:
      */
     static std::shared_ptr<MessageBus> construct_zmq_bus();
 
+    /**
+     * @brief Create a ZMQ-based message bus with the given settings.
+     * 
+     * @details Use the method to create buses that exchange messages between processes.
+     * 
+     * @param settings bus settings.
+     * 
+     * @return shared pointer to message bus.
+     * 
+     * @see ZMQBusSettings.
+     */
+    static std::shared_ptr<MessageBus> construct_zmq_bus(const ZMQBusSettings &settings);
+
+    /**
+     * @brief Create a message bus that uses a private shared memory segment.
+     * 
+     * @return shared pointer to message bus.
+     */
+    static std::shared_ptr<MessageBus> construct_shm_bus();
+
+    /**
+     * @brief Create a shared memory message bus with the given settings.
+     * 
+     * @details Use the method to create buses that exchange messages between processes on one host.
+     * 
+     * @param settings bus settings.
+     * 
+     * @return shared pointer to message bus.
+     * 
+     * @see SHMBusSettings.
+     */
+    static std::shared_ptr<MessageBus> construct_shm_bus(const SHMBusSettings &settings);
+
     /**
      * @brief Create a message bus with default implementation.
      * 
@@ -100,32 +228,108 @@ public:
     /**
      * @brief Route some messages.
      * 
+     * @details If asynchronous routing is started, the method works as `route_messages()`.
+     * 
      * @return number of messages routed during the step.
+     * 
+     * @throw std::logic_error if routing is synchronous and an endpoint inbox has the `InboxOverflowPolicy::block`
+     * policy.
      */
     size_t step();
 
     /**
      * @brief Route messages.
      * 
-     * @return number of messages routed.
+     * @details If asynchronous routing is started, the method doesn't route messages itself. It is a fence that waits
+     * until the routing thread delivers all messages sent before the call.
+     * 
+     * @return number of messages routed since the previous call.
+     * 
+     * @throw std::logic_error if routing is synchronous and an endpoint inbox has the `InboxOverflowPolicy::block`
+     * policy.
      */
     size_t route_messages();
 
+    /**
+     * @brief Start routing messages continuously in a dedicated thread.
+     * 
+     * @details The routing thread delivers messages while endpoint owners compute, so a backend that calls
+     * `route_messages()` after sending messages of a step waits only for the rest of routing. Endpoint subscriptions
+     * must not be changed while asynchronous routing runs.
+     * 
+     * @param idle_interval time the routing thread waits for new messages after a routing cycle with no messages.
+     * 
+     * @throw std::logic_error if the bus implementation can't route messages asynchronously.
+     */
+    void start_async_routing(std::chrono::microseconds idle_interval = std::chrono::microseconds(50));
+
+    /**
+     * @brief Stop the routing thread started by `start_async_routing()`.
+     * 
+     * @details Messages sent but not routed by the thread are routed by the next `route_messages()` call.
+     */
+    void stop_async_routing();
+
+    /**
+     * @brief Check if messages are routed by a dedicated thread.
+     * 
+     * @return `true` if asynchronous routing is started.
+     */
+    [[nodiscard]] bool is_async_routing() const { return static_cast<bool>(async_router_); }
+
+    /**
+     * @brief Enable or disable collection of bus metrics.
+     * 
+     * @details Metrics are disabled by default. Counters are relaxed atomics, so collection may stay enabled during
+     * normal operation. The CPU and ZMQ buses collect all metrics, the shared memory bus collects routing time only.
+     * If ZMQ buses of several processes exchange messages, message counters are collected by the routing bus.
+     * 
+     * @param enable `true` to collect metrics, `false` to stop collecting them.
+     */
+    void enable_metrics(bool enable = true);
+
+    /**
+     * @brief Get a snapshot of bus metrics.
+     * 
+     * @return metrics collected since they were enabled or reset.
+     * 
+     * @see MessageBusMetrics.
+     */
+    [[nodiscard]] MessageBusMetrics get_metrics() const;
+
+    /**
+     * @brief Reset all bus metrics to zero.
+     */
+    void reset_metrics();
+
 protected:
     /**
      * @brief Message bus constructor with a specialized implementation.
      * 
      * @param impl message bus implementation.
      * 
-     * @note Currently two implementations are available: ZMQ and CPU.
+     * @note Currently three implementations are available: ZMQ, CPU and shared memory.
      */
     explicit MessageBus(std::unique_ptr<messaging::impl::MessageBusImpl> &&impl);
 
 private:
+    /**
+     * @brief Routing thread of asynchronous routing.
+     */
+    class AsyncRouter;
+
     /**
      * @brief Message bus implementation.
      */
     std::unique_ptr<messaging::impl::MessageBusImpl> impl_;
+
+    /**
+     * @brief Routing thread if asynchronous routing is started.
+     * 
+     * @note The router is declared after the implementation, so that it is stopped before the implementation is
+     * destroyed.
+     */
+    std::unique_ptr<AsyncRouter> async_router_;
 };
 
 }  // namespace knp::core
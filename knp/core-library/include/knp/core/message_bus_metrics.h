@@ -0,0 +1,162 @@
+/**
+ * @file message_bus_metrics.h
+ * @brief Message bus metrics.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/uid.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief Snapshot of message bus metrics.
+ * 
+ * @details Metrics are collected only while they are enabled by `MessageBus::enable_metrics()`. Counters are
+ * accumulated since the metrics were enabled or reset.
+ */
+struct MessageBusMetrics
+{
+    /**
+     * @brief Number of buckets in the histogram of routing time.
+     */
+    static constexpr size_t routing_time_buckets_count = 32;
+
+    /**
+     * @brief Metrics of messages sent by one sender.
+     */
+    struct SenderMetrics
+    {
+        /**
+         * @brief Number of routed messages.
+         */
+        uint64_t messages_ = 0;
+
+        /**
+         * @brief Size of routed messages in bytes.
+         * 
+         * @details The CPU bus counts in-memory message sizes, the ZMQ bus counts serialized message sizes.
+         */
+        uint64_t bytes_ = 0;
+    };
+
+    /**
+     * @brief Metrics of one endpoint.
+     */
+    struct EndpointMetrics
+    {
+        /**
+         * @brief Number of messages routed to the endpoint and not received yet.
+         */
+        uint64_t inbox_depth_ = 0;
+
+        /**
+         * @brief Largest inbox depth observed after message routing.
+         */
+        uint64_t max_inbox_depth_ = 0;
+    };
+
+    /**
+     * @brief Metrics of message senders.
+     */
+    std::unordered_map<UID, SenderMetrics, uid_hash> senders_;
+
+    /**
+     * @brief Metrics of endpoints in the order of their creation.
+     */
+    std::vector<EndpointMetrics> endpoints_;
+
+    /**
+     * @brief Number of `MessageBus::route_messages()` calls.
+     */
+    uint64_t routing_cycles_ = 0;
+
+    /**
+     * @brief Number of routed messages.
+     */
+    uint64_t messages_routed_ = 0;
+
+    /**
+     * @brief Number of messages delivered to endpoints.
+     * 
+     * @details A message routed to several endpoints is counted once for each endpoint.
+     */
+    uint64_t deliveries_ = 0;
+
+    /**
+     * @brief Total time of message routing.
+     */
+    std::chrono::nanoseconds total_routing_time_{0};
+
+    /**
+     * @brief Longest time of one routing cycle.
+     */
+    std::chrono::nanoseconds max_routing_time_{0};
+
+    /**
+     * @brief Histogram of routing cycle time.
+     * 
+     * @details Bucket 0 counts cycles shorter than 1 microsecond, bucket `i` counts cycles that took from `2^(i-1)`
+     * to `2^i` microseconds. The last bucket also counts all longer cycles.
+     */
+    std::array<uint64_t, routing_time_buckets_count> routing_time_histogram_{};
+
+    /**
+     * @brief Get the average number of endpoints a message is delivered to.
+     * 
+     * @return fan-out factor or 0 if no messages were routed.
+     */
+    [[nodiscard]] double get_fan_out() const
+    {
+        return messages_routed_ ? static_cast<double>(deliveries_) / static_cast<double>(messages_routed_) : 0.0;
+    }
+
+    /**
+     * @brief Get the histogram bucket of a routing cycle time.
+     * 
+     * @param routing_time routing cycle time.
+     * 
+     * @return bucket index.
+     */
+    [[nodiscard]] static size_t get_routing_time_bucket(std::chrono::nanoseconds routing_time)
+    {
+        auto microseconds =
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(routing_time).count());
+        size_t bucket = 0;
+        while (microseconds && bucket + 1 < routing_time_buckets_count)
+        {
+            microseconds >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+};
+
+}  // namespace knp::core
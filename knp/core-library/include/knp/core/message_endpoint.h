@@ -21,23 +21,29 @@
 
 #pragma once
 
+#include <knp/core/inbox_settings.h>
 #include <knp/core/messaging/message_envelope.h>
+#include <knp/core/messaging/message_view.h>
 #include <knp/core/messaging/messaging.h>
 #include <knp/core/subscription.h>
 #include <knp/core/uid.h>
+#include <knp/core/uid_interner.h>
 
 #include <any>
 #include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#include <boost/functional/hash.hpp>
 #include <boost/mp11.hpp>
 #include <boost/noncopyable.hpp>
 
@@ -182,6 +188,15 @@ public:
      */
     void send_message(const knp::core::messaging::MessageVariant &message);
 
+    /**
+     * @brief Send a batch of messages to the message bus.
+     * 
+     * @details The method passes all messages to the bus at once, use it to send messages produced during a step.
+     * 
+     * @param messages messages to send. Messages are moved to the bus.
+     */
+    void send_messages(std::vector<knp::core::messaging::MessageVariant> &&messages);
+
     /**
      * @brief Receive a message from the message bus.
      * 
@@ -195,9 +210,45 @@ public:
      * @param sleep_duration time interval in milliseconds between the moments of receiving messages.
      * 
      * @return number of received messages.
+     * 
+     * @details If the time interval is zero, the method receives all available messages at once.
      */
     size_t receive_all_messages(const std::chrono::milliseconds &sleep_duration = std::chrono::milliseconds(0));
 
+    /**
+     * @brief Receive all messages that were sent to the endpoint and pass their views to a handler.
+     * 
+     * @details Message views let the handler read neuron indexes and impacts in place, without unpacking messages
+     * received from a serializing message bus. Messages received by the method are not added to subscriptions.
+     * 
+     * @param handler function that gets message views. Views are valid only during the function call.
+     * 
+     * @return number of received messages.
+     */
+    size_t receive_all_message_views(const messaging::MessageViewHandler &handler);
+
+    /**
+     * @brief Limit the number of messages routed to the endpoint and not received yet.
+     * 
+     * @details Inboxes are unlimited by default. Use a limit for endpoints that may be drained rarely, such as
+     * observers and output channels, to bound memory usage. Endpoints of the CPU bus apply the policy when messages
+     * are routed, and the `block` policy requires asynchronous routing there. Endpoints of the ZMQ bus apply it to
+     * each message they take from the socket when receiving messages, and the `block` policy drops the newest
+     * messages there, because ZMQ routing can't wait for a subscriber.
+     * 
+     * @param settings inbox capacity and overflow policy.
+     * 
+     * @throw std::logic_error if the bus implementation doesn't support inbox limits.
+     */
+    void set_inbox_settings(const InboxSettings &settings);
+
+    /**
+     * @brief Get counters of messages dropped or coalesced because the inbox was full.
+     * 
+     * @return overflow counters.
+     */
+    [[nodiscard]] InboxOverflowCounters get_inbox_overflow_counters() const;
+
     /**
      * @brief Read messages of the specified type received via subscription.
      * 
@@ -228,6 +279,8 @@ public:
     /**
      * @brief Get list of senders.
      * 
+     * @note The endpoint changes the set under the sender mutex.
+     * 
      * @return weak pointer to unordered set of sender UIDs.
      */
     auto get_senders_ptr()
@@ -236,12 +289,34 @@ public:
         return result;
     }
 
+    /**
+     * @brief Get revision number of the sender list.
+     * 
+     * @details The revision number changes every time the list of senders changes. Message bus implementations use
+     * the number to update their routing tables. The endpoint changes the number under the sender mutex.
+     * 
+     * @return weak pointer to revision number.
+     */
+    auto get_senders_revision_ptr() const
+    {
+        std::weak_ptr<const size_t> result{senders_revision_};
+        return result;
+    }
+
 protected:
     /**
      * @brief Message endpoint implementation.
      */
     std::shared_ptr<messaging::impl::MessageEndpointImpl> impl_;
 
+    /**
+     * @brief Mutex that guards the sender set and its revision number.
+     * 
+     * @details Message bus implementations that read the sender set from their own threads replace the mutex with
+     * a mutex they lock when reading the set.
+     */
+    std::shared_ptr<std::mutex> senders_mutex_ = std::make_shared<std::mutex>();
+
 protected:
     /**
      * @brief Message endpoint default constructor.
@@ -260,6 +335,59 @@ private:
     std::shared_ptr<std::unordered_set<knp::core::UID, knp::core::uid_hash>> senders_ =
         std::make_shared<std::unordered_set<knp::core::UID, knp::core::uid_hash>>();
 
+    /**
+     * @brief Revision number of the sender set.
+     */
+    std::shared_ptr<size_t> senders_revision_ = std::make_shared<size_t>(0);
+
+    /**
+     * @brief Sender UIDs interned when the subscription index is built.
+     */
+    UIDInterner sender_handles_;
+
+    /**
+     * @brief Subscriptions indexed by sender handle and message type index.
+     * 
+     * @details Subscriptions to a sender are placed at `sender_handle * message_types_count + type_index`.
+     */
+    std::vector<std::vector<SubscriptionVariant *>> subscription_index_;
+
+    /**
+     * @brief Sender UID of the previously dispatched message.
+     */
+    UID last_sender_uid_{false};
+
+    /**
+     * @brief Handle of the previously dispatched message sender.
+     * 
+     * @details Messages of one sender usually arrive in a row, so the handle is reused without lookup.
+     */
+    UIDHandle last_sender_handle_ = UIDInterner::invalid_handle;
+
+    /**
+     * @brief Sum of subscription sender revisions used to build the subscription index.
+     * 
+     * @details Senders can be changed directly via subscriptions, the sum changes in this case.
+     */
+    size_t indexed_senders_revision_ = 0;
+
+    /**
+     * @brief `true` if the subscription index must be rebuilt regardless of sender revisions.
+     */
+    bool is_subscription_index_valid_ = false;
+
+    /**
+     * @brief Rebuild the subscription index if subscriptions changed since the previous call.
+     */
+    void update_subscription_index();
+
+    /**
+     * @brief Add a received message to all subscriptions to its sender.
+     * 
+     * @param message received message.
+     */
+    void dispatch_message(messaging::MessageVariant &&message);
+
     /**
      * @brief Update list of senders.
      */
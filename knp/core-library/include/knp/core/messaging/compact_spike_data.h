@@ -0,0 +1,325 @@
+/**
+ * @file compact_spike_data.h
+ * @brief Compact encoding of spike indexes.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/messaging/spike_message.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+
+/**
+ * @brief Messaging namespace.
+ */
+namespace knp::core::messaging
+{
+
+/**
+ * @brief Encoding of spike indexes.
+ */
+enum class SpikeEncoding : uint8_t
+{
+    /**
+     * @brief Indexes are stored as 32-bit little-endian integers.
+     */
+    raw = 0,
+    /**
+     * @brief Differences between neighboring indexes are stored as zigzag varints.
+     * @details Sorted lists of close indexes take 1-2 bytes per spike, unsorted lists are supported too.
+     */
+    delta_varint = 1,
+    /**
+     * @brief Indexes are stored as bits of a bitmap that starts at the smallest index.
+     * @details The encoding is used only for strictly increasing indexes, it suits dense bursts.
+     */
+    bitmap = 2
+};
+
+
+/**
+ * @brief Forward iterator that decodes spike indexes one by one.
+ * 
+ * @details The iterator doesn't read past the end of encoded data, so damaged data leads to an exception instead of
+ * reading foreign memory.
+ */
+class SpikeIndexIterator
+{
+public:
+    /**
+     * @brief Iterator category.
+     */
+    using iterator_category = std::forward_iterator_tag;
+    /**
+     * @brief Value type.
+     */
+    using value_type = SpikeIndex;
+    /**
+     * @brief Difference type.
+     */
+    using difference_type = std::ptrdiff_t;
+    /**
+     * @brief Pointer type.
+     */
+    using pointer = const SpikeIndex *;
+    /**
+     * @brief Reference type. Indexes are decoded, so the iterator returns values.
+     */
+    using reference = SpikeIndex;
+
+public:
+    /**
+     * @brief Construct an end iterator.
+     */
+    SpikeIndexIterator() = default;
+
+    /**
+     * @brief Construct an iterator that points to the first index of encoded data.
+     * @param encoding data encoding.
+     * @param data encoded data.
+     * @param data_size size of encoded data in bytes.
+     * @param spikes_count number of encoded indexes.
+     * @param index_base smallest index for bitmap encoding.
+     * @throw std::runtime_error if encoded data ends before all indexes are decoded.
+     */
+    SpikeIndexIterator(
+        SpikeEncoding encoding, const uint8_t *data, size_t data_size, size_t spikes_count, SpikeIndex index_base = 0)
+        : encoding_(encoding),
+          data_(data),
+          data_end_(data + data_size),
+          remaining_count_(spikes_count),
+          index_base_(index_base)
+    {
+        if (remaining_count_ > 0) decode_next();
+    }
+
+public:
+    /**
+     * @brief Get current index.
+     * @return spike index.
+     */
+    SpikeIndex operator*() const { return value_; }
+
+    /**
+     * @brief Move to the next index.
+     * @return iterator.
+     * @throw std::runtime_error if encoded data ends before all indexes are decoded.
+     */
+    SpikeIndexIterator &operator++()
+    {
+        if (--remaining_count_ > 0) decode_next();
+        return *this;
+    }
+
+    /**
+     * @brief Move to the next index.
+     * @return iterator before the move.
+     */
+    SpikeIndexIterator operator++(int)
+    {
+        SpikeIndexIterator result = *this;
+        ++*this;
+        return result;
+    }
+
+    /**
+     * @brief Compare iterators of the same data.
+     * @param other other iterator.
+     * @return `true` if both iterators have the same number of remaining indexes.
+     */
+    bool operator==(const SpikeIndexIterator &other) const { return remaining_count_ == other.remaining_count_; }
+
+    /**
+     * @brief Compare iterators of the same data.
+     * @param other other iterator.
+     * @return `true` if iterators have different numbers of remaining indexes.
+     */
+    bool operator!=(const SpikeIndexIterator &other) const { return !(*this == other); }
+
+private:
+    void decode_next()
+    {
+        switch (encoding_)
+        {
+            case SpikeEncoding::raw:
+                if (static_cast<size_t>(data_end_ - data_) < sizeof(SpikeIndex)) throw_truncated();
+                std::memcpy(&value_, data_, sizeof(SpikeIndex));
+                data_ += sizeof(SpikeIndex);
+                break;
+            case SpikeEncoding::delta_varint:
+            {
+                uint64_t zigzag_delta = 0;
+                for (unsigned shift = 0;; shift += 7)
+                {
+                    // A 64-bit value takes at most 10 bytes.
+                    if (data_ == data_end_ || shift > 63) throw_truncated();
+                    const uint8_t byte = *data_++;
+                    zigzag_delta |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                    if (!(byte & 0x80)) break;
+                }
+                const int64_t delta = static_cast<int64_t>(zigzag_delta >> 1) ^ -static_cast<int64_t>(zigzag_delta & 1);
+                value_ = static_cast<SpikeIndex>(static_cast<int64_t>(value_) + delta);
+                break;
+            }
+            case SpikeEncoding::bitmap:
+                // Zero bytes are skipped whole, `bit_position_` is the position of the next bit to check.
+                while (true)
+                {
+                    if (bit_position_ / 8 >= static_cast<size_t>(data_end_ - data_)) throw_truncated();
+                    const uint8_t bits = data_[bit_position_ / 8] >> (bit_position_ % 8);
+                    if (!bits)
+                    {
+                        bit_position_ = (bit_position_ / 8 + 1) * 8;
+                        continue;
+                    }
+                    uint8_t shift = 0;
+                    while (!((bits >> shift) & 1)) ++shift;
+                    bit_position_ += shift;
+                    break;
+                }
+                value_ = index_base_ + static_cast<SpikeIndex>(bit_position_++);
+                break;
+            default:
+                throw std::runtime_error("Unknown spike encoding.");
+        }
+    }
+
+    [[noreturn]] static void throw_truncated() { throw std::runtime_error("Encoded spike indexes are damaged."); }
+
+private:
+    SpikeEncoding encoding_ = SpikeEncoding::raw;
+    const uint8_t *data_ = nullptr;
+    const uint8_t *data_end_ = nullptr;
+    size_t remaining_count_ = 0;
+    SpikeIndex index_base_ = 0;
+    SpikeIndex value_ = 0;
+    size_t bit_position_ = 0;
+};
+
+
+/**
+ * @brief Spike indexes stored in the most compact of supported encodings.
+ * 
+ * @details The container chooses an encoding by the density of indexes: a bitmap for dense sorted bursts, zigzag
+ * delta varints for sparse lists and raw 32-bit indexes if neither is smaller. Indexes are decoded during iteration.
+ */
+class CompactSpikeData
+{
+public:
+    /**
+     * @brief Construct an empty container.
+     */
+    CompactSpikeData() = default;
+
+    /**
+     * @brief Encode spike indexes with the most compact encoding.
+     * @param spikes spike indexes.
+     */
+    explicit CompactSpikeData(const SpikeData &spikes);
+
+    /**
+     * @brief Encode spike indexes with the given encoding.
+     * @param spikes spike indexes.
+     * @param encoding encoding. Bitmap encoding requires strictly increasing indexes.
+     * @throw std::invalid_argument if the indexes can't be encoded with the encoding.
+     */
+    CompactSpikeData(const SpikeData &spikes, SpikeEncoding encoding);
+
+    /**
+     * @brief Construct a container from encoded data.
+     * @param encoding data encoding.
+     * @param data encoded data.
+     * @param spikes_count number of encoded indexes.
+     * @param index_base smallest index for bitmap encoding.
+     */
+    CompactSpikeData(SpikeEncoding encoding, std::vector<uint8_t> data, size_t spikes_count, SpikeIndex index_base = 0);
+
+public:
+    /**
+     * @brief Choose the most compact encoding for spike indexes.
+     * @param spikes spike indexes.
+     * @return encoding.
+     */
+    [[nodiscard]] static SpikeEncoding choose_encoding(const SpikeData &spikes);
+
+    /**
+     * @brief Get encoding of the data.
+     * @return encoding.
+     */
+    [[nodiscard]] SpikeEncoding get_encoding() const { return encoding_; }
+
+    /**
+     * @brief Get encoded data.
+     * @return encoded data.
+     */
+    [[nodiscard]] const std::vector<uint8_t> &get_data() const { return data_; }
+
+    /**
+     * @brief Get the smallest index for bitmap encoding.
+     * @return index base.
+     */
+    [[nodiscard]] SpikeIndex get_index_base() const { return index_base_; }
+
+    /**
+     * @brief Get number of spikes.
+     * @return number of spike indexes.
+     */
+    [[nodiscard]] size_t size() const { return spikes_count_; }
+
+    /**
+     * @brief Check if the container has no spikes.
+     * @return `true` if there are no spike indexes.
+     */
+    [[nodiscard]] bool empty() const { return 0 == spikes_count_; }
+
+    /**
+     * @brief Get iterator to the first spike index.
+     * @return iterator.
+     */
+    [[nodiscard]] SpikeIndexIterator begin() const
+    {
+        return SpikeIndexIterator(encoding_, data_.data(), data_.size(), spikes_count_, index_base_);
+    }
+
+    /**
+     * @brief Get iterator past the last spike index.
+     * @return iterator.
+     */
+    [[nodiscard]] SpikeIndexIterator end() const { return SpikeIndexIterator(); }
+
+    /**
+     * @brief Decode all spike indexes.
+     * @return spike indexes.
+     */
+    [[nodiscard]] SpikeData decode() const { return SpikeData(begin(), end()); }
+
+private:
+    SpikeEncoding encoding_ = SpikeEncoding::raw;
+    std::vector<uint8_t> data_;
+    size_t spikes_count_ = 0;
+    SpikeIndex index_base_ = 0;
+};
+
+}  // namespace knp::core::messaging
@@ -23,6 +23,7 @@
 
 #include <knp/core/uid.h>
 
+#include <functional>
 #include <iostream>
 #include <variant>
 #include <vector>
@@ -57,6 +58,17 @@ using MessageVariant = boost::mp11::mp_rename<AllMessages, std::variant>;
  * @return vector with data of a serialized message.
  */
 std::vector<uint8_t> pack_to_envelope(const MessageVariant &message);
+/**
+ * @brief Pack messages to envelope and pass serialized data to a function.
+ * 
+ * @details The method uses a serialization buffer reused by all calls in the current thread, serialized data is
+ * valid only during the function call.
+ * 
+ * @param message message to pack.
+ * @param consumer function that gets pointer to serialized data and data size.
+ */
+void pack_to_envelope(
+    const MessageVariant &message, const std::function<void(const uint8_t *data, size_t size)> &consumer);
 /**
  * @brief Extract messages from envelope.
  * 
@@ -73,5 +85,24 @@ MessageVariant extract_from_envelope(const void *buffer);
  * @return `std::variant` of message types.
  */
 MessageVariant extract_from_envelope(const std::vector<uint8_t> &buffer);
+/**
+ * @brief Get sender UID of a message packed to envelope without unpacking the message.
+ * 
+ * @param buffer message buffer.
+ * 
+ * @return sender UID.
+ */
+UID get_envelope_sender(const void *buffer);
+/**
+ * @brief Check that a buffer contains a correct message envelope.
+ * 
+ * @details Use the function before extracting or viewing messages received from untrusted sources.
+ * 
+ * @param buffer message buffer.
+ * @param size buffer size.
+ * 
+ * @return `true` if the envelope can be extracted without reading past the buffer end.
+ */
+bool verify_envelope(const void *buffer, size_t size);
 
 }  // namespace knp::core::messaging
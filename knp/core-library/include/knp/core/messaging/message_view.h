@@ -0,0 +1,198 @@
+/**
+ * @file message_view.h
+ * @brief Non-owning views of messages.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/messaging/compact_spike_data.h>
+#include <knp/core/messaging/message_envelope.h>
+
+#include <functional>
+#include <variant>
+
+
+/**
+ * @brief Messaging namespace.
+ */
+namespace knp::core::messaging
+{
+
+/**
+ * @brief Non-owning view of a spike message.
+ * 
+ * @details The view reads neuron indexes directly from a message or from a serialized message buffer. Indexes of
+ * serialized messages can be encoded compactly, they are decoded during iteration. The view is valid while the
+ * message or the buffer exists.
+ */
+struct SpikeMessageView
+{
+    /**
+     * @brief Message header.
+     */
+    MessageHeader header_;
+
+    /**
+     * @brief Encoding of neuron indexes.
+     */
+    SpikeEncoding encoding_ = SpikeEncoding::raw;
+
+    /**
+     * @brief Pointer to encoded indexes of the recently spiked neurons.
+     */
+    const uint8_t *encoded_indexes_ = nullptr;
+
+    /**
+     * @brief Number of spiked neurons.
+     */
+    size_t neuron_count_ = 0;
+
+    /**
+     * @brief Smallest neuron index for bitmap encoding.
+     */
+    SpikeIndex index_base_ = 0;
+
+    /**
+     * @brief Size of encoded indexes in bytes.
+     */
+    size_t encoded_size_ = 0;
+
+    /**
+     * @brief Get an iterator to the first neuron index.
+     * 
+     * @return iterator to the first neuron index.
+     * 
+     * @throw std::runtime_error if encoded indexes are damaged.
+     */
+    [[nodiscard]] SpikeIndexIterator begin() const
+    {
+        return SpikeIndexIterator(encoding_, encoded_indexes_, encoded_size_, neuron_count_, index_base_);
+    }
+
+    /**
+     * @brief Get an iterator past the last neuron index.
+     * 
+     * @return iterator past the last neuron index.
+     */
+    [[nodiscard]] SpikeIndexIterator end() const { return SpikeIndexIterator(); }
+
+    /**
+     * @brief Get number of spiked neurons.
+     * 
+     * @return number of neuron indexes.
+     */
+    [[nodiscard]] size_t size() const { return neuron_count_; }
+};
+
+
+/**
+ * @brief Non-owning view of a synaptic impact message.
+ * 
+ * @details The view reads impacts directly from a message or from a serialized message buffer. The view is valid
+ * while the message or the buffer exists.
+ */
+struct SynapticImpactMessageView
+{
+    /**
+     * @brief Message header.
+     */
+    MessageHeader header_;
+
+    /**
+     * @brief UID of the population that sends spikes to the projection.
+     */
+    UID presynaptic_population_uid_;
+
+    /**
+     * @brief UID of the population that receives impacts from the projection.
+     */
+    UID postsynaptic_population_uid_;
+
+    /**
+     * @brief Boolean value that defines whether the signal is from a projection without plasticity.
+     */
+    bool is_forcing_ = false;
+
+    /**
+     * @brief Number of impacts.
+     */
+    size_t impact_count_ = 0;
+
+    /**
+     * @brief Pointer to impacts if the view refers to a message.
+     */
+    const SynapticImpact *impacts_ = nullptr;
+
+    /**
+     * @brief Pointer to serialized impacts if the view refers to a serialized message buffer.
+     */
+    const void *serialized_impacts_ = nullptr;
+
+    /**
+     * @brief Get impact with the given index.
+     * 
+     * @param index impact index.
+     * 
+     * @return impact.
+     */
+    [[nodiscard]] SynapticImpact get_impact(size_t index) const;
+
+    /**
+     * @brief Get number of impacts.
+     * 
+     * @return number of impacts.
+     */
+    [[nodiscard]] size_t size() const { return impact_count_; }
+};
+
+
+/**
+ * @brief Message view variant that contains any message view type.
+ * 
+ * @details View types are placed in the same order as message types in `MessageVariant`.
+ */
+using MessageViewVariant = std::variant<SpikeMessageView, SynapticImpactMessageView>;
+
+
+/**
+ * @brief Type of function that processes message views.
+ */
+using MessageViewHandler = std::function<void(const MessageViewVariant &)>;
+
+
+/**
+ * @brief Get view of a message.
+ * 
+ * @param message message.
+ * 
+ * @return message view valid while the message exists.
+ */
+MessageViewVariant make_message_view(const MessageVariant &message);
+
+
+/**
+ * @brief Get view of a message packed to envelope without unpacking the message.
+ * 
+ * @param buffer message buffer.
+ * 
+ * @return message view valid while the buffer exists.
+ */
+MessageViewVariant view_envelope(const void *buffer);
+
+}  // namespace knp::core::messaging
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <knp/core/messaging/compact_spike_data.h>
 #include <knp/core/messaging/message_header.h>
 #include <knp/core/messaging/spike_message.h>
 #include <knp/core/messaging/synaptic_impact_message.h>
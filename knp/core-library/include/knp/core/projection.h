@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <tuple>
 #include <unordered_map>
@@ -206,6 +207,45 @@ public:
      */
     Projection(UID uid, UID presynaptic_uid, UID postsynaptic_uid, SynapseGenerator generator, size_t num_iterations);
 
+    /**
+     * @brief Copy constructor.
+     * 
+     * @details The copy shares synapses with the source projection until one of them modifies synapses.
+     * 
+     * @param projection source projection.
+     */
+    Projection(const Projection &projection) = default;
+
+    /**
+     * @brief Move constructor.
+     * 
+     * @param projection source projection. The source projection is left without synapses.
+     */
+    Projection(Projection &&projection);
+
+    /**
+     * @brief Copy assignment operator.
+     * 
+     * @param projection source projection.
+     * 
+     * @return reference to this projection.
+     */
+    Projection &operator=(const Projection &projection) = default;
+
+    /**
+     * @brief Move assignment operator.
+     * 
+     * @param projection source projection. The source projection is left without synapses.
+     * 
+     * @return reference to this projection.
+     */
+    Projection &operator=(Projection &&projection);
+
+    /**
+     * @brief Destructor.
+     */
+    ~Projection() = default;
+
 public:
     /**
      * @brief Get projection UID.
@@ -239,8 +279,10 @@ public:
      * @param index synapse index.
      * 
      * @return synapse parameters and indexes.
+     * 
+     * @note If synapses are shared with other projection copies, the method makes a private copy of them first.
      */
-    [[nodiscard]] Synapse &operator[](size_t index) { return parameters_[index]; }
+    [[nodiscard]] Synapse &operator[](size_t index) { return mutable_synapses()[index]; }
 
     /**
      * @brief Get parameter values of a synapse with the given index.
@@ -251,35 +293,48 @@ public:
      * 
      * @note Constant method.
      */
-    [[nodiscard]] const Synapse &operator[](size_t index) const { return parameters_[index]; }
+    [[nodiscard]] const Synapse &operator[](size_t index) const { return (*parameters_)[index]; }
 
     /**
      * @brief Get an iterator pointing to the first element of the projection.
      * 
      * @return constant projection iterator.
      */
-    [[nodiscard]] auto begin() const { return parameters_.cbegin(); }
+    [[nodiscard]] auto begin() const { return parameters_->cbegin(); }
 
     /**
      * @brief Get an iterator pointing to the first element of the projection.
      * 
      * @return projection iterator.
+     * 
+     * @note If synapses are shared with other projection copies, the method makes a private copy of them first.
      */
-    [[nodiscard]] auto begin() { return parameters_.begin(); }
+    [[nodiscard]] auto begin() { return mutable_synapses().begin(); }
 
     /**
      * @brief Get an iterator pointing to the last element of the projection.
      * 
      * @return constant iterator.
      */
-    [[nodiscard]] auto end() const { return parameters_.cend(); }
+    [[nodiscard]] auto end() const { return parameters_->cend(); }
 
     /**
      * @brief Get an iterator pointing to the last element of the projection.
      * 
      * @return iterator.
+     * 
+     * @note If synapses are shared with other projection copies, the method makes a private copy of them first.
      */
-    [[nodiscard]] auto end() { return parameters_.end(); }
+    [[nodiscard]] auto end() { return mutable_synapses().end(); }
+
+    /**
+     * @brief Get all synapses of the projection.
+     * 
+     * @return constant reference to the container of synapses.
+     * 
+     * @note Constant method. Use it to read synapse parameters without copying the projection.
+     */
+    [[nodiscard]] const SynapsesContainer &get_synapses() const { return *parameters_; }
 
 public:
     /**
@@ -287,7 +342,7 @@ public:
      * 
      * @return number of synapses.
      */
-    [[nodiscard]] size_t size() const { return parameters_.size(); }
+    [[nodiscard]] size_t size() const { return parameters_->size(); }
 
     /**
      * @brief Get UID of the associated population from which this projection receives spikes.
@@ -395,6 +450,30 @@ public:
      */
     bool is_locked() const { return is_locked_; }
 
+public:
+    /**
+     * @brief Determine if the synapse storage is shared with other projection copies.
+     * 
+     * @details Copies of a projection share one immutable synapse container. The container is copied only when one
+     * of the projections modifies synapses (copy-on-write), so several inference replicas of a trained network use
+     * a single weight array.
+     * 
+     * @return `true` if the synapses are shared, `false` if the projection owns its synapses exclusively.
+     * 
+     * @note The result is reliable only if no other thread copies or destroys projections sharing the synapses.
+     */
+    [[nodiscard]] bool has_shared_synapses() const { return parameters_.use_count() > 1; }
+
+    /**
+     * @brief Make a private copy of the synapses if they are shared with other projection copies.
+     * 
+     * @details Call the method before modifying synapses of the same projection from several threads.
+     * 
+     * @note The method must not be called while another thread copies the projection: the copy can start sharing
+     * synapses after they are checked, and then the modification becomes visible to the copy.
+     */
+    void unshare_synapses() { mutable_synapses(); }
+
 public:
     /**
      * @brief Get parameters shared between all synapses.
@@ -414,6 +493,13 @@ public:
 private:
     void reindex() const;
 
+    // Copies and modifications of projections sharing synapses must not run concurrently, see `unshare_synapses()`.
+    SynapsesContainer &mutable_synapses()
+    {
+        if (parameters_.use_count() > 1) parameters_ = std::make_shared<SynapsesContainer>(*parameters_);
+        return *parameters_;
+    }
+
     BaseData base_;
 
     /**
@@ -432,9 +518,9 @@ private:
     bool is_locked_ = true;
 
     /**
-     * @brief Container of synapse parameters.
+     * @brief Container of synapse parameters, shared between projection copies until one of them modifies synapses.
      */
-    SynapsesContainer parameters_;
+    std::shared_ptr<SynapsesContainer> parameters_ = std::make_shared<SynapsesContainer>();
     // So far the index is mutable so we can reindex a const object that has a non-updated index.
     struct Connection
     {
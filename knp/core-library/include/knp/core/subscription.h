@@ -89,7 +89,11 @@ public:
      * 
      * @details If a sender is not associated with the subscription, the method doesn't do anything.
      */
-    size_t remove_sender(const UID &uid) { return senders_.erase(uid); }
+    size_t remove_sender(const UID &uid)
+    {
+        ++senders_revision_;
+        return senders_.erase(uid);
+    }
 
     /**
      * @brief Add a sender with the given UID to the subscription.
@@ -100,7 +104,11 @@ public:
      * 
      * @details If a sender is already associated with the subscription, the method doesn't do anything.
      */
-    size_t add_sender(const UID &uid) { return senders_.insert(uid).second; }
+    size_t add_sender(const UID &uid)
+    {
+        ++senders_revision_;
+        return senders_.insert(uid).second;
+    }
 
     /**
      * @brief Add several senders to the subscription.
@@ -112,6 +120,7 @@ public:
     size_t add_senders(const std::vector<UID> &senders)
     {
         size_t size_before = senders_.size();
+        ++senders_revision_;
         std::copy(senders.begin(), senders.end(), std::inserter(senders_, senders_.end()));
         return senders_.size() - size_before;
     }
@@ -125,6 +134,15 @@ public:
      */
     [[nodiscard]] bool has_sender(const UID &uid) const { return senders_.find(uid) != senders_.end(); }
 
+    /**
+     * @brief Get revision number of the sender set.
+     * 
+     * @details The number increases every time senders are added to or removed from the subscription.
+     * 
+     * @return revision number.
+     */
+    [[nodiscard]] size_t get_senders_revision() const { return senders_revision_; }
+
 public:
     /**
      * @brief Add a message to the subscription.
@@ -171,6 +189,12 @@ private:
      * @brief Set of sender UIDs.
      */
     std::unordered_set<knp::core::UID, knp::core::uid_hash> senders_;
+
+    /**
+     * @brief Revision number of the sender set.
+     */
+    size_t senders_revision_ = 0;
+
     /**
      * @brief Message storage.
      */
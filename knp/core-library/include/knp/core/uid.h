@@ -23,6 +23,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <sstream>
 #include <string>
@@ -149,12 +151,7 @@ struct UID
      * 
      * @return string representation of the UID.
      */
-    explicit operator ::std::string() const
-    {
-        std::stringstream ss;
-        ss << tag;
-        return ss.str();
-    }
+    explicit operator ::std::string() const { return ::boost::uuids::to_string(tag); }
 
     /**
      * @brief Check if UID is valid.
@@ -238,7 +235,15 @@ struct uid_hash
      * 
      * @return UID hash value.
      */
-    auto operator()(const UID &uid) const { return boost::hash<boost::uuids::uuid>()(uid.tag); }
+    size_t operator()(const UID &uid) const
+    {
+        // UID bytes are already random, so mixing two 64-bit halves is enough and cheaper than byte-wise hashing.
+        uint64_t low_half = 0;
+        uint64_t high_half = 0;
+        std::memcpy(&low_half, uid.tag.data, sizeof(low_half));
+        std::memcpy(&high_half, uid.tag.data + sizeof(low_half), sizeof(high_half));
+        return static_cast<size_t>(low_half ^ (high_half * 0x9e3779b97f4a7c15ULL));
+    }
 };
 
 }  // namespace knp::core
@@ -0,0 +1,117 @@
+/**
+ * @file uid_interner.h
+ * @brief Table of dense integer handles for UIDs.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/uid.h>
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * @brief Core library namespace.
+ */
+namespace knp::core
+{
+
+/**
+ * @brief Dense integer handle of an interned UID.
+ */
+using UIDHandle = uint32_t;
+
+
+/**
+ * @brief The UIDInterner class maps UIDs to dense integer handles.
+ * 
+ * @details Use the class to intern UIDs once when entities are registered, and then use handles as indexes in plain
+ * vectors instead of hashing UIDs. Handles are numbered from zero in the order of interning, they are valid only
+ * within the table that issued them.
+ */
+class UIDInterner
+{
+public:
+    /**
+     * @brief Value that means no handle.
+     */
+    static constexpr UIDHandle invalid_handle = std::numeric_limits<UIDHandle>::max();
+
+public:
+    /**
+     * @brief Get a handle of a UID, add the UID to the table if it was not interned before.
+     * 
+     * @param uid UID.
+     * 
+     * @return UID handle.
+     */
+    UIDHandle intern(const UID &uid)
+    {
+        const auto [iter, inserted] = handles_.try_emplace(uid, static_cast<UIDHandle>(uids_.size()));
+        if (inserted) uids_.push_back(uid);
+        return iter->second;
+    }
+
+    /**
+     * @brief Find a handle of an interned UID.
+     * 
+     * @param uid UID.
+     * 
+     * @return UID handle or `invalid_handle` if the UID was not interned.
+     */
+    [[nodiscard]] UIDHandle find(const UID &uid) const
+    {
+        const auto iter = handles_.find(uid);
+        return iter == handles_.end() ? invalid_handle : iter->second;
+    }
+
+    /**
+     * @brief Get UID by its handle.
+     * 
+     * @param handle UID handle.
+     * 
+     * @return UID.
+     */
+    [[nodiscard]] const UID &get_uid(UIDHandle handle) const { return uids_.at(handle); }
+
+    /**
+     * @brief Get number of interned UIDs.
+     * 
+     * @return number of UIDs. All handles are less than this value.
+     */
+    [[nodiscard]] size_t size() const { return uids_.size(); }
+
+    /**
+     * @brief Remove all UIDs from the table.
+     */
+    void clear()
+    {
+        handles_.clear();
+        uids_.clear();
+    }
+
+private:
+    std::unordered_map<UID, UIDHandle, uid_hash> handles_;
+    std::vector<UID> uids_;
+};
+
+}  // namespace knp::core
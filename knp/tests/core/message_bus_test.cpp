@@ -19,11 +19,27 @@
  * limitations under the License.
  */
 
+#if defined(__linux__)
+extern "C"
+{
+#    include <sys/wait.h>
+#    include <unistd.h>
+}
+#endif
+
 #include <knp/core/message_bus.h>
 #include <knp/core/messaging/messaging.h>
 
 #include <tests_common.h>
 
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
 
 namespace knp::testing
 {
@@ -65,6 +81,22 @@ TEST(MessageBusSuite, SubscribeUnsubscribe)  // cppcheck-suppress syntaxError
 }
 
 
+TEST(MessageBusSuite, SubscribeMovedFromEndpoint)
+{
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_cpu_bus();
+    auto endpoint{bus->create_endpoint()};
+    const knp::core::UID sender{true}, receiver{true};
+
+    auto moved_endpoint{std::move(endpoint)};
+    moved_endpoint.subscribe<knp::core::messaging::SpikeMessage>(receiver, {sender});
+
+    // Moved-from endpoint gets new sender set.
+    endpoint.subscribe<knp::core::messaging::SpikeMessage>(receiver, {sender});
+    EXPECT_TRUE(endpoint.unsubscribe<knp::core::messaging::SpikeMessage>(receiver));
+    EXPECT_TRUE(moved_endpoint.unsubscribe<knp::core::messaging::SpikeMessage>(receiver));
+}
+
+
 TEST(MessageBusSuite, CreateBusAndEndpointZMQ)
 {
     using SpikeMessage = knp::core::messaging::SpikeMessage;
@@ -178,4 +210,816 @@ TEST(MessageBusSuite, SynapticImpactMessageSendCPU)
     ASSERT_EQ(msgs[0].impacts_, msg.impacts_);
 }
 
+
+void test_send_messages_batch(const std::shared_ptr<knp::core::MessageBus> &bus)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+
+    auto ep1{bus->create_endpoint()};
+    const knp::core::UID sender1, sender2;
+
+    std::vector<knp::core::messaging::MessageVariant> messages;
+    messages.emplace_back(SpikeMessage{{sender1, 1}, {1, 2, 3}});
+    messages.emplace_back(SpikeMessage{{sender2, 1}, {4, 5}});
+    messages.emplace_back(SpikeMessage{{sender1, 2}, {6}});
+
+    auto &subscription = ep1.subscribe<SpikeMessage>(knp::core::UID(), {sender1, sender2});
+
+    ep1.send_messages(std::move(messages));
+    EXPECT_EQ(bus->route_messages(), 3);
+    ep1.receive_all_messages();
+
+    const auto &msgs = subscription.get_messages();
+
+    ASSERT_EQ(msgs.size(), 3);
+    EXPECT_EQ(msgs[0].header_.sender_uid_, sender1);
+    EXPECT_EQ(msgs[0].neuron_indexes_, knp::core::messaging::SpikeData({1, 2, 3}));
+    EXPECT_EQ(msgs[1].header_.sender_uid_, sender2);
+    EXPECT_EQ(msgs[2].header_.send_time_, 2);
+}
+
+
+TEST(MessageBusSuite, SendMessagesBatchCPU)
+{
+    test_send_messages_batch(knp::core::MessageBus::construct_cpu_bus());
+}
+
+
+TEST(MessageBusSuite, SendMessagesBatchSHM)
+{
+    test_send_messages_batch(knp::core::MessageBus::construct_shm_bus());
+}
+
+
+void test_route_to_subscribed_endpoints(const std::shared_ptr<knp::core::MessageBus> &bus)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+
+    auto sender_ep{bus->create_endpoint()};
+    auto ep1{bus->create_endpoint()};
+    auto ep2{bus->create_endpoint()};
+    const knp::core::UID sender1{true}, sender2{true}, receiver{true};
+
+    auto &subscription1 = ep1.subscribe<SpikeMessage>(receiver, {sender1});
+    auto &subscription2 = ep2.subscribe<SpikeMessage>(receiver, {sender1, sender2});
+
+    sender_ep.send_message(SpikeMessage{{sender1, 1}, {1}});
+    sender_ep.send_message(SpikeMessage{{sender2, 2}, {2}});
+    sender_ep.send_message(SpikeMessage{{sender1, 3}, {3}});
+    EXPECT_EQ(bus->route_messages(), 3);
+    ep1.receive_all_messages();
+    ep2.receive_all_messages();
+
+    // Messages are received in the order they were sent.
+    ASSERT_EQ(subscription1.get_messages().size(), 2);
+    EXPECT_EQ(subscription1.get_messages()[0].header_.send_time_, 1);
+    EXPECT_EQ(subscription1.get_messages()[1].header_.send_time_, 3);
+    ASSERT_EQ(subscription2.get_messages().size(), 3);
+    EXPECT_EQ(subscription2.get_messages()[1].header_.send_time_, 2);
+
+    // The endpoint doesn't receive messages after unsubscribing.
+    ep2.unsubscribe<SpikeMessage>(receiver);
+    sender_ep.send_message(SpikeMessage{{sender2, 4}, {2}});
+    EXPECT_EQ(bus->route_messages(), 1);
+    EXPECT_EQ(ep2.receive_all_messages(), 0);
+}
+
+
+TEST(MessageBusSuite, RouteToSubscribedEndpointsCPU)
+{
+    test_route_to_subscribed_endpoints(knp::core::MessageBus::construct_cpu_bus());
+}
+
+
+TEST(MessageBusSuite, RouteToSubscribedEndpointsSHM)
+{
+    test_route_to_subscribed_endpoints(knp::core::MessageBus::construct_shm_bus());
+}
+
+
+void test_receive_to_several_subscriptions(const std::shared_ptr<knp::core::MessageBus> &bus)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    using SynapticImpactMessage = knp::core::messaging::SynapticImpactMessage;
+
+    auto sender_ep{bus->create_endpoint()};
+    auto receiver_ep{bus->create_endpoint()};
+    const knp::core::UID sender{true}, receiver1{true}, receiver2{true};
+
+    auto &subscription1 = receiver_ep.subscribe<SpikeMessage>(receiver1, {sender});
+    auto &subscription2 = receiver_ep.subscribe<SpikeMessage>(receiver2, {sender});
+    auto &impact_subscription = receiver_ep.subscribe<SynapticImpactMessage>(receiver1, {sender});
+
+    sender_ep.send_message(SpikeMessage{{sender, 1}, {1, 2}});
+    sender_ep.send_message(SpikeMessage{{sender, 2}, {3}});
+    bus->route_messages();
+
+    EXPECT_EQ(receiver_ep.receive_all_messages(), 2);
+    ASSERT_EQ(subscription1.get_messages().size(), 2);
+    ASSERT_EQ(subscription2.get_messages().size(), 2);
+    EXPECT_EQ(subscription1.get_messages()[0].neuron_indexes_, subscription2.get_messages()[0].neuron_indexes_);
+    EXPECT_EQ(subscription2.get_messages()[1].header_.send_time_, 2);
+    EXPECT_TRUE(impact_subscription.get_messages().empty());
+}
+
+
+TEST(MessageBusSuite, ReceiveToSeveralSubscriptionsCPU)
+{
+    test_receive_to_several_subscriptions(knp::core::MessageBus::construct_cpu_bus());
+}
+
+
+TEST(MessageBusSuite, ReceiveToSeveralSubscriptionsSHM)
+{
+    test_receive_to_several_subscriptions(knp::core::MessageBus::construct_shm_bus());
+}
+
+
+TEST(MessageBusSuite, ReceiveMessageViewsCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    using SpikeMessageView = knp::core::messaging::SpikeMessageView;
+
+    auto bus = knp::core::MessageBus::construct_cpu_bus();
+    auto sender_ep{bus->create_endpoint()};
+    auto ep1{bus->create_endpoint()};
+    auto ep2{bus->create_endpoint()};
+    const knp::core::UID sender{true}, receiver{true};
+    ep1.subscribe<SpikeMessage>(receiver, {sender});
+    ep2.subscribe<SpikeMessage>(receiver, {sender});
+
+    sender_ep.send_message(SpikeMessage{{sender, 1}, {1, 2, 3}});
+    EXPECT_EQ(bus->route_messages(), 1);
+
+    // Views of both endpoints refer to the same routed message.
+    std::vector<const uint8_t *> buffers;
+    auto handler = [&buffers](const knp::core::messaging::MessageViewVariant &view_variant)
+    {
+        const auto &view = std::get<SpikeMessageView>(view_variant);
+        EXPECT_EQ(view.header_.send_time_, 1);
+        const knp::core::messaging::SpikeData indexes(view.begin(), view.end());
+        EXPECT_EQ(indexes, (knp::core::messaging::SpikeData{1, 2, 3}));
+        buffers.push_back(view.encoded_indexes_);
+    };
+    EXPECT_EQ(ep1.receive_all_message_views(handler), 1);
+    EXPECT_EQ(ep2.receive_all_message_views(handler), 1);
+    ASSERT_EQ(buffers.size(), 2);
+    EXPECT_EQ(buffers[0], buffers[1]);
+    EXPECT_EQ(ep1.receive_all_message_views(handler), 0);
+}
+
+
+void test_async_routing(const std::shared_ptr<knp::core::MessageBus> &bus)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+
+    auto ep1{bus->create_endpoint()};
+    auto ep2{bus->create_endpoint()};
+    const knp::core::UID sender;
+
+    auto &subscription = ep2.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+
+    bus->start_async_routing();
+    ASSERT_TRUE(bus->is_async_routing());
+
+    constexpr size_t steps_count = 100;
+    for (knp::core::Step step = 0; step < steps_count; ++step)
+    {
+        ep1.send_message(SpikeMessage{{sender, step}, {1, 2, 3}});
+        // Fence: all messages sent before the call are delivered after it.
+        bus->route_messages();
+        ep2.receive_all_messages();
+        ASSERT_EQ(subscription.get_messages().size(), step + 1);
+        EXPECT_EQ(subscription.get_messages().back().header_.send_time_, step);
+    }
+
+    bus->stop_async_routing();
+    EXPECT_FALSE(bus->is_async_routing());
+
+    // Synchronous routing works after the routing thread is stopped.
+    ep1.send_message(SpikeMessage{{sender, steps_count}, {1}});
+    EXPECT_EQ(bus->route_messages(), 1);
+}
+
+
+TEST(MessageBusSuite, AsyncRoutingCPU)
+{
+    test_async_routing(knp::core::MessageBus::construct_cpu_bus());
+}
+
+
+TEST(MessageBusSuite, AsyncRoutingSHM)
+{
+    test_async_routing(knp::core::MessageBus::construct_shm_bus());
+}
+
+
+void test_subscribe_during_async_routing(const std::shared_ptr<knp::core::MessageBus> &bus)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+
+    auto ep1{bus->create_endpoint()};
+    auto ep2{bus->create_endpoint()};
+    const knp::core::UID sender, receiver;
+
+    // Routing thread reads senders of the endpoint while the endpoint changes them.
+    bus->start_async_routing(std::chrono::microseconds(0));
+    for (knp::core::Step step = 0; step < 1000; ++step)
+    {
+        auto &subscription = ep2.subscribe<SpikeMessage>(receiver, {sender});
+        ep1.send_message(SpikeMessage{{sender, step}, {1}});
+        bus->route_messages();
+        ep2.receive_all_messages();
+        ASSERT_EQ(subscription.get_messages().size(), 1);
+        ep2.unsubscribe<SpikeMessage>(receiver);
+    }
+    bus->stop_async_routing();
+}
+
+
+TEST(MessageBusSuite, SubscribeDuringAsyncRoutingCPU)
+{
+    test_subscribe_during_async_routing(knp::core::MessageBus::construct_cpu_bus());
+}
+
+
+TEST(MessageBusSuite, SubscribeDuringAsyncRoutingSHM)
+{
+    test_subscribe_during_async_routing(knp::core::MessageBus::construct_shm_bus());
+}
+
+
+TEST(MessageBusSuite, BoundedInboxCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    using Policy = knp::core::InboxOverflowPolicy;
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto sender_ep{bus->create_endpoint()};
+    const knp::core::UID sender;
+
+    auto route_to_endpoint = [&bus, &sender_ep, &sender](const knp::core::InboxSettings &settings)
+    {
+        auto ep{bus->create_endpoint()};
+        ep.set_inbox_settings(settings);
+        auto &subscription = ep.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+
+        sender_ep.send_message(SpikeMessage{{sender, 0}, {1}});
+        sender_ep.send_message(SpikeMessage{{sender, 1}, {2}});
+        sender_ep.send_message(SpikeMessage{{sender, 1}, {3}});
+        bus->route_messages();
+        ep.receive_all_messages();
+
+        return std::make_pair(subscription.get_messages(), ep.get_inbox_overflow_counters());
+    };
+
+    auto [oldest_messages, oldest_counters] = route_to_endpoint({2, Policy::drop_oldest});
+    ASSERT_EQ(oldest_messages.size(), 2);
+    EXPECT_EQ(oldest_messages[0].neuron_indexes_, knp::core::messaging::SpikeData({2}));
+    EXPECT_EQ(oldest_counters.dropped_messages_, 1);
+
+    auto [newest_messages, newest_counters] = route_to_endpoint({2, Policy::drop_newest});
+    ASSERT_EQ(newest_messages.size(), 2);
+    EXPECT_EQ(newest_messages[1].neuron_indexes_, knp::core::messaging::SpikeData({2}));
+    EXPECT_EQ(newest_counters.dropped_messages_, 1);
+
+    auto [coalesced_messages, coalesced_counters] = route_to_endpoint({2, Policy::coalesce_spikes});
+    ASSERT_EQ(coalesced_messages.size(), 2);
+    EXPECT_EQ(coalesced_messages[1].neuron_indexes_, knp::core::messaging::SpikeData({2, 3}));
+    EXPECT_EQ(coalesced_counters.coalesced_messages_, 1);
+    EXPECT_EQ(coalesced_counters.dropped_messages_, 0);
+
+    // Nobody drains the inbox during synchronous routing, so routing can't wait for free space.
+    {
+        auto ep{bus->create_endpoint()};
+        ep.set_inbox_settings({2, Policy::block});
+        ep.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+        sender_ep.send_message(SpikeMessage{{sender, 0}, {1}});
+        EXPECT_THROW(bus->route_messages(), std::logic_error);
+    }
+    EXPECT_EQ(bus->route_messages(), 1);
+}
+
+
+TEST(MessageBusSuite, BlockingInboxCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto sender_ep{bus->create_endpoint()};
+    auto receiver_ep{bus->create_endpoint()};
+    const knp::core::UID sender;
+    receiver_ep.set_inbox_settings({2, knp::core::InboxOverflowPolicy::block, std::chrono::seconds(10)});
+    auto &subscription = receiver_ep.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+
+    constexpr size_t messages_count = 100;
+    for (knp::core::Step step = 0; step < messages_count; ++step)
+        sender_ep.send_message(SpikeMessage{{sender, step}, {1}});
+
+    // Routing thread waits while the inbox is full, so no messages are dropped.
+    bus->start_async_routing();
+    std::thread receiver(
+        [&receiver_ep, &subscription]
+        {
+            while (subscription.get_messages().size() < messages_count) receiver_ep.receive_all_messages();
+        });
+    EXPECT_EQ(bus->route_messages(), messages_count);
+    receiver.join();
+    bus->stop_async_routing();
+
+    const auto counters = receiver_ep.get_inbox_overflow_counters();
+    EXPECT_EQ(counters.dropped_messages_, 0);
+    EXPECT_GT(counters.blocked_deliveries_, 0);
+    EXPECT_EQ(subscription.get_messages().back().header_.send_time_, messages_count - 1);
+}
+
+
+TEST(MessageBusSuite, BlockingInboxTimeoutCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto sender_ep{bus->create_endpoint()};
+    auto receiver_ep{bus->create_endpoint()};
+    const knp::core::UID sender;
+    constexpr auto block_timeout = std::chrono::milliseconds(100);
+    receiver_ep.set_inbox_settings({2, knp::core::InboxOverflowPolicy::block, block_timeout});
+    receiver_ep.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+
+    constexpr size_t messages_count = 20;
+    for (knp::core::Step step = 0; step < messages_count; ++step)
+        sender_ep.send_message(SpikeMessage{{sender, step}, {1}});
+
+    // Nobody receives messages, so routing waits once and drops the rest of the messages without waiting.
+    bus->start_async_routing();
+    const auto start_time = std::chrono::steady_clock::now();
+    EXPECT_EQ(bus->route_messages(), messages_count);
+    EXPECT_LT(std::chrono::steady_clock::now() - start_time, block_timeout * 5);
+    bus->stop_async_routing();
+
+    EXPECT_EQ(receiver_ep.get_inbox_overflow_counters().dropped_messages_, messages_count - 2);
+    EXPECT_EQ(receiver_ep.receive_all_messages(), 2);
+}
+
+
+TEST(MessageBusSuite, BoundedInboxZMQ)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    using Policy = knp::core::InboxOverflowPolicy;
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_zmq_bus();
+
+    auto sender_ep{bus->create_endpoint()};
+    auto receiver_ep{bus->create_endpoint()};
+    const knp::core::UID sender;
+    receiver_ep.set_inbox_settings({2, Policy::drop_oldest});
+    auto &subscription = receiver_ep.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+
+    auto send_messages = [&bus, &sender_ep, &sender]()
+    {
+        sender_ep.send_message(SpikeMessage{{sender, 0}, {1}});
+        sender_ep.send_message(SpikeMessage{{sender, 1}, {2}});
+        sender_ep.send_message(SpikeMessage{{sender, 1}, {3}});
+        bus->route_messages();
+    };
+
+    // Limit is applied when messages are received one by one too.
+    send_messages();
+    while (receiver_ep.receive_message())
+    {
+    }
+    ASSERT_EQ(subscription.get_messages().size(), 2);
+    EXPECT_EQ(subscription.get_messages()[0].neuron_indexes_, knp::core::messaging::SpikeData({2}));
+    EXPECT_EQ(receiver_ep.get_inbox_overflow_counters().dropped_messages_, 1);
+    subscription.clear_messages();
+
+    receiver_ep.set_inbox_settings({2, Policy::coalesce_spikes});
+    send_messages();
+    EXPECT_EQ(receiver_ep.receive_all_messages(), 2);
+    ASSERT_EQ(subscription.get_messages().size(), 2);
+    EXPECT_EQ(subscription.get_messages()[1].neuron_indexes_, knp::core::messaging::SpikeData({2, 3}));
+    EXPECT_EQ(receiver_ep.get_inbox_overflow_counters().coalesced_messages_, 1);
+}
+
+
+TEST(MessageBusSuite, MetricsCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto ep1{bus->create_endpoint()};
+    auto ep2{bus->create_endpoint()};
+    const knp::core::UID sender1, sender2;
+
+    ep1.subscribe<SpikeMessage>(knp::core::UID(), {sender1, sender2});
+    ep2.subscribe<SpikeMessage>(knp::core::UID(), {sender1});
+
+    // Metrics are disabled by default.
+    ep1.send_message(SpikeMessage{{sender1, 1}, {1, 2, 3}});
+    bus->route_messages();
+    EXPECT_EQ(bus->get_metrics().routing_cycles_, 0);
+
+    bus->enable_metrics();
+    ep1.send_message(SpikeMessage{{sender1, 2}, {1, 2, 3}});
+    ep1.send_message(SpikeMessage{{sender2, 2}, {4}});
+    EXPECT_EQ(bus->route_messages(), 2);
+
+    const auto metrics = bus->get_metrics();
+    EXPECT_EQ(metrics.routing_cycles_, 1);
+    EXPECT_EQ(metrics.messages_routed_, 2);
+    EXPECT_EQ(metrics.deliveries_, 3);
+    EXPECT_DOUBLE_EQ(metrics.get_fan_out(), 1.5);
+    ASSERT_EQ(metrics.senders_.size(), 2);
+    EXPECT_EQ(metrics.senders_.at(sender1).messages_, 1);
+    EXPECT_GT(metrics.senders_.at(sender1).bytes_, metrics.senders_.at(sender2).bytes_);
+
+    // Endpoints haven't received messages yet, including the one routed before metrics were enabled.
+    ASSERT_EQ(metrics.endpoints_.size(), 2);
+    EXPECT_EQ(metrics.endpoints_[0].inbox_depth_, 3);
+    EXPECT_EQ(metrics.endpoints_[1].inbox_depth_, 2);
+
+    uint64_t histogram_total = 0;
+    for (auto bucket : metrics.routing_time_histogram_) histogram_total += bucket;
+    EXPECT_EQ(histogram_total, 1);
+
+    bus->reset_metrics();
+    EXPECT_EQ(bus->get_metrics().messages_routed_, 0);
+    EXPECT_TRUE(bus->get_metrics().senders_.empty());
+}
+
+
+TEST(MessageBusSuite, MetricsZMQ)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_zmq_bus();
+    bus->enable_metrics();
+
+    auto ep1{bus->create_endpoint()};
+    auto ep2{bus->create_endpoint()};
+    const knp::core::UID sender;
+
+    auto &subscription = ep1.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+
+    ep1.send_message(SpikeMessage{{sender, 1}, {1, 2, 3}});
+    ep1.send_message(SpikeMessage{{sender, 2}, {4}});
+    bus->route_messages();
+
+    auto metrics = bus->get_metrics();
+    EXPECT_EQ(metrics.messages_routed_, 2);
+    EXPECT_EQ(metrics.deliveries_, 4);
+    ASSERT_EQ(metrics.senders_.size(), 1);
+    EXPECT_EQ(metrics.senders_.at(sender).messages_, 2);
+    ASSERT_EQ(metrics.endpoints_.size(), 2);
+    EXPECT_EQ(metrics.endpoints_[0].inbox_depth_, 2);
+
+    ep1.receive_all_messages();
+    EXPECT_EQ(subscription.get_messages().size(), 2);
+    bus->route_messages();
+
+    metrics = bus->get_metrics();
+    EXPECT_EQ(metrics.endpoints_[0].inbox_depth_, 0);
+    EXPECT_EQ(metrics.endpoints_[0].max_inbox_depth_, 2);
+}
+
+
+TEST(MessageBusSuite, BatchedMessagesZMQ)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+
+    knp::core::ZMQBusSettings unbatched_settings;
+    unbatched_settings.max_batch_size_ = 0;
+
+    // Default batching and one message per frame.
+    for (auto bus :
+         {knp::core::MessageBus::construct_zmq_bus(), knp::core::MessageBus::construct_zmq_bus(unbatched_settings)})
+    {
+        auto ep1{bus->create_endpoint()};
+        auto ep2{bus->create_endpoint()};
+        const knp::core::UID sender{true};
+        auto &subscription = ep2.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+
+        constexpr size_t messages_count = 100;
+        for (size_t i = 0; i < messages_count; ++i)
+        {
+            ep1.send_message(SpikeMessage{{sender, i}, {static_cast<uint32_t>(i)}});
+        }
+        bus->route_messages();
+
+        EXPECT_EQ(ep2.receive_all_messages(), messages_count);
+        const auto &msgs = subscription.get_messages();
+        ASSERT_EQ(msgs.size(), messages_count);
+        for (size_t i = 0; i < messages_count; ++i) EXPECT_EQ(msgs[i].header_.send_time_, i);
+    }
+}
+
+
+// Run with `--gtest_also_run_disabled_tests` to compare batched and unbatched message routing.
+TEST(MessageBusSuite, DISABLED_BatchingBenchmarkZMQ)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    constexpr size_t steps_count = 100;
+    constexpr size_t messages_per_step = 2000;
+
+    for (size_t max_batch_size : {size_t{0}, size_t{1024 * 1024}})
+    {
+        knp::core::ZMQBusSettings settings;
+        settings.max_batch_size_ = max_batch_size;
+        auto bus = knp::core::MessageBus::construct_zmq_bus(settings);
+        auto ep1{bus->create_endpoint()};
+        auto ep2{bus->create_endpoint()};
+        const knp::core::UID sender{true};
+        ep2.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t step = 0; step < steps_count; ++step)
+        {
+            for (size_t i = 0; i < messages_per_step; ++i) ep1.send_message(SpikeMessage{{sender, step}, {1, 2, 3}});
+            bus->route_messages();
+            ep2.receive_all_messages();
+            ep2.unload_messages<SpikeMessage>(knp::core::UID());
+        }
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Max batch size: " << max_batch_size << " bytes, "
+                  << steps_count * messages_per_step / duration.count() << " messages/s, "
+                  << duration.count() * 1000 / steps_count << " ms per step." << std::endl;
+    }
+}
+
+
+#if defined(__linux__)
+TEST(MessageBusSuite, MultiprocessBusZMQ)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    constexpr size_t rounds_count = 5;
+
+    // Buses of different processes are emulated by buses with separate ZMQ contexts.
+    knp::core::ZMQBusSettings router_settings;
+    router_settings.address_ = "ipc:///tmp/knp_bus_test_" + std::string(knp::core::UID());
+    router_settings.processes_count_ = 2;
+    router_settings.timeout_ = std::chrono::seconds(10);
+
+    knp::core::ZMQBusSettings client_settings = router_settings;
+    client_settings.is_router_ = false;
+
+    const knp::core::UID router_sender;
+    const knp::core::UID client_sender;
+
+    // Each process sends a spike every round and receives spikes of the other process.
+    auto run_process = [](
+                           const knp::core::ZMQBusSettings &settings, const knp::core::UID &sender,
+                           const knp::core::UID &other_sender)
+    {
+        auto bus = knp::core::MessageBus::construct_zmq_bus(settings);
+        auto endpoint{bus->create_endpoint()};
+        auto &subscription = endpoint.subscribe<SpikeMessage>(knp::core::UID(), {other_sender});
+
+        std::vector<size_t> received_steps;
+        for (size_t round = 0; round < rounds_count; ++round)
+        {
+            endpoint.send_message(SpikeMessage{{sender, round}, {static_cast<uint32_t>(round)}});
+            bus->route_messages();
+            endpoint.receive_all_messages();
+            for (const auto &message : subscription.get_messages())
+            {
+                received_steps.push_back(message.header_.send_time_);
+            }
+            subscription.clear_messages();
+        }
+        return received_steps;
+    };
+
+    auto router_result = std::async(std::launch::async, run_process, router_settings, router_sender, client_sender);
+    auto client_result = std::async(std::launch::async, run_process, client_settings, client_sender, router_sender);
+
+    const std::vector<size_t> expected_steps{0, 1, 2, 3, 4};
+    EXPECT_EQ(router_result.get(), expected_steps);
+    EXPECT_EQ(client_result.get(), expected_steps);
+}
+#endif
+
+
+TEST(MessageBusSuite, CreateBusAndEndpointSHM)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_shm_bus();
+
+    auto ep1{bus->create_endpoint()};
+    auto ep2{bus->create_endpoint()};
+
+    SpikeMessage msg{{knp::core::UID{}}, {1, 2, 3, 4, 5}};
+
+    auto &subscription = ep2.subscribe<SpikeMessage>(knp::core::UID(), {msg.header_.sender_uid_});
+
+    ep1.send_message(msg);
+    EXPECT_EQ(bus->route_messages(), 1);
+    ep2.receive_all_messages();
+
+    const auto &msgs = subscription.get_messages();
+
+    EXPECT_EQ(msgs.size(), 1);
+    EXPECT_EQ(msgs[0].header_.sender_uid_, msg.header_.sender_uid_);
+    EXPECT_EQ(msgs[0].neuron_indexes_, msg.neuron_indexes_);
+}
+
+
+TEST(MessageBusSuite, SynapticImpactMessageSendSHM)
+{
+    using SynapticImpactMessage = knp::core::messaging::SynapticImpactMessage;
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_shm_bus();
+
+    auto ep1{bus->create_endpoint()};
+    knp::synapse_traits::OutputType synapse_type = knp::synapse_traits::OutputType::EXCITATORY;
+    SynapticImpactMessage msg{
+        {knp::core::UID{}},
+        knp::core::UID{},
+        knp::core::UID{},
+        true,
+        {{1, 2, synapse_type, 3, 4}, {4, 3, synapse_type, 2, 1}, {7, 8, synapse_type, 9, 10}}};
+
+    auto &subscription = ep1.subscribe<SynapticImpactMessage>(knp::core::UID(), {msg.header_.sender_uid_});
+
+    ep1.send_message(msg);
+    EXPECT_EQ(bus->route_messages(), 1);
+    ep1.receive_all_messages();
+
+    const auto &msgs = subscription.get_messages();
+
+    EXPECT_EQ(msgs.size(), 1);
+    EXPECT_EQ(msgs[0].header_.sender_uid_, msg.header_.sender_uid_);
+    ASSERT_EQ(msgs[0].presynaptic_population_uid_, msg.presynaptic_population_uid_);
+    ASSERT_EQ(msgs[0].postsynaptic_population_uid_, msg.postsynaptic_population_uid_);
+    ASSERT_EQ(msgs[0].is_forcing_, msg.is_forcing_);
+    ASSERT_EQ(msgs[0].impacts_, msg.impacts_);
+}
+
+
+TEST(MessageBusSuite, SharedSegmentSHM)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+
+    // Buses of different processes are emulated by buses that open the same segment.
+    knp::core::SHMBusSettings settings;
+    settings.name_ = "knp_bus_test_" + std::string(knp::core::UID());
+    // Small rings are reused many times during the test.
+    settings.ring_size_ = 4096;
+
+    auto bus1 = knp::core::MessageBus::construct_shm_bus(settings);
+    auto bus2 = knp::core::MessageBus::construct_shm_bus(settings);
+    auto ep1{bus1->create_endpoint()};
+    auto ep2{bus2->create_endpoint()};
+    const knp::core::UID sender1, sender2;
+    auto &subscription1 = ep1.subscribe<SpikeMessage>(knp::core::UID(), {sender2});
+    auto &subscription2 = ep2.subscribe<SpikeMessage>(knp::core::UID(), {sender1});
+    // Subscriptions take effect when the bus of the subscriber routes messages.
+    EXPECT_EQ(bus1->route_messages(), 0);
+    EXPECT_EQ(bus2->route_messages(), 0);
+
+    for (size_t step = 0; step < 1000; ++step)
+    {
+        ep1.send_message(SpikeMessage{{sender1, step}, {1, 2, 3}});
+        ep2.send_message(SpikeMessage{{sender2, step}, {4, 5}});
+        // Message is visible only after the bus of its sender routes messages.
+        EXPECT_EQ(bus1->route_messages(), 1);
+        ep2.receive_all_messages();
+        EXPECT_EQ(bus2->route_messages(), 1);
+        ep1.receive_all_messages();
+
+        ASSERT_EQ(subscription1.get_messages().size(), 1);
+        ASSERT_EQ(subscription2.get_messages().size(), 1);
+        EXPECT_EQ(subscription1.get_messages()[0].header_.send_time_, step);
+        EXPECT_EQ(subscription2.get_messages()[0].neuron_indexes_, (std::vector<uint32_t>{1, 2, 3}));
+        subscription1.clear_messages();
+        subscription2.clear_messages();
+    }
+}
+
+
+#if defined(__linux__)
+TEST(MessageBusSuite, SeparateProcessesSHM)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    constexpr knp::core::Step steps_count = 100;
+
+    knp::core::SHMBusSettings settings;
+    settings.name_ = "knp_bus_test_" + std::string(knp::core::UID());
+    settings.ring_size_ = 4096;
+    const knp::core::UID parent_sender, child_sender, other_sender;
+
+    // Wait until the endpoint receives a message of the given step.
+    auto wait_for_step = [](knp::core::MessageEndpoint &endpoint, knp::core::Subscription<SpikeMessage> &subscription,
+                            knp::core::Step step)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (subscription.get_messages().empty() && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            endpoint.receive_all_messages();
+        }
+        const bool is_received =
+            subscription.get_messages().size() == 1 && subscription.get_messages()[0].header_.send_time_ == step;
+        subscription.clear_messages();
+        return is_received;
+    };
+
+    // The parent bus creates the segment and starts reading before the child process sends messages.
+    auto bus = knp::core::MessageBus::construct_shm_bus(settings);
+    auto endpoint{bus->create_endpoint()};
+    auto &subscription = endpoint.subscribe<SpikeMessage>(knp::core::UID(), {child_sender});
+    bus->route_messages();
+
+    const pid_t child_pid = fork();
+    ASSERT_NE(child_pid, -1);
+    if (0 == child_pid)
+    {
+        // The child process doesn't destroy objects copied from the parent process.
+        int exit_code = EXIT_FAILURE;
+        try
+        {
+            auto child_bus = knp::core::MessageBus::construct_shm_bus(settings);
+            auto child_endpoint{child_bus->create_endpoint()};
+            auto &child_subscription = child_endpoint.subscribe<SpikeMessage>(knp::core::UID(), {parent_sender});
+            bool is_ok = true;
+            for (knp::core::Step step = 0; is_ok && step < steps_count; ++step)
+            {
+                // Messages of other senders are skipped by the parent endpoint.
+                child_endpoint.send_message(SpikeMessage{{other_sender, step}, {0}});
+                child_endpoint.send_message(SpikeMessage{{child_sender, step}, {static_cast<uint32_t>(step)}});
+                child_bus->route_messages();
+                is_ok = wait_for_step(child_endpoint, child_subscription, step);
+            }
+            if (is_ok) exit_code = EXIT_SUCCESS;
+        }
+        catch (...)
+        {
+        }
+        _exit(exit_code);
+    }
+
+    for (knp::core::Step step = 0; step < steps_count; ++step)
+    {
+        ASSERT_TRUE(wait_for_step(endpoint, subscription, step));
+        endpoint.send_message(SpikeMessage{{parent_sender, step}, {static_cast<uint32_t>(step)}});
+        bus->route_messages();
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(child_pid, &status, 0), child_pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), EXIT_SUCCESS);
+}
+#endif
+
+
+TEST(MessageBusSuite, SendOnlyEndpointSHM)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+
+    knp::core::SHMBusSettings settings;
+    // Messages sent during the test take many rings.
+    settings.ring_size_ = 4096;
+    settings.timeout_ = std::chrono::milliseconds(100);
+    auto bus = knp::core::MessageBus::construct_shm_bus(settings);
+
+    // Endpoints without subscriptions, such as input channel endpoints, don't hold ring space.
+    auto sender_ep{bus->create_endpoint()};
+    auto idle_ep{bus->create_endpoint()};
+    auto receiver_ep{bus->create_endpoint()};
+    const knp::core::UID sender;
+    auto &subscription = receiver_ep.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+
+    auto send_step = [&](knp::core::Step step)
+    {
+        sender_ep.send_message(SpikeMessage{{sender, step}, {1, 2, 3, 4, 5, 6, 7, 8}});
+        EXPECT_EQ(bus->route_messages(), 1);
+        receiver_ep.receive_all_messages();
+    };
+
+    constexpr knp::core::Step steps_count = 1000;
+    for (knp::core::Step step = 0; step < steps_count; ++step)
+    {
+        send_step(step);
+        ASSERT_EQ(subscription.get_messages().size(), 1);
+        EXPECT_EQ(subscription.get_messages()[0].header_.send_time_, step);
+        subscription.clear_messages();
+    }
+
+    // Messages of one step must fit the ring, because readers get them after routing.
+    EXPECT_THROW(
+        {
+            for (knp::core::Step step = 0; step < steps_count; ++step)
+                sender_ep.send_message(SpikeMessage{{sender, step}, {1}});
+        },
+        std::length_error);
+    bus->route_messages();
+    receiver_ep.receive_all_messages();
+
+    // Subscribed endpoint that doesn't receive messages holds ring space, so the sender stops waiting after timeout.
+    idle_ep.subscribe<SpikeMessage>(knp::core::UID(), {sender});
+    EXPECT_THROW(
+        {
+            for (knp::core::Step step = 0; step < steps_count; ++step) send_step(step);
+        },
+        std::runtime_error);
+}
+
 }  // namespace knp::testing
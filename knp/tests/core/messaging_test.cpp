@@ -19,12 +19,15 @@
  * limitations under the License.
  */
 
+#include <knp/core/messaging/message_view.h>
 #include <knp/core/messaging/messaging.h>
 #include <knp/core/subscription.h>
 
 #include <tests_common.h>
 
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 
 
 namespace knp::tesing
@@ -100,4 +103,89 @@ TEST(MessageSuite, HeaderIOTest)
     ASSERT_EQ(header_in.send_time_, header_out.send_time_);
 }
 
+
+TEST(MessageSuite, EnvelopeViewTest)
+{
+    const knp::core::UID uid{true}, pre_uid{true}, post_uid{true};
+    const knp::synapse_traits::OutputType type = knp::synapse_traits::OutputType::EXCITATORY;
+    const knp::core::messaging::SpikeMessage spike_message{{uid, 3}, {1, 2, 3}};
+    const knp::core::messaging::SynapticImpactMessage impact_message{
+        {uid, 4}, pre_uid, post_uid, false, {{1, 2, type, 3, 4}, {5, 6, type, 7, 8}}};
+
+    // Views of packed messages and views of messages must be the same.
+    for (const auto &message : std::vector<knp::core::messaging::MessageVariant>{spike_message, impact_message})
+    {
+        const auto packed_message = knp::core::messaging::pack_to_envelope(message);
+        for (const auto &view :
+             {knp::core::messaging::view_envelope(packed_message.data()),
+              knp::core::messaging::make_message_view(message)})
+        {
+            ASSERT_EQ(view.index(), message.index());
+            if (const auto *spike_view = std::get_if<knp::core::messaging::SpikeMessageView>(&view))
+            {
+                ASSERT_EQ(spike_view->header_.sender_uid_, uid);
+                ASSERT_EQ(spike_view->header_.send_time_, 3);
+                ASSERT_EQ(
+                    knp::core::messaging::SpikeData(spike_view->begin(), spike_view->end()),
+                    spike_message.neuron_indexes_);
+                continue;
+            }
+            const auto &impact_view = std::get<knp::core::messaging::SynapticImpactMessageView>(view);
+            ASSERT_EQ(impact_view.presynaptic_population_uid_, pre_uid);
+            ASSERT_EQ(impact_view.postsynaptic_population_uid_, post_uid);
+            ASSERT_EQ(impact_view.size(), impact_message.impacts_.size());
+            ASSERT_EQ(impact_view.get_impact(1), impact_message.impacts_[1]);
+        }
+    }
+}
+
+
+TEST(MessageSuite, CompactSpikeDataTest)
+{
+    using knp::core::messaging::CompactSpikeData;
+    using knp::core::messaging::SpikeData;
+    using knp::core::messaging::SpikeEncoding;
+
+    SpikeData dense_spikes;
+    for (knp::core::messaging::SpikeIndex index = 1000; index < 2000; index += 2) dense_spikes.push_back(index);
+    SpikeData sparse_spikes;
+    for (knp::core::messaging::SpikeIndex index = 0; index < 100000; index += 97) sparse_spikes.push_back(index);
+    const SpikeData unsorted_spikes{70000, 3, 3, 100, 1};
+
+    // Encoding is chosen by density.
+    EXPECT_EQ(CompactSpikeData(dense_spikes).get_encoding(), SpikeEncoding::bitmap);
+    EXPECT_EQ(CompactSpikeData(sparse_spikes).get_encoding(), SpikeEncoding::delta_varint);
+    EXPECT_LT(CompactSpikeData(sparse_spikes).get_data().size(), sparse_spikes.size() * 2);
+    EXPECT_EQ(CompactSpikeData(SpikeData{}).get_encoding(), SpikeEncoding::raw);
+    EXPECT_THROW(CompactSpikeData(unsorted_spikes, SpikeEncoding::bitmap), std::invalid_argument);
+
+    for (const auto &spikes : {dense_spikes, sparse_spikes, unsorted_spikes, SpikeData{}})
+    {
+        EXPECT_EQ(CompactSpikeData(spikes).decode(), spikes);
+        EXPECT_EQ(CompactSpikeData(spikes, SpikeEncoding::raw).decode(), spikes);
+        EXPECT_EQ(CompactSpikeData(spikes, SpikeEncoding::delta_varint).decode(), spikes);
+
+        // Encoded indexes are packed to envelopes and are viewed without unpacking.
+        const knp::core::messaging::SpikeMessage message{{knp::core::UID{}, 1}, spikes};
+        const auto packed_message = knp::core::messaging::pack_to_envelope(message);
+        EXPECT_EQ(
+            std::get<knp::core::messaging::SpikeMessage>(knp::core::messaging::extract_from_envelope(packed_message)),
+            message);
+        const auto view = std::get<knp::core::messaging::SpikeMessageView>(
+            knp::core::messaging::view_envelope(packed_message.data()));
+        EXPECT_EQ(SpikeData(view.begin(), view.end()), spikes);
+    }
+
+    // Damaged data is not read past its end.
+    const CompactSpikeData sparse_data(sparse_spikes);
+    std::vector<uint8_t> truncated_data(sparse_data.get_data().begin(), sparse_data.get_data().end() - 1);
+    EXPECT_THROW(
+        CompactSpikeData(SpikeEncoding::delta_varint, truncated_data, sparse_spikes.size()).decode(),
+        std::runtime_error);
+    EXPECT_THROW(
+        CompactSpikeData(SpikeEncoding::delta_varint, std::vector<uint8_t>(11, 0xff), 1).decode(), std::runtime_error);
+    EXPECT_THROW(CompactSpikeData(SpikeEncoding::bitmap, {1, 0}, 2).decode(), std::runtime_error);
+    EXPECT_THROW(CompactSpikeData(SpikeEncoding::raw, {1, 0, 0}, 1).decode(), std::runtime_error);
+}
+
 }  // namespace knp::tesing
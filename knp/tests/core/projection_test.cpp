@@ -26,6 +26,7 @@
 
 #include <cstdlib>
 #include <optional>
+#include <utility>
 
 
 namespace knp::testing
@@ -273,4 +274,41 @@ TEST(ProjectionSuite, GetUIDTest)
     ASSERT_EQ(projection.get_postsynaptic(), uid_to);
 }
 
+
+TEST(ProjectionSuite, SharedSynapsesCopyOnWrite)
+{
+    auto generator = make_dense_generator({10, 10}, {1, 1, knp::synapse_traits::OutputType::EXCITATORY});
+    DeltaProjection projection(knc::UID{}, knc::UID{}, generator, 100);
+    ASSERT_FALSE(projection.has_shared_synapses());
+
+    // Read-only access to a copy doesn't copy synapses.
+    const DeltaProjection replica = projection;
+    ASSERT_TRUE(projection.has_shared_synapses());
+    ASSERT_EQ(&replica.get_synapses(), &projection.get_synapses());
+    ASSERT_EQ(replica.find_synapses(0, DeltaProjection::Search::by_presynaptic).size(), 10);
+    ASSERT_TRUE(replica.has_shared_synapses());
+
+    // Modification detaches the modified projection.
+    std::get<knp::core::synapse_data>(projection[5]).weight_ = 2;
+    ASSERT_FALSE(projection.has_shared_synapses());
+    ASSERT_FALSE(replica.has_shared_synapses());
+    ASSERT_EQ(std::get<knp::core::synapse_data>(replica[5]).weight_, 1);
+    ASSERT_EQ(std::get<knp::core::synapse_data>(projection[5]).weight_, 2);
+
+    DeltaProjection other_replica = projection;
+    ASSERT_EQ(other_replica.remove_postsynaptic_neuron_synapses(0), 10);
+    ASSERT_EQ(other_replica.size(), 90);
+    ASSERT_EQ(projection.size(), 100);
+
+    // Moved-from projection stays valid and empty.
+    DeltaProjection moved_projection = std::move(other_replica);
+    ASSERT_EQ(moved_projection.size(), 90);
+    ASSERT_EQ(other_replica.size(), 0);  // NOLINT
+    ASSERT_EQ(other_replica.begin(), other_replica.end());
+    ASSERT_TRUE(other_replica.find_synapses(0, DeltaProjection::Search::by_presynaptic).empty());
+    other_replica = std::move(moved_projection);
+    ASSERT_EQ(other_replica.size(), 90);
+    ASSERT_EQ(moved_projection.get_synapses().size(), 0);  // NOLINT
+}
+
 }  // namespace knp::testing
@@ -20,6 +20,7 @@
  */
 
 #include <knp/core/uid.h>
+#include <knp/core/uid_interner.h>
 
 #include <tests_common.h>
 
@@ -91,4 +92,26 @@ TEST(UidSuite, UidHash)
     ASSERT_EQ(uid_container[uid1], uid1);
 }
 
+TEST(UidSuite, UidInterner)
+{
+    ::knp::core::UID uid1{::boost::uuids::uuid{{1, 2, 3}}};
+    ::knp::core::UID uid2{::boost::uuids::uuid{{3, 2, 1}}};
+
+    ::knp::core::UIDInterner interner;
+
+    ASSERT_EQ(interner.find(uid1), ::knp::core::UIDInterner::invalid_handle);
+
+    const auto handle1 = interner.intern(uid1);
+    const auto handle2 = interner.intern(uid2);
+
+    ASSERT_NE(handle1, handle2);
+    ASSERT_EQ(interner.intern(uid1), handle1);
+    ASSERT_EQ(interner.find(uid2), handle2);
+    ASSERT_EQ(interner.get_uid(handle1), uid1);
+    ASSERT_EQ(interner.size(), 2);
+
+    interner.clear();
+    ASSERT_EQ(interner.find(uid1), ::knp::core::UIDInterner::invalid_handle);
+}
+
 }  // namespace knp::testing
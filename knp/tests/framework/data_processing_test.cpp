@@ -33,7 +33,11 @@ TEST(DataProcessing, ImageClassification)
     dataset.process_labels_and_images(
         images_stream, labels_stream, training_amount + inference_amount, classes_amount, image_size, steps_per_image,
         [](std::vector<uint8_t> const&) -> knp::framework::data_processing::classification::Dataset::Frame
-        { return {{true}}; });
+        {
+            knp::framework::data_processing::classification::Dataset::Frame frame;
+            frame.add_step({0});
+            return frame;
+        });
     dataset.split(training_amount, inference_amount);
 
     ASSERT_EQ(dataset.get_image_size(), image_size);
@@ -45,17 +49,17 @@ TEST(DataProcessing, ImageClassification)
     auto [training_begin, training_end] = dataset.get_data_for_training();
     ASSERT_EQ(std::distance(training_begin, training_end), training_amount);
     ASSERT_EQ(training_begin[0].first, 0);
-    ASSERT_EQ(training_begin[0].second.spikes_.size(), 1);
-    ASSERT_EQ(training_begin[0].second.spikes_[0], true);
+    ASSERT_EQ(training_begin[0].second.get_steps_count(), 1);
+    ASSERT_EQ(training_begin[0].second.get_spikes(0), knp::core::messaging::SpikeData{0});
     ASSERT_EQ(training_begin[1].first, 1);
-    ASSERT_EQ(training_begin[1].second.spikes_.size(), 1);
-    ASSERT_EQ(training_begin[1].second.spikes_[0], true);
+    ASSERT_EQ(training_begin[1].second.get_steps_count(), 1);
+    ASSERT_EQ(training_begin[1].second.get_spikes(0), knp::core::messaging::SpikeData{0});
 
     auto [inference_begin, inference_end] = dataset.get_data_for_inference();
     ASSERT_EQ(std::distance(inference_begin, inference_end), inference_amount);
     ASSERT_EQ(inference_begin[0].first, 2);
-    ASSERT_EQ(inference_begin[0].second.spikes_.size(), 1);
-    ASSERT_EQ(inference_begin[0].second.spikes_[0], true);
+    ASSERT_EQ(inference_begin[0].second.get_steps_count(), 1);
+    ASSERT_EQ(inference_begin[0].second.get_spikes(0), knp::core::messaging::SpikeData{0});
 
     auto train_images_spikes_gen = dataset.make_training_images_spikes_generator();
     for (size_t i = 0; i < dataset.get_steps_amount_for_training(); ++i)
@@ -81,3 +85,74 @@ TEST(DataProcessing, ImageClassification)
         ASSERT_EQ(res[0], 0);
     }
 }
+
+
+TEST(DataProcessing, IncrementingImageConverter)
+{
+    constexpr size_t images_amount = 2, classes_amount = 2, image_size = 2, steps_per_image = 3, active_steps = 2;
+    std::stringstream images_stream(std::string("\x02\x00\x01\x04", 4));
+    std::stringstream labels_stream("0\n1\n");
+    knp::framework::data_processing::classification::images::Dataset dataset;
+    dataset.process_labels_and_images(
+        images_stream, labels_stream, images_amount, classes_amount, image_size, steps_per_image,
+        dataset.make_incrementing_image_to_spikes_converter(active_steps, 0.5F));
+    dataset.split(images_amount, 0);
+
+    auto [training_begin, training_end] = dataset.get_data_for_training();
+    ASSERT_EQ(std::distance(training_begin, training_end), images_amount);
+
+    // Inactive steps are not stored.
+    const auto &first_frame = training_begin[0].second;
+    ASSERT_EQ(first_frame.get_steps_count(), active_steps);
+    ASSERT_EQ(first_frame.indexes_.size(), 2);
+
+    // Fractional state of an input is accumulated over steps.
+    const auto &second_frame = training_begin[1].second;
+    ASSERT_EQ(second_frame.get_spikes(0), (knp::core::messaging::SpikeData{1}));
+    ASSERT_EQ(second_frame.get_spikes(1), (knp::core::messaging::SpikeData{0, 1}));
+
+    const std::vector<knp::core::messaging::SpikeData> expected_spikes = {{0}, {0}, {}, {1}, {0, 1}, {}};
+    auto images_spikes_gen = dataset.make_training_images_spikes_generator();
+    for (size_t step = 0; step < dataset.get_steps_amount_for_training(); ++step)
+    {
+        ASSERT_EQ(images_spikes_gen(step), expected_spikes[step]);
+    }
+}
+
+
+TEST(DataProcessing, ParallelImageProcessing)
+{
+    constexpr size_t images_amount = 7, classes_amount = 3, image_size = 5, steps_per_image = 4, active_steps = 3;
+    std::string images, labels;
+    for (size_t i = 0; i < images_amount; ++i)
+    {
+        for (size_t j = 0; j < image_size; ++j) images.push_back(static_cast<char>((i * 37 + j * 101) % 256));
+        labels += std::to_string(i % classes_amount) + "\n";
+    }
+
+    auto process = [&](size_t threads_count)
+    {
+        std::stringstream images_stream(images), labels_stream(labels);
+        knp::framework::data_processing::classification::images::Dataset dataset;
+        dataset.process_labels_and_images(
+            images_stream, labels_stream, images_amount, classes_amount, image_size, steps_per_image,
+            dataset.make_independent_incrementing_image_to_spikes_converter(active_steps, 0.01F, 0.5F), threads_count);
+        dataset.split(images_amount, 0);
+        return dataset;
+    };
+
+    const auto sequential_dataset = process(1);
+    const auto parallel_dataset = process(3);
+    auto [sequential_begin, sequential_end] = sequential_dataset.get_data_for_training();
+    auto [parallel_begin, parallel_end] = parallel_dataset.get_data_for_training();
+    ASSERT_EQ(std::distance(sequential_begin, sequential_end), images_amount);
+    ASSERT_EQ(std::distance(parallel_begin, parallel_end), images_amount);
+
+    for (size_t i = 0; i < images_amount; ++i)
+    {
+        ASSERT_EQ(parallel_begin[i].first, i % classes_amount);
+        ASSERT_EQ(parallel_begin[i].first, sequential_begin[i].first);
+        ASSERT_EQ(parallel_begin[i].second.indexes_, sequential_begin[i].second.indexes_);
+        ASSERT_EQ(parallel_begin[i].second.step_ends_, sequential_begin[i].second.step_ends_);
+    }
+}
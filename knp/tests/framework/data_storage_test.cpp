@@ -22,6 +22,7 @@
 #include <knp/core/messaging/messaging.h>
 #include <knp/framework/io/storage/native/data_storage_hdf5.h>
 #include <knp/framework/io/storage/native/data_storage_json.h>
+#include <knp/framework/io/storage/native/data_storage_raster.h>
 
 #ifdef __clang__
 #    pragma clang diagnostic push
@@ -34,7 +35,13 @@
 
 #include <tests_common.h>
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
 #include <random>
 #include <vector>
 
@@ -90,6 +97,209 @@ TEST_F(SaveLoadDataSuite, Hdf5Test)
 }
 
 
+TEST_F(SaveLoadDataSuite, Hdf5StreamingTest)
+{
+    file_path_ = "data.h5";
+    {
+        // Small buffer and chunk sizes make the writer and the reader cross several flushes and chunks.
+        knp::framework::io::storage::native::H5SpikeMessageWriter writer(file_path_, 1.0f, 16);
+        for (const auto &message : messages_) writer.write(message);
+    }
+    ASSERT_EQ(messages_, knp::framework::io::storage::native::load_messages_from_h5(file_path_, uid_));
+
+    knp::framework::io::storage::native::H5SpikeMessageReader reader(file_path_, uid_, 1.0f, true, 7);
+    const std::vector<knp::core::messaging::SpikeMessage> loaded_messages(reader.begin(), reader.end());
+    ASSERT_EQ(messages_, loaded_messages);
+
+    std::vector<knp::core::messaging::SpikeMessage> range_messages;
+    std::copy_if(
+        messages_.begin(), messages_.end(), std::back_inserter(range_messages),
+        [](const auto &message) { return message.header_.send_time_ >= 50 && message.header_.send_time_ < 100; });
+    ASSERT_EQ(range_messages, reader.read_steps(50, 100));
+
+    // Reading continues from the end of the range.
+    const auto next_message = std::find_if(
+        messages_.begin(), messages_.end(), [](const auto &message) { return message.header_.send_time_ >= 100; });
+    ASSERT_EQ(*next_message, reader.read().value());
+}
+
+
+TEST_F(SaveLoadDataSuite, JsonStreamingTest)
+{
+    file_path_ = "data.json";
+    {
+        knp::framework::io::storage::native::JsonSpikeMessageWriter writer(file_path_);
+        for (const auto &message : messages_) writer.write(message);
+    }
+    ASSERT_EQ(messages_, knp::framework::io::storage::native::load_messages_from_json(file_path_, uid_));
+
+    knp::framework::io::storage::native::JsonSpikeMessageReader reader(file_path_, uid_);
+    const std::vector<knp::core::messaging::SpikeMessage> loaded_messages(reader.begin(), reader.end());
+    ASSERT_EQ(messages_, loaded_messages);
+
+    // Seeking back parses arrays from the beginning.
+    std::vector<knp::core::messaging::SpikeMessage> range_messages;
+    std::copy_if(
+        messages_.begin(), messages_.end(), std::back_inserter(range_messages),
+        [](const auto &message) { return message.header_.send_time_ >= 50 && message.header_.send_time_ < 100; });
+    ASSERT_EQ(range_messages, reader.read_steps(50, 100));
+    ASSERT_EQ(range_messages, reader.read_steps(50, 100));
+}
+
+
+TEST_F(SaveLoadDataSuite, JsonStreamingRemovesTemporaryFile)
+{
+    // Output path is a directory, so the writer constructor throws after the temporary file is created.
+    file_path_ = "json_directory";
+    std::filesystem::create_directory(file_path_);
+    const auto timestamps_path = std::filesystem::path(file_path_).concat(".timestamps");
+
+    ASSERT_THROW(knp::framework::io::storage::native::JsonSpikeMessageWriter writer(file_path_), std::runtime_error);
+    ASSERT_FALSE(std::filesystem::exists(timestamps_path));
+}
+
+
+TEST_F(SaveLoadDataSuite, RasterTest)
+{
+    file_path_ = "data.raster";
+    {
+        knp::framework::io::storage::native::RasterSpikeMessageWriter writer(file_path_);
+        writer.write(messages_.begin(), messages_.end());
+    }
+
+    knp::framework::io::storage::native::RasterSpikeMessageReader reader(file_path_, uid_);
+    const std::vector<knp::core::messaging::SpikeMessage> loaded_messages(reader.begin(), reader.end());
+    ASSERT_EQ(messages_, loaded_messages);
+
+    const knp::framework::io::storage::native::SpikeRaster raster(file_path_);
+    ASSERT_EQ(raster.get_steps_count(), messages_.back().header_.send_time_ + 1);
+    for (const auto &message : messages_)
+        ASSERT_EQ(raster.get_spikes(message.header_.send_time_), message.neuron_indexes_);
+    ASSERT_TRUE(raster.get_spikes(raster.get_steps_count()).empty());
+}
+
+
+TEST_F(SaveLoadDataSuite, RasterLateStartTest)
+{
+    file_path_ = "data.raster";
+    constexpr knp::core::Step first_step = 1'000'000'000;
+    {
+        knp::framework::io::storage::native::RasterSpikeMessageWriter writer(file_path_);
+        writer.write(knp::core::messaging::SpikeMessage{{uid_, first_step}, {1, 2}});
+        writer.write(knp::core::messaging::SpikeMessage{{uid_, first_step + 2}, {3}});
+    }
+    // Steps before the first written step take no space.
+    ASSERT_LT(std::filesystem::file_size(file_path_), 128);
+
+    {
+        const knp::framework::io::storage::native::SpikeRaster raster(file_path_);
+        ASSERT_EQ(raster.get_first_step(), first_step);
+        ASSERT_EQ(raster.get_steps_count(), first_step + 3);
+        ASSERT_TRUE(raster.get_spikes(0).empty());
+        ASSERT_TRUE(raster.get_spikes(first_step + 1).empty());
+        ASSERT_EQ(raster.get_spikes(first_step + 2), knp::core::messaging::SpikeData{3});
+
+        knp::framework::io::storage::native::RasterSpikeMessageReader reader(file_path_, uid_);
+        ASSERT_EQ(reader.read().value().header_.send_time_, first_step);
+    }
+
+    // Step count that overflows the offset table size is rejected.
+    {
+        std::fstream file(file_path_, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(16);
+        const uint64_t steps_count = std::numeric_limits<uint64_t>::max();
+        file.write(reinterpret_cast<const char *>(&steps_count), sizeof(steps_count));
+    }
+    ASSERT_THROW(knp::framework::io::storage::native::SpikeRaster{file_path_}, std::runtime_error);
+}
+
+
+TEST_F(SaveLoadDataSuite, Hdf5StreamingWrongOrder)
+{
+    file_path_ = "data.h5";
+    knp::framework::io::storage::native::H5SpikeMessageWriter writer(file_path_);
+    writer.write(knp::core::messaging::SpikeMessage{{uid_, 2}, {1}});
+    ASSERT_THROW(writer.write(knp::core::messaging::SpikeMessage{{uid_, 1}, {1}}), std::invalid_argument);
+}
+
+
+TEST(StreamingDataSuite, DISABLED_Hdf5Benchmark)
+{
+    constexpr size_t steps_count = 1000000;
+    constexpr size_t neurons_count = 1000;
+    const std::filesystem::path file_path = "benchmark.h5";
+    const knp::core::UID uid;
+
+    // Messages are generated on the fly, so only the writer and the reader buffers take memory.
+    std::mt19937 engine(0);  // NOLINT (We want this test to be predictable)
+    std::uniform_int_distribution<knp::core::messaging::SpikeIndex> distribution(0, neurons_count - 1);
+    size_t spikes_count = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        knp::framework::io::storage::native::H5SpikeMessageWriter writer(file_path);
+        for (size_t step = 0; step < steps_count; ++step)
+        {
+            knp::core::messaging::SpikeMessage message{{uid, step}, {}};
+            for (size_t i = 0; i < 10; ++i) message.neuron_indexes_.push_back(distribution(engine));
+            spikes_count += message.neuron_indexes_.size();
+            writer.write(message);
+        }
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    std::cout << "Write: " << spikes_count / duration.count() << " spikes/s." << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    size_t read_spikes_count = 0;
+    knp::framework::io::storage::native::H5SpikeMessageReader reader(file_path, uid);
+    for (const auto &message : reader) read_spikes_count += message.neuron_indexes_.size();
+    duration = std::chrono::steady_clock::now() - start;
+    std::cout << "Read: " << read_spikes_count / duration.count() << " spikes/s." << std::endl;
+
+    std::filesystem::remove(file_path);
+    ASSERT_EQ(spikes_count, read_spikes_count);
+}
+
+
+TEST(StreamingDataSuite, DISABLED_JsonBenchmark)
+{
+    // About 1 GB of JSON text.
+    constexpr size_t steps_count = 5000000;
+    constexpr size_t neurons_count = 100000;
+    const std::filesystem::path file_path = "benchmark.json";
+    const knp::core::UID uid;
+
+    // Messages are generated on the fly, so only the writer and the reader buffers take memory.
+    std::mt19937 engine(0);  // NOLINT (We want this test to be predictable)
+    std::uniform_int_distribution<knp::core::messaging::SpikeIndex> distribution(0, neurons_count - 1);
+    size_t spikes_count = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        knp::framework::io::storage::native::JsonSpikeMessageWriter writer(file_path);
+        for (size_t step = 0; step < steps_count; ++step)
+        {
+            knp::core::messaging::SpikeMessage message{{uid, step}, {}};
+            for (size_t i = 0; i < 10; ++i) message.neuron_indexes_.push_back(distribution(engine));
+            spikes_count += message.neuron_indexes_.size();
+            writer.write(message);
+        }
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    std::cout << "Write: " << spikes_count / duration.count() << " spikes/s." << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    size_t read_spikes_count = 0;
+    knp::framework::io::storage::native::JsonSpikeMessageReader reader(file_path, uid);
+    for (const auto &message : reader) read_spikes_count += message.neuron_indexes_.size();
+    duration = std::chrono::steady_clock::now() - start;
+    std::cout << "Read: " << read_spikes_count / duration.count() << " spikes/s." << std::endl;
+
+    std::filesystem::remove(file_path);
+    ASSERT_EQ(spikes_count, read_spikes_count);
+}
+
+
 class WrongMagicNumberJsonSuite : public ::testing::Test
 {
 protected:
@@ -22,12 +22,17 @@
 #include <knp/core/message_bus.h>
 #include <knp/core/messaging/messaging.h>
 #include <knp/framework/io/in_converters/index_converter.h>
+#include <knp/framework/io/in_converters/prefetching_generator.h>
+#include <knp/framework/io/in_converters/raster_converter.h>
 #include <knp/framework/io/in_converters/sequence_converter.h>
 #include <knp/framework/io/input_channel.h>
 #include <knp/framework/io/input_interpreters.h>
 
 #include <tests_common.h>
 
+#include <chrono>
+#include <thread>
+
 
 TEST(InputSuite, SequenceConverterTest)
 {
@@ -61,6 +66,77 @@ TEST(InputSuite, IndexConverterTest)
 }
 
 
+TEST(InputSuite, RasterConverterTest)
+{
+    const std::filesystem::path raster_path = "input.raster";
+    {
+        knp::framework::io::storage::native::RasterSpikeMessageWriter writer(raster_path);
+        writer.write(knp::core::messaging::SpikeMessage{{knp::core::UID(), 0}, {1, 3}});
+        writer.write(knp::core::messaging::SpikeMessage{{knp::core::UID(), 2}, {2}});
+    }
+
+    // Raster starts at step 10 and is replayed again after its 3 steps.
+    const knp::framework::io::input::RasterConverter converter(raster_path, 10, true);
+    knp::framework::io::input::DataGenerator generator = converter;
+    ASSERT_TRUE(generator(5).empty());
+    ASSERT_EQ(generator(10), (knp::core::messaging::SpikeData{1, 3}));
+    ASSERT_TRUE(generator(11).empty());
+    ASSERT_EQ(generator(12), knp::core::messaging::SpikeData{2});
+    ASSERT_EQ(generator(13), (knp::core::messaging::SpikeData{1, 3}));
+
+    std::filesystem::remove(raster_path);
+}
+
+
+TEST(InputSuite, PrefetchingGeneratorTest)
+{
+    // Generator that returns the step and the number of calls, so that the result depends on the call order.
+    knp::core::messaging::SpikeIndex calls_count = 0;
+    knp::framework::io::input::PrefetchingGenerator generator(
+        [&calls_count](knp::core::Step step)
+        {
+            if (step == 50) throw std::runtime_error("Generator error.");
+            return knp::core::messaging::SpikeData{static_cast<knp::core::messaging::SpikeIndex>(step), ++calls_count};
+        },
+        4);
+
+    for (knp::core::Step step = 0; step < 20; ++step)
+    {
+        const knp::core::messaging::SpikeData expected{static_cast<uint32_t>(step), static_cast<uint32_t>(step + 1)};
+        ASSERT_EQ(generator(step), expected);
+    }
+
+    // Prefetching restarts from a previous step and calls the generator for consecutive steps.
+    const auto restarted = generator(10);
+    ASSERT_EQ(restarted[0], 10);
+    const auto next = generator(11);
+    ASSERT_EQ(next[0], 11);
+    ASSERT_EQ(next[1], restarted[1] + 1);
+
+    // Generator error is rethrown for its step.
+    for (knp::core::Step step = 12; step < 50; ++step) generator(step);
+    ASSERT_THROW(generator(50), std::runtime_error);
+    ASSERT_EQ(generator(51)[0], 51);
+}
+
+
+TEST(InputSuite, PrefetchingGeneratorStallTest)
+{
+    knp::framework::io::input::PrefetchingGenerator generator(
+        [](knp::core::Step step)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            return knp::core::messaging::SpikeData{static_cast<knp::core::messaging::SpikeIndex>(step)};
+        });
+
+    for (knp::core::Step step = 0; step < 10; ++step)
+    {
+        ASSERT_EQ(generator(step), knp::core::messaging::SpikeData{static_cast<uint32_t>(step)});
+    }
+    ASSERT_GT(generator.get_stalls_count(), 0);
+}
+
+
 TEST(InputSuite, ChannelTest)
 {
     std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_bus();
@@ -30,6 +30,8 @@
 
 #include <tests_common.h>
 
+#include <random>
+
 
 TEST(MessageHandlerSuite, KWTA)
 {
@@ -51,6 +53,37 @@ TEST(MessageHandlerSuite, KWTA)
 }
 
 
+TEST(MessageHandlerSuite, KWTAKeyedByUID)
+{
+    constexpr int seed = 42;
+    const knp::core::UID handler_uid;
+    knp::framework::modifier::KWtaRandomHandler handler(2, seed, handler_uid);
+    knp::framework::modifier::KWtaRandomHandler same_handler(2, seed, handler_uid);
+    knp::framework::modifier::KWtaRandomHandler other_handler(2, seed, knp::core::UID{});
+
+    // Handlers with the same seed and UID select the same spikes, a handler with another UID selects different ones.
+    bool is_different = false;
+    for (knp::core::Step step = 0; step < 64; ++step)
+    {
+        // Handlers reorder spikes of the message, so each handler gets its own copy.
+        const std::vector<knp::core::messaging::SpikeMessage> messages{
+            {{knp::core::UID{}, step}, {0, 1, 2, 3, 4, 5, 6, 7}}};
+        auto messages_copy = messages;
+        const auto out_data = handler(messages_copy);
+        messages_copy = messages;
+        ASSERT_EQ(out_data, same_handler(messages_copy));
+        messages_copy = messages;
+        is_different = is_different || out_data != other_handler(messages_copy);
+    }
+    ASSERT_TRUE(is_different);
+
+    // Selection is computed without standard distributions, so it doesn't depend on the standard library.
+    std::vector<knp::core::messaging::SpikeMessage> messages{{{knp::core::UID{}, 5}, {0, 1, 2, 3, 4, 5, 6, 7}}};
+    ASSERT_EQ(
+        knp::framework::modifier::KWtaRandomHandler(3, seed)(messages), (knp::core::messaging::SpikeData{0, 1, 3}));
+}
+
+
 TEST(MessageHandlerSuite, GroupWTASingle)
 {
     std::random_device rd;
@@ -196,7 +229,8 @@ TEST(MessageHandlerSuite, NetworkIntegrationTest)
     constexpr int num_steps = 20;
     model_executor.start([num_steps](size_t step) { return step < num_steps; });
 
-    const auto &spikes = out_channel.update();
+    out_channel.update();
+    const auto spikes = out_channel.read_some_from_buffer(0, num_steps);
 
     ASSERT_GE(spikes.size(), 10);
     for (const auto &msg : spikes)
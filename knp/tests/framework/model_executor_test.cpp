@@ -79,7 +79,8 @@ TEST(FrameworkSuite, ModelExecutorLoad)
     model_executor.start([](size_t step) { return step < 20; });
 
     std::vector<knp::core::Step> results;
-    const auto &spikes = out_channel.update();
+    out_channel.update();
+    const auto spikes = out_channel.read_some_from_buffer(0, model_executor.get_backend()->get_step());
     results.reserve(spikes.size());
 
     std::transform(
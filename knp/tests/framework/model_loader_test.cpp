@@ -71,3 +71,27 @@ TEST(FrameworkSuite, ModelWithIncorrectInputChannel)
 
     EXPECT_THROW(mld.load(model), std::logic_error);  //!OCLINT(False positive)
 }
+
+
+TEST(FrameworkSuite, ModelOutputChannelRetention)
+{
+    namespace kt = knp::testing;
+
+    const knp::core::UID o_channel_uid;
+
+    knp::framework::Model model(std::move(knp::framework::Network()));
+
+    kt::BLIFATPopulation population{kt::neuron_generator, 1};
+    model.get_network().add_population(population);
+    model.add_output_channel(o_channel_uid, population.get_uid());
+    ASSERT_EQ(
+        model.get_output_channel_retention(o_channel_uid),
+        knp::framework::io::output::OutputChannel::unlimited_retention);
+    model.set_output_channel_retention(o_channel_uid, 8);
+
+    knp::framework::BackendLoader backend_loader;
+    knp::framework::ModelLoader mld(backend_loader.load(knp::testing::get_backend_path()), {});
+    mld.load(model);
+
+    ASSERT_EQ(mld.get_output_channel(o_channel_uid).get_retention_steps(), 8);
+}
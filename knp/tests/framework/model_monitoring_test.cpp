@@ -19,12 +19,30 @@
  * limitations under the License.
  */
 
+#include <knp/framework/io/storage/native/data_storage_raster.h>
 #include <knp/framework/model_executor.h>
 #include <knp/framework/monitoring/model.h>
 
+#ifdef __clang__
+#    pragma clang diagnostic push
+#    pragma clang diagnostic ignored "-Wdocumentation"
+#endif
+#include <highfive/highfive.hpp>
+#ifdef __clang__
+#    pragma clang diagnostic pop
+#endif
+
 #include <generators.h>
 #include <tests_common.h>
 
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
 
 TEST(ModelMonitoring, AggregatedSpikesLogger)
 {
@@ -76,9 +94,15 @@ TEST(ModelMonitoring, AggregatedSpikesLogger)
 
     knp::framework::monitoring::model::add_aggregated_spikes_logger(
         model, {{i_channel_uid, "INPUT"}}, model_executor, spike_accumulator, projection_weights_stream, 1);
+    // Asynchronous logger writes the same log in a background thread.
+    std::map<std::string, size_t> async_spike_accumulator;
+    std::ostringstream async_stream;
+    knp::framework::monitoring::model::add_aggregated_spikes_logger(
+        model, {{i_channel_uid, "INPUT"}}, model_executor, async_spike_accumulator, async_stream, 1, 1);
     model_executor.start([](size_t step) -> bool { return step < 3; });
 
     ASSERT_EQ(projection_weights_stream.str(), "Index, INPUT\n1, 0\n2, 1\n3, 0\n");
+    ASSERT_EQ(async_stream.str(), projection_weights_stream.str());
 }
 
 
@@ -129,6 +153,154 @@ TEST(ModelMonitoring, ProjectionWeightsLogger)
 }
 
 
+TEST(ModelMonitoring, ProjectionWeightsWriter)
+{
+    knp::testing::BLIFATPopulation population{knp::testing::neuron_generator, 1};
+
+    knp::testing::ResourceSynapseParams default_synapse;
+
+    knp::testing::ResourceDeltaProjection input_projection{
+        knp::core::UID{false}, population.get_uid(),
+        [&](size_t) {
+            return knp::testing::ResourceSynapseData{default_synapse, 0, 0};
+        },
+        1};
+
+    knp::framework::Network network;
+
+    const knp::core::UID input_projection_uid = input_projection.get_uid();
+    const knp::core::UID population_uid = population.get_uid();
+
+    network.add_population(std::move(population));
+    network.add_projection<knp::testing::ResourceDeltaProjection>(std::move(input_projection));
+
+    const knp::core::UID i_channel_uid, o_channel_uid;
+
+    knp::framework::Model model(std::move(network));
+    model.add_input_channel(i_channel_uid, input_projection_uid);
+    model.add_output_channel(o_channel_uid, population_uid);
+
+    knp::framework::BackendLoader backend_loader;
+    knp::framework::ModelExecutor model_executor(
+        model, backend_loader.load(knp::testing::get_backend_path()),
+        {{i_channel_uid,
+          [](knp::core::Step step) -> knp::core::messaging::SpikeData
+          {
+              knp::core::messaging::SpikeData spike_data;
+              spike_data.push_back(0);
+              return spike_data;
+          }}});
+
+    const std::filesystem::path weights_path = "weights.raw", async_weights_path = "async_weights.raw";
+    knp::framework::monitoring::model::add_projection_weights_writer(
+        weights_path, model_executor, input_projection.get_uid(), 1);
+    knp::framework::monitoring::model::add_projection_weights_writer(
+        async_weights_path, model_executor, input_projection.get_uid(), 1,
+        knp::framework::monitoring::model::WeightsFileFormat::raw, 0, 1);
+    model_executor.start([](size_t step) -> bool { return step < 2; });
+
+    auto read_file = [](const std::filesystem::path &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        const std::vector<char> content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        file.close();
+        std::filesystem::remove(path);
+        return content;
+    };
+    const auto content = read_file(weights_path);
+    // Asynchronous writer writes the same file in a background thread.
+    ASSERT_EQ(read_file(async_weights_path), content);
+
+    // Header, synapse table and two padded records of a single synapse.
+    ASSERT_EQ(content.size(), 16 + 8 + 2 * 24);
+    auto read_value = [&content](size_t offset, auto value)
+    {
+        std::memcpy(&value, content.data() + offset, sizeof(value));
+        return value;
+    };
+    ASSERT_EQ(read_value(0, uint32_t{}), 2682);
+    ASSERT_EQ(read_value(8, uint64_t{}), 1);
+    ASSERT_EQ(read_value(24, uint64_t{}), 1);
+    ASSERT_EQ(read_value(32, uint64_t{}), 0);
+    ASSERT_EQ(read_value(48, uint64_t{}), 2);
+    ASSERT_EQ(read_value(56, uint64_t{}), 1);
+    ASSERT_EQ(read_value(64, float{}), 0.F);
+}
+
+
+TEST(ModelMonitoring, ProjectionWeightsH5Writer)
+{
+    knp::testing::BLIFATPopulation population{knp::testing::neuron_generator, 1};
+
+    knp::testing::ResourceSynapseParams default_synapse;
+
+    knp::testing::ResourceDeltaProjection input_projection{
+        knp::core::UID{false}, population.get_uid(),
+        [&](size_t) {
+            return knp::testing::ResourceSynapseData{default_synapse, 0, 0};
+        },
+        1};
+
+    knp::framework::Network network;
+
+    const knp::core::UID input_projection_uid = input_projection.get_uid();
+    const knp::core::UID population_uid = population.get_uid();
+
+    network.add_population(std::move(population));
+    network.add_projection<knp::testing::ResourceDeltaProjection>(std::move(input_projection));
+
+    const knp::core::UID i_channel_uid, o_channel_uid;
+
+    knp::framework::Model model(std::move(network));
+    model.add_input_channel(i_channel_uid, input_projection_uid);
+    model.add_output_channel(o_channel_uid, population_uid);
+
+    knp::framework::BackendLoader backend_loader;
+    knp::framework::ModelExecutor model_executor(
+        model, backend_loader.load(knp::testing::get_backend_path()),
+        {{i_channel_uid,
+          [](knp::core::Step step) -> knp::core::messaging::SpikeData
+          {
+              knp::core::messaging::SpikeData spike_data;
+              spike_data.push_back(0);
+              return spike_data;
+          }}});
+
+    const std::filesystem::path weights_path = "weights.h5";
+    knp::framework::monitoring::model::add_projection_weights_writer(
+        weights_path, model_executor, input_projection.get_uid(), 1,
+        knp::framework::monitoring::model::WeightsFileFormat::hdf5, 6);
+    model_executor.start([](size_t step) -> bool { return step < 2; });
+
+    {
+        const HighFive::File weights_file(weights_path.string(), HighFive::File::ReadOnly);
+        const auto group = weights_file.getGroup("weights");
+        ASSERT_EQ(group.getDataSet("target_ids").read<std::vector<int64_t>>(), std::vector<int64_t>{0});
+        ASSERT_EQ(group.getDataSet("source_ids").read<std::vector<int64_t>>(), std::vector<int64_t>{0});
+        ASSERT_EQ(group.getDataSet("steps").read<std::vector<int64_t>>(), (std::vector<int64_t>{1, 2}));
+
+        // Records are compressed, and a chunk contains several records.
+        const auto values = group.getDataSet("values");
+        ASSERT_EQ(H5Pget_nfilters(values.getCreatePropertyList().getId()), 1);
+        std::array<hsize_t, 2> chunk_dims{};
+        ASSERT_EQ(H5Pget_chunk(values.getCreatePropertyList().getId(), 2, chunk_dims.data()), 2);
+        ASSERT_GT(chunk_dims[0], 1);
+        ASSERT_EQ(values.read<std::vector<std::vector<float>>>(), (std::vector<std::vector<float>>{{0.F}, {0.F}}));
+        ASSERT_EQ(
+            group.getDataSet("last_update_steps").read<std::vector<std::vector<int64_t>>>(),
+            (std::vector<std::vector<int64_t>>{{0}, {1}}));
+    }
+    std::filesystem::remove(weights_path);
+
+    // Compression is supported only by HDF5.
+    ASSERT_THROW(
+        knp::framework::monitoring::model::add_projection_weights_writer(
+            "weights.raw", model_executor, input_projection_uid, 1,
+            knp::framework::monitoring::model::WeightsFileFormat::raw, 6),
+        std::invalid_argument);
+}
+
+
 TEST(ModelMonitoring, SpikesLogger)
 {
     knp::testing::BLIFATPopulation population{knp::testing::neuron_generator, 1};
@@ -182,3 +354,119 @@ TEST(ModelMonitoring, SpikesLogger)
 
     ASSERT_EQ(projection_weights_stream.str(), "Step: 0\nSender: INPUT\n0 \nStep: 2\nSender: INPUT\n0 \n");
 }
+
+
+TEST(ModelMonitoring, SpikesWriter)
+{
+    knp::testing::BLIFATPopulation population{knp::testing::neuron_generator, 1};
+
+    {  //stop spikes from happening
+        auto params = population.get_neurons_parameters();
+        for (auto& param : params)
+        {
+            param.activation_threshold_ = std::numeric_limits<double>::max();
+        }
+        population.set_neurons_parameters(params);
+    }
+
+    knp::testing::DeltaProjection input_projection = knp::testing::DeltaProjection{
+        knp::core::UID{false}, population.get_uid(), knp::testing::input_projection_gen, 1};
+
+    knp::framework::Network network;
+
+    const knp::core::UID input_projection_uid = input_projection.get_uid();
+    const knp::core::UID population_uid = population.get_uid();
+
+    network.add_population(std::move(population));
+    network.add_projection<knp::testing::DeltaProjection>(std::move(input_projection));
+
+    const knp::core::UID i_channel_uid, o_channel_uid;
+
+    knp::framework::Model model(std::move(network));
+    model.add_input_channel(i_channel_uid, input_projection_uid);
+    model.add_output_channel(o_channel_uid, population_uid);
+
+    knp::framework::BackendLoader backend_loader;
+    knp::framework::ModelExecutor model_executor(
+        model, backend_loader.load(knp::testing::get_backend_path()),
+        {{i_channel_uid,
+          [](knp::core::Step step) -> knp::core::messaging::SpikeData
+          {
+              if (step % 2 == 0)
+              {
+                  knp::core::messaging::SpikeData spike_data;
+                  spike_data.push_back(0);
+                  return spike_data;
+              }
+              return {};
+          }}});
+
+    const std::filesystem::path raster_path = "monitoring.raster";
+    auto writer = std::make_shared<knp::framework::io::storage::native::RasterSpikeMessageWriter>(raster_path);
+    knp::framework::monitoring::model::add_spikes_writer(model_executor, {i_channel_uid}, writer);
+    model_executor.start([](size_t step) -> bool { return step < 3; });
+    writer->close();
+
+    const knp::framework::io::storage::native::SpikeRaster raster(raster_path);
+    ASSERT_EQ(raster.get_steps_count(), 3);
+    ASSERT_EQ(raster.get_spikes(0), knp::core::messaging::SpikeData{0});
+    ASSERT_TRUE(raster.get_spikes(1).empty());
+    ASSERT_EQ(raster.get_spikes(2), knp::core::messaging::SpikeData{0});
+    std::filesystem::remove(raster_path);
+}
+
+
+TEST(ModelMonitoring, AsyncSpikesLogger)
+{
+    knp::testing::BLIFATPopulation population{knp::testing::neuron_generator, 1};
+
+    {  //stop spikes from happening
+        auto params = population.get_neurons_parameters();
+        for (auto& param : params)
+        {
+            param.activation_threshold_ = std::numeric_limits<double>::max();
+        }
+        population.set_neurons_parameters(params);
+    }
+
+    knp::testing::DeltaProjection input_projection = knp::testing::DeltaProjection{
+        knp::core::UID{false}, population.get_uid(), knp::testing::input_projection_gen, 1};
+
+    knp::framework::Network network;
+
+    const knp::core::UID input_projection_uid = input_projection.get_uid();
+    const knp::core::UID population_uid = population.get_uid();
+
+    network.add_population(std::move(population));
+    network.add_projection<knp::testing::DeltaProjection>(std::move(input_projection));
+
+    const knp::core::UID i_channel_uid, o_channel_uid;
+
+    knp::framework::Model model(std::move(network));
+    model.add_input_channel(i_channel_uid, input_projection_uid);
+    model.add_output_channel(o_channel_uid, population_uid);
+
+    knp::framework::BackendLoader backend_loader;
+    knp::framework::ModelExecutor model_executor(
+        model, backend_loader.load(knp::testing::get_backend_path()),
+        {{i_channel_uid,
+          [](knp::core::Step step) -> knp::core::messaging::SpikeData
+          {
+              if (step % 2 == 0)
+              {
+                  knp::core::messaging::SpikeData spike_data;
+                  spike_data.push_back(0);
+                  return spike_data;
+              }
+              return {};
+          }}});
+
+    std::ostringstream projection_weights_stream;
+
+    knp::framework::monitoring::model::add_spikes_logger(
+        model_executor, {{i_channel_uid, "INPUT"}}, projection_weights_stream, 1);
+    model_executor.start([](size_t step) -> bool { return step < 3; });
+
+    // Spikes are written in a background thread and flushed before execution stops.
+    ASSERT_EQ(projection_weights_stream.str(), "Step: 0\nSender: INPUT\n0 \nStep: 2\nSender: INPUT\n0 \n");
+}
@@ -24,9 +24,11 @@
 #include <knp/framework/io/out_converters/convert_count.h>
 #include <knp/framework/io/out_converters/convert_set.h>
 #include <knp/framework/io/output_channel.h>
+#include <knp/framework/io/storage/native/data_storage_raster.h>
 
 #include <tests_common.h>
 
+#include <filesystem>
 #include <set>
 #include <vector>
 
@@ -123,3 +125,105 @@ TEST(OutputSuite, ChannelTest)
     ASSERT_EQ(set_result, expected_set);
     ASSERT_EQ(index, expected_index);
 }
+
+
+TEST(OutputSuite, ChannelRetentionTest)
+{
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_bus();
+    auto endpoint = bus->create_endpoint();
+    knp::core::UID sender_uid;
+
+    auto channel_endpoint = bus->create_endpoint();
+    knp::core::UID channel_uid;
+    channel_endpoint.subscribe<knp::core::messaging::SpikeMessage>(channel_uid, {sender_uid});
+    // Channel keeps messages of the last 4 steps.
+    knp::framework::io::output::OutputChannel channel{channel_uid, std::move(channel_endpoint), 4};
+
+    for (knp::core::Step step = 0; step < 10; ++step)
+    {
+        const auto index = static_cast<knp::core::messaging::SpikeIndex>(step);
+        endpoint.send_message(knp::core::messaging::SpikeMessage{{sender_uid, step}, {index}});
+        bus->route_messages();
+        ASSERT_EQ(channel.update(), 1);
+    }
+
+    ASSERT_TRUE(channel.get_step_messages(5).empty());
+    ASSERT_EQ(channel.get_step_messages(6).size(), 1);
+    ASSERT_EQ(channel.get_step_messages(9).front().neuron_indexes_, knp::core::messaging::SpikeData{9});
+
+    const auto window = channel.get_messages(0, 7);
+    ASSERT_EQ(window.size(), 2);
+    ASSERT_EQ(window[0].get().header_.send_time_, 6);
+    ASSERT_EQ(window[1].get().header_.send_time_, 7);
+
+    // Reading removes messages from the buffer.
+    ASSERT_EQ(channel.read_some_from_buffer(7, 8).size(), 2);
+    ASSERT_EQ(channel.get_messages(0, 100).size(), 2);
+
+    // Narrowing the window drops older buffered steps at once.
+    channel.set_retention_steps(1);
+    ASSERT_EQ(channel.get_retention_steps(), 1);
+    ASSERT_TRUE(channel.get_step_messages(6).empty());
+    ASSERT_EQ(channel.get_messages(0, 100).size(), 1);
+}
+
+
+TEST(OutputSuite, ChannelSparseStepsTest)
+{
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_bus();
+    auto endpoint = bus->create_endpoint();
+    knp::core::UID sender_uid;
+
+    auto channel_endpoint = bus->create_endpoint();
+    knp::core::UID channel_uid;
+    channel_endpoint.subscribe<knp::core::messaging::SpikeMessage>(channel_uid, {sender_uid});
+    knp::framework::io::output::OutputChannel channel{channel_uid, std::move(channel_endpoint)};
+
+    // Only steps with messages are stored, so distant steps don't need memory for the steps between them.
+    constexpr knp::core::Step first_step = 1'000'000'000;
+    endpoint.send_message(knp::core::messaging::SpikeMessage{{sender_uid, first_step}, {1}});
+    endpoint.send_message(knp::core::messaging::SpikeMessage{{sender_uid, 2 * first_step}, {2}});
+    endpoint.send_message(knp::core::messaging::SpikeMessage{{sender_uid, first_step + 1}, {3}});
+    bus->route_messages();
+    ASSERT_EQ(channel.update(), 3);
+
+    ASSERT_EQ(channel.get_step_messages(first_step).front().neuron_indexes_, knp::core::messaging::SpikeData{1});
+    ASSERT_TRUE(channel.get_step_messages(first_step + 2).empty());
+
+    const auto messages = channel.get_messages(0, 2 * first_step);
+    ASSERT_EQ(messages.size(), 3);
+    ASSERT_EQ(messages[1].get().header_.send_time_, first_step + 1);
+    ASSERT_EQ(messages[2].get().header_.send_time_, 2 * first_step);
+
+    ASSERT_EQ(channel.read_some_from_buffer(first_step, first_step + 1).size(), 2);
+    ASSERT_EQ(channel.get_messages(0, 2 * first_step).size(), 1);
+}
+
+TEST(OutputSuite, ChannelWriteTest)
+{
+    std::shared_ptr<knp::core::MessageBus> bus = knp::core::MessageBus::construct_bus();
+    auto endpoint = bus->create_endpoint();
+    knp::core::UID sender_uid;
+
+    auto channel_endpoint = bus->create_endpoint();
+    knp::core::UID channel_uid;
+    channel_endpoint.subscribe<knp::core::messaging::SpikeMessage>(channel_uid, {sender_uid});
+    knp::framework::io::output::OutputChannel channel{channel_uid, std::move(channel_endpoint)};
+
+    endpoint.send_message(knp::core::messaging::SpikeMessage{{sender_uid, 1}, {1, 3}});
+    endpoint.send_message(knp::core::messaging::SpikeMessage{{sender_uid, 4}, {2}});
+    bus->route_messages();
+
+    const std::filesystem::path raster_path = "output.raster";
+    {
+        knp::framework::io::storage::native::RasterSpikeMessageWriter writer(raster_path);
+        ASSERT_EQ(knp::framework::io::output::output_channel_write(channel, writer, 0, 2), 1);
+        ASSERT_EQ(knp::framework::io::output::output_channel_write(channel, writer, 3, 5), 1);
+    }
+
+    const knp::framework::io::storage::native::SpikeRaster raster(raster_path);
+    ASSERT_EQ(raster.get_steps_count(), 5);
+    ASSERT_EQ(raster.get_spikes(1), (knp::core::messaging::SpikeData{1, 3}));
+    ASSERT_EQ(raster.get_spikes(4), knp::core::messaging::SpikeData{2});
+    std::filesystem::remove(raster_path);
+}
@@ -47,6 +47,20 @@ TEST(PopulationGenerators, CreatorRandom)
     auto new_pop{knp::framework::population::creators::make_random<knp::neuron_traits::BLIFATNeuron>(neurons_count)};
 
     ASSERT_EQ(new_pop.size(), neurons_count);
+
+    // Populations with the same seed and UID get the same parameters.
+    const knp::core::UID uid;
+    const auto population{
+        knp::framework::population::creators::make_random<knp::neuron_traits::BLIFATNeuron>(neurons_count, 42, uid)};
+    const auto same_population{
+        knp::framework::population::creators::make_random<knp::neuron_traits::BLIFATNeuron>(neurons_count, 42, uid)};
+    ASSERT_EQ(population.get_uid(), uid);
+    for (size_t i = 0; i < neurons_count; ++i)
+    {
+        ASSERT_EQ(population[i].n_time_steps_since_last_firing_, same_population[i].n_time_steps_since_last_firing_);
+        ASSERT_EQ(population[i].absolute_refractory_period_, same_population[i].absolute_refractory_period_);
+    }
+    ASSERT_NE(population[0].n_time_steps_since_last_firing_, population[1].n_time_steps_since_last_firing_);
 }
 
 
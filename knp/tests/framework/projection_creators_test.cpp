@@ -182,6 +182,44 @@ TEST(ProjectionConnectors, FixedProbability)
 }
 
 
+TEST(ProjectionConnectors, FixedProbabilityReproducible)
+{
+    constexpr uint64_t seed = 42;
+    const knp::core::UID proj_uid;
+    auto create_projection = [](const knp::core::UID &uid)
+    {
+        return knp::framework::projection::creators::fixed_probability<typename knp::synapse_traits::DeltaSynapse>(
+            knp::core::UID(), knp::core::UID(), 30, 50, 0.5,
+            knp::framework::projection::parameters_generators::default_synapse_gen_2param<
+                knp::synapse_traits::DeltaSynapse>,
+            seed, uid);
+    };
+    auto proj1 = create_projection(proj_uid);
+    auto proj2 = create_projection(proj_uid);
+
+    ASSERT_EQ(proj1.get_uid(), proj_uid);
+    ASSERT_EQ(proj1.size(), proj2.size());
+    for (size_t i = 0; i < proj1.size(); ++i)
+    {
+        ASSERT_EQ(std::get<knp::core::source_neuron_id>(proj1[i]), std::get<knp::core::source_neuron_id>(proj2[i]));
+        ASSERT_EQ(std::get<knp::core::target_neuron_id>(proj1[i]), std::get<knp::core::target_neuron_id>(proj2[i]));
+    }
+
+    // Projections with the same seed and different UIDs are connected independently.
+    auto proj3 = create_projection(knp::core::UID());
+    bool is_different = proj1.size() != proj3.size();
+    for (size_t i = 0; !is_different && i < proj1.size(); ++i)
+    {
+        const auto &synapse1 = proj1[i];
+        const auto &synapse3 = proj3[i];
+        is_different =
+            std::get<knp::core::source_neuron_id>(synapse1) != std::get<knp::core::source_neuron_id>(synapse3) ||
+            std::get<knp::core::target_neuron_id>(synapse1) != std::get<knp::core::target_neuron_id>(synapse3);
+    }
+    ASSERT_TRUE(is_different);
+}
+
+
 TEST(ProjectionConnectors, IndexBased)
 {
     constexpr size_t src_pop_size = 5;
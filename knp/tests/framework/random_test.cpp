@@ -0,0 +1,90 @@
+/**
+ * @file random_test.cpp
+ * @brief Tests for counter-based random number generator.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knp/framework/random/philox.h>
+
+#include <tests_common.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+
+TEST(RandomSuite, PhiloxKnownAnswer)
+{
+    using knp::framework::random::Philox4x32;
+
+    // Known answers from the Random123 reference implementation.
+    const Philox4x32::Block zero_result{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+    ASSERT_EQ(Philox4x32::generate({0, 0, 0, 0}, {0, 0}), zero_result);
+
+    const Philox4x32::Block pi_result{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+    ASSERT_EQ(
+        Philox4x32::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}), pi_result);
+}
+
+
+TEST(RandomSuite, OrderIndependence)
+{
+    const knp::core::UID uid;
+    const knp::framework::random::CounterBasedRandom random{123, uid};
+
+    std::vector<uint64_t> forward(100);
+    for (size_t i = 0; i < forward.size(); ++i) forward[i] = random.uniform_uint64(i, 7);
+
+    std::vector<uint64_t> backward(forward.size());
+    for (size_t i = backward.size(); i-- > 0;) backward[i] = random.uniform_uint64(i, 7);
+
+    ASSERT_EQ(forward, backward);
+    // Another generator with the same key gives the same values.
+    ASSERT_EQ(knp::framework::random::CounterBasedRandom(123, uid).uniform_uint64(5, 7), forward[5]);
+    // Step, seed and UID change the values.
+    ASSERT_NE(random.uniform_uint64(5, 8), forward[5]);
+    ASSERT_NE(knp::framework::random::CounterBasedRandom(124, uid).uniform_uint64(5, 7), forward[5]);
+    ASSERT_NE(knp::framework::random::CounterBasedRandom(123).uniform_uint64(5, 7), forward[5]);
+}
+
+
+TEST(RandomSuite, Distributions)
+{
+    const knp::framework::random::CounterBasedRandom random{1};
+    constexpr size_t count = 10000;
+    double sum = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double value = random.uniform_real(i);
+        ASSERT_GE(value, 0.0);
+        ASSERT_LT(value, 1.0);
+        sum += value;
+        ASSERT_LT(random.uniform_int(i, 0, 10), 10);
+    }
+    ASSERT_NEAR(sum / count, 0.5, 0.02);
+
+    std::vector<int> values(20);
+    std::iota(values.begin(), values.end(), 0);
+    auto shuffled1 = values, shuffled2 = values;
+    auto engine1 = random.engine(3), engine2 = random.engine(3);
+    std::shuffle(shuffled1.begin(), shuffled1.end(), engine1);
+    std::shuffle(shuffled2.begin(), shuffled2.end(), engine2);
+    ASSERT_EQ(shuffled1, shuffled2);
+    std::sort(shuffled1.begin(), shuffled1.end());
+    ASSERT_EQ(shuffled1, values);
+}
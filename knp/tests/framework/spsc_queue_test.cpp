@@ -0,0 +1,71 @@
+/**
+ * @file spsc_queue_test.cpp
+ * @brief Single-producer single-consumer queue test.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2026 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knp/framework/spsc_queue.h>
+
+#include <tests_common.h>
+
+#include <atomic>
+#include <thread>
+
+
+TEST(SpscQueueSuite, PushPopTest)
+{
+    constexpr size_t values_count = 10000;
+    knp::framework::SpscQueue<size_t> queue(4);
+    std::atomic<bool> is_stopped = false;
+    auto is_cancelled = [&is_stopped] { return is_stopped.load(); };
+
+    std::thread producer(
+        [&queue, &is_cancelled]
+        {
+            for (size_t value = 0; value < values_count; ++value) ASSERT_TRUE(queue.push(size_t{value}, is_cancelled));
+        });
+
+    // The consumer blocks while the queue is empty and gets values in the order they were pushed.
+    for (size_t expected = 0; expected < values_count; ++expected)
+    {
+        size_t value = 0;
+        ASSERT_TRUE(queue.pop(value, is_cancelled));
+        ASSERT_EQ(value, expected);
+    }
+    producer.join();
+
+    // Cancelled waiting returns if the queue is empty.
+    std::thread consumer(
+        [&queue, &is_cancelled]
+        {
+            size_t value = 0;
+            ASSERT_FALSE(queue.pop(value, is_cancelled));
+        });
+    is_stopped = true;
+    queue.notify();
+    consumer.join();
+
+    // Queued values are extracted after cancellation.
+    ASSERT_TRUE(queue.try_push(1));
+    size_t value = 0;
+    ASSERT_TRUE(queue.pop(value, is_cancelled));
+    ASSERT_EQ(value, 1);
+    ASSERT_FALSE(queue.try_pop(value));
+
+    ASSERT_THROW(knp::framework::SpscQueue<size_t>(0), std::invalid_argument);
+}
@@ -101,3 +101,39 @@ TEST(SynchronizationSuite, MultiThreadCpuTest)
     ASSERT_EQ(proj1.size(), 1);
     ASSERT_EQ(pop.size(), 1);
 }
+
+
+TEST(SynchronizationSuite, VisitNetworkDataTest)
+{
+    knp::testing::STestingBack backend;
+    knp::testing::BLIFATPopulation population{knp::testing::neuron_generator, 1};
+    auto loop_projection =
+        knp::testing::DeltaProjection{population.get_uid(), population.get_uid(), knp::testing::synapse_generator, 1};
+
+    backend.load_populations({population});
+    backend.load_projections({loop_projection});
+    backend._init();
+
+    std::vector<const void *> projection_addresses;
+    std::vector<knp::core::UID> projection_uids;
+    backend.for_each_projection(
+        [&projection_addresses, &projection_uids](const auto &projection)
+        {
+            projection_addresses.push_back(&projection);
+            projection_uids.push_back(projection.get_uid());
+            ASSERT_EQ(projection.get_synapses().size(), 1);
+        });
+
+    size_t population_size = 0;
+    backend.for_each_population([&population_size](const auto &pop) { population_size += pop.size(); });
+
+    // Projections are passed by reference, so the same object is visited every time.
+    std::vector<const void *> second_pass_addresses;
+    backend.for_each_projection([&second_pass_addresses](const auto &projection)
+                                { second_pass_addresses.push_back(&projection); });
+
+    ASSERT_EQ(projection_uids.size(), 1);
+    ASSERT_EQ(projection_uids[0], loop_projection.get_uid());
+    ASSERT_EQ(population_size, 1);
+    ASSERT_EQ(projection_addresses, second_pass_addresses);
+}